@@ -36,6 +36,9 @@
 #include "GateOutputMgr.hh"
 #include "GatePrimaryGeneratorAction.hh"
 #include "GateUserActions.hh"
+#ifdef GATE_USE_MT
+#include "GateActionInitialization.hh"
+#endif
 #include "GateDigitizer.hh"
 #include "GateClock.hh"
 #include "GateUIcontrolMessenger.hh"
@@ -291,7 +294,12 @@ int main( int argc, char* argv[] )
   runManager->SetUserInitialization( GatePhysicsList::GetInstance() );
 
   // Set the users actions to handle callback for actors - before the initialisation
+#ifdef GATE_USE_MT
+  // (the worker threads build their own actions and particles generator)
+  runManager->SetUserInitialization( new GateActionInitialization( myRecords ) );
+#else
   new GateUserActions( runManager, myRecords );
+#endif
 
   // Set the Visualization Manager
 #ifdef G4VIS_USE
@@ -305,7 +313,9 @@ int main( int argc, char* argv[] )
   runManager->InitializeAll();
 
   // Incorporate the user actions, set the particles generator
+#ifndef GATE_USE_MT
   runManager->SetUserAction( new GatePrimaryGeneratorAction() );
+#endif
 
   // Create various singleton objets
 #ifdef G4ANALYSIS_USE_GENERAL
@@ -60,6 +60,7 @@ public:
   void RecordStepWithVolume(const GateVVolume*, const G4Step*)
     {
     }
+  G4bool IsRecordingSteps() const { return false; }
   void RecordTracks(GateSteppingAction*)
     {
     }
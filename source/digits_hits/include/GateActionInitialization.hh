@@ -0,0 +1,45 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*
+  \class  GateActionInitialization
+  \brief  Creates the user actions of the master and of each worker
+  thread when GATE is compiled with GATE_USE_MT.
+
+  - The master only owns a GateRunAction: it dispatches the run callbacks
+  to the master actors, which receive the merged worker data at the end
+  of each run, and to the output manager.
+  - Each worker owns a complete set of user actions (run, event, tracking,
+  stepping and primary generator) and a thread local GateActorManager.
+*/
+
+#ifndef GATEACTIONINITIALIZATION_HH
+#define GATEACTIONINITIALIZATION_HH
+
+#include "G4VUserActionInitialization.hh"
+
+class GateRecorderBase;
+
+//-----------------------------------------------------------------------------
+class GateActionInitialization : public G4VUserActionInitialization
+{
+public:
+  GateActionInitialization(GateRecorderBase * r);
+  virtual ~GateActionInitialization();
+
+  virtual void BuildForMaster() const;
+  virtual void Build() const;
+  virtual G4VSteppingVerbose * InitializeSteppingVerbose() const;
+
+protected:
+  GateRecorderBase * pRecorder;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEACTIONINITIALIZATION_HH */
@@ -24,6 +24,7 @@
 #include "G4UserStackingAction.hh"
 
 #include "globals.hh"
+#include <atomic>
 #include "GateUserActions.hh"
 #include "GateTrack.hh"
 
@@ -63,7 +64,7 @@ private:
   GateRecorderBase* recorder;
   G4int runIDcounter;
   G4bool flagBasicOutput;
-  static GateRunAction* prunAction;
+  static G4ThreadLocal GateRunAction* prunAction;
 };
 //-----------------------------------------------------------------------------
 
@@ -93,7 +94,7 @@ private:
   GateUserActions* pCallbackMan;
   GateRecorderBase* recorder;
   G4bool flagBasicOutput;
-  static GateEventAction* peventAction;
+  static G4ThreadLocal GateEventAction* peventAction;
 };
 //-----------------------------------------------------------------------------
 
@@ -141,8 +142,10 @@ public :
 
   void StopOnBoundary(G4int aI);
   void StopAndKill(G4String aString);
-  void SetMode( TrackingMode aMode);
-  TrackingMode GetMode();
+  // The mode is shared by all the threads: the master, which has no stepping
+  // action in MT, reads it through GateSteppingAction::GetMode()
+  static void SetMode( TrackingMode aMode);
+  static TrackingMode GetMode();
   void SetTxtOut(G4String aString);
   G4int GetTxtOn() { return TxtOn;};
   void SetEnergyThreshold(G4double);
@@ -172,7 +175,7 @@ protected :
   //
   GateSteppingActionMessenger* m_steppingMessenger;
   std::vector<GateTrack*> *PPTrackVector;
-  TrackingMode TheMode;
+  static std::atomic<TrackingMode> TheMode;
   G4int Boundary; // if set to 1 stop track on Phantom Boundary
   G4int fKeepOnlyP;
   G4int fKeepOnlyPhotons;
@@ -31,7 +31,11 @@ See LICENSE.md for further details
 #include <G4MultiFunctionalDetector.hh>
 #include <G4Run.hh>
 #include <G4Event.hh>
+#ifdef GATE_USE_MT
+#include <G4Threading.hh>
+#endif
 
+#include "GateConfiguration.h"
 #include "GateMessageManager.hh"
 #include "GateVFilter.hh"
 #include "GateActorManagerMessenger.hh"
@@ -47,6 +51,14 @@ public:
 
   static GateActorManager *GetInstance()
   {
+#ifdef GATE_USE_MT
+    // Each worker thread has its own manager (and its own copy of the actors)
+    if (G4Threading::IsWorkerThread()) {
+      if (singleton_WorkerActorManager == 0)
+        singleton_WorkerActorManager = new GateActorManager;
+      return singleton_WorkerActorManager;
+    }
+#endif
     if (singleton_ActorManager == 0)
     {
       //std::cout << "creating GateActorManager...\n";
@@ -56,6 +68,13 @@ public:
     return singleton_ActorManager;
   };
 
+  /// Manager of the master thread (the one which holds the actor prototypes)
+  static GateActorManager *GetMasterInstance()
+  {
+    if (singleton_ActorManager == 0) singleton_ActorManager = new GateActorManager;
+    return singleton_ActorManager;
+  };
+
   void SetResetAfterSaving(bool reset);
   bool GetResetAfterSaving() const;
 
@@ -102,6 +121,13 @@ public:
 
   G4int GetCurrentEventId() const { return mCurrentEventId; }
 
+#ifdef GATE_USE_MT
+  /// Serializes the callbacks of the actors shared by the worker threads
+  static G4Mutex * GetSharedActorMutex();
+  /// Serializes the merges of the worker actors into the master actors
+  static G4Mutex * GetMergeActorMutex();
+#endif
+
 protected:
   //std::vector<GateMultiSensitiveDetector*> theListOfMultiSensitiveDetector;
   std::vector<GateVActor*> theListOfActors;
@@ -116,12 +142,21 @@ protected:
   GateActorManagerMessenger* pActorManagerMessenger;  //pointer to the Messenger
   G4int mCurrentEventId;
 
+#ifdef GATE_USE_MT
+  bool IsWorkerInstance() const { return this != singleton_ActorManager; }
+  void LinkWorkerActorsToMaster();
+  void MergeWorkerActorsIntoMaster();
+#endif
+
 private:
   int IsInitialized;
   bool resetAfterSaving;
 
   GateActorManager();
   static GateActorManager *singleton_ActorManager;
+#ifdef GATE_USE_MT
+  static G4ThreadLocal GateActorManager *singleton_WorkerActorManager;
+#endif
 };
 
 #endif /* end #define GATEACTORMANAGER_HH */
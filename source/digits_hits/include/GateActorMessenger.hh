@@ -47,6 +47,7 @@ protected:
   G4UIcmdWithAnInteger* pSaveEveryNEventsCmd;
   G4UIcmdWithAnInteger* pSaveEveryNSecondsCmd;
   G4UIcmdWithABool *    pSetOverWriteFilesFlagCmd;
+  G4UIcmdWithABool *    pEnableAsyncSaveCmd;
   G4UIcmdWithABool *    pSetResetDataAtEachRunFlagCmd;
   G4UIcmdWithAString *  pAddFilterCmd;
 
@@ -68,9 +68,16 @@ class GateBlurring : public GateVPulseProcessor
     //! The result of the pulse-processing is incorporated into the output pulse-list
     void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList);
 
+    //! Batch version of ProcessOnePulse(): the resolutions are computed first, then all
+    //! energies are blurred in a single loop over one array of Gaussian samples
+    virtual G4bool IsBatchProcessor() const { return true; }
+    void ProcessPulseBatch(GatePulseBatch& batch);
+
   private:
     GateVBlurringLaw* m_blurringLaw;
     GateBlurringMessenger *m_messenger;   //!< Messenger
+    std::vector<G4double> m_sigma;        //!< Per-pulse energy sigma (batch processing)
+    std::vector<G4double> m_gauss;        //!< Per-pulse standard normal sample (batch processing)
 
 };
 
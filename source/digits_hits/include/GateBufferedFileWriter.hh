@@ -0,0 +1,98 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class GateBufferedFileWriter
+  \brief Output file filled by large in-memory batches
+
+  The records are serialized in memory (Write, WriteInt, ...) and,
+  each time a batch is full, the batch is handed to a background
+  thread that writes it to the file, so the event loop does not wait
+  for the disk. At most kMaxPendingBatches batches wait to be written,
+  which bounds the memory used when the disk is slower than the
+  simulation.
+
+  Lines are not flushed one by one: the data are on disk after Flush
+  or Close. GetSize is the number of bytes written since Open
+  (including the bytes not yet on disk) and is used for the file size
+  limits of the output modules.
+*/
+
+#ifndef GATEBUFFEREDFILEWRITER_HH
+#define GATEBUFFEREDFILEWRITER_HH
+
+#include "globals.hh"
+#include <fstream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//-----------------------------------------------------------------------------
+class GateBufferedFileWriter
+{
+public:
+  GateBufferedFileWriter();
+  ~GateBufferedFileWriter();
+
+  /// Opens the file and starts the writing thread, false if the file
+  /// cannot be opened
+  bool Open(const G4String & filename, bool binary);
+  /// Writes all the pending batches, then closes the file
+  void Close();
+  /// Waits until all the data are written to the file
+  void Flush();
+  bool IsOpen() const { return mIsOpen; }
+  long GetSize() const { return mSize; }
+
+  void Write(const char * data, size_t n) {
+    if (mBatch.size() + n > mBatchSize) SubmitBatch();
+    mBatch.insert(mBatch.end(), data, data+n);
+    mSize += n;
+  }
+  template<class T> void WriteValue(const T & value) {
+    Write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  // ASCII formatting, same output as the std::setw/std::setprecision
+  // stream operators
+  void WriteChar(char c) { Write(&c, 1); }
+  void WriteString(const G4String & s) { Write(s.data(), s.size()); }
+  /// Like 'std::setw(width) << value'
+  void WriteInt(long value, int width = 0);
+  /// Like 'std::scientific << std::setw(width) << std::setprecision(precision) << value'
+  void WriteScientific(double value, int width, int precision);
+
+protected:
+  static const size_t kDefaultBatchSize = 8*1024*1024;
+  static const size_t kMaxPendingBatches = 4;
+
+  void SubmitBatch();
+  void Run();
+
+  std::ofstream mFile;
+  bool mIsOpen;
+  long mSize;
+  size_t mBatchSize;
+  std::vector<char> mBatch;
+
+  // Shared with the writing thread
+  std::thread mThread;
+  std::mutex mMutex;
+  std::condition_variable mBatchReady;
+  std::condition_variable mBatchWritten;
+  std::deque<std::vector<char> > mPendingBatches;
+  std::vector<std::vector<char> > mFreeBatches;
+  bool mIsWriting;
+  bool mStop;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEBUFFEREDFILEWRITER_HH */
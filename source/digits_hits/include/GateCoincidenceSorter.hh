@@ -12,8 +12,8 @@ See LICENSE.md for further details
 
 #include "globals.hh"
 #include <iostream>
-#include <list>
 #include <deque>
+#include <vector>
 #include "G4ThreeVector.hh"
 
 #include "GateCoincidencePulse.hh"
@@ -158,7 +158,7 @@ class GateCoincidenceSorter : public GateClockDependent
     //! \name Work storage variable
     //@{
 
-    std::list<GatePulse*> m_presortBuffer;      // incoming pulses are presorted and buffered
+    std::deque<GatePulse*> m_presortBuffer;     // incoming pulses are presorted (by increasing time) and buffered
     G4int                 m_presortBufferSize;
     G4bool                m_presortWarning;     // avoid repeat warnings
 
@@ -167,6 +167,14 @@ class GateCoincidenceSorter : public GateClockDependent
     void ProcessCompletedCoincidenceWindow(GateCoincidencePulse*);
 
     G4bool IsForbiddenCoincidence(const GatePulse* pulse1,const GatePulse* pulse2);
+    //! Evaluate IsForbiddenCoincidence once for the pairs (i,j), i<nRows, i<j of a coincidence window
+    void ComputeGoodPairs(GateCoincidencePulse* coincidence, G4int nRows);
+    inline G4bool IsGoodPair(G4int i, G4int j) const
+      { return m_goodPairs[i*m_goodPairsStride+j]; }
+    static inline G4bool IsEarlierPulse(const GatePulse* pulse1, const GatePulse* pulse2)
+      { return pulse1->GetTime() < pulse2->GetTime(); }
+    std::vector<char>     m_goodPairs;         // pair validity of the window being processed (reused)
+    G4int                 m_goodPairsStride;
     GateCoincidencePulse* CreateSubPulse(GateCoincidencePulse* coincidence, G4int i, G4int j);
     G4int ComputeSectorID(const GatePulse& pulse);
     static G4int          gm_coincSectNum;     // internal use
@@ -22,6 +22,7 @@ See LICENSE.md for further details
 
 #include "GateVolumeID.hh"
 #include "GateOutputVolumeID.hh"
+#include "GateNameTable.hh"
 
 /*! \class  GateCrystalHit
     \brief  Stores hit information for a hit taking place in a volume connected to a system
@@ -64,7 +65,7 @@ private:
   G4double m_posz;
   G4ThreeVector m_momDir;        // momentum Direction of the current hit
   G4ThreeVector m_localPos;   // position of the current hit
-  G4String m_process;         // process on the current hit
+  G4int m_process;            // process (GateNameTable ID) on the current hit
   G4int m_PDGEncoding;        // G4 PDGEncoding
   G4int m_trackID;            // track ID
   G4int m_parentID;           // parent track ID
@@ -75,8 +76,8 @@ private:
   G4int m_nCrystalCompton;    // # of compton processes in the crystal occurred to the photon
   G4int m_nPhantomRayleigh;    // # of Rayleigh processes in the phantom occurred to the photon
   G4int m_nCrystalRayleigh;    // # of Rayleigh processes in the crystal occurred to the photon
-  G4String m_comptonVolumeName; // name of the volume of the last (if any) compton scattering
-  G4String m_RayleighVolumeName; // name of the volume of the last (if any) Rayleigh scattering
+  G4int m_comptonVolumeName;  // name (GateNameTable ID) of the volume of the last (if any) compton scattering
+  G4int m_RayleighVolumeName; // name (GateNameTable ID) of the volume of the last (if any) Rayleigh scattering
   G4int m_primaryID;          // primary that caused the hit
   G4int m_eventID;            // eventID
   G4int m_runID;              // runID
@@ -120,8 +121,10 @@ private:
       inline const G4ThreeVector& GetLocalPos() const             { return m_localPos; }
 
 
-      inline void     SetProcess(G4String proc) { m_process = proc; }
-      inline G4String GetProcess() const             { return m_process; }
+      inline void     SetProcess(const G4String& proc) { m_process = GateNameTable::GetID(proc); }
+      inline const G4String& GetProcess() const      { return GateNameTable::GetName(m_process); }
+      inline void  SetProcessID(G4int id)            { m_process = id; }
+      inline G4int GetProcessID() const              { return m_process; }
 
       inline void  SetPDGEncoding(G4int j)      { m_PDGEncoding = j; }
       inline G4int GetPDGEncoding() const            { return m_PDGEncoding; }
@@ -153,11 +156,15 @@ private:
       inline void  SetNCrystalRayleigh(G4int j)  { m_nCrystalRayleigh = j; }
       inline G4int GetNCrystalRayleigh() const        { return m_nCrystalRayleigh; }
 
-      inline void     SetComptonVolumeName(G4String name) { m_comptonVolumeName = name; }
-      inline G4String GetComptonVolumeName() const        { return m_comptonVolumeName; }
+      inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeName = GateNameTable::GetID(name); }
+      inline const G4String& GetComptonVolumeName() const { return GateNameTable::GetName(m_comptonVolumeName); }
+      inline void  SetComptonVolumeNameID(G4int id)     { m_comptonVolumeName = id; }
+      inline G4int GetComptonVolumeNameID() const       { return m_comptonVolumeName; }
 
-      inline void     SetRayleighVolumeName(G4String name) { m_RayleighVolumeName = name; }
-      inline G4String GetRayleighVolumeName() const        { return m_RayleighVolumeName; }
+      inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeName = GateNameTable::GetID(name); }
+      inline const G4String& GetRayleighVolumeName() const { return GateNameTable::GetName(m_RayleighVolumeName); }
+      inline void  SetRayleighVolumeNameID(G4int id)     { m_RayleighVolumeName = id; }
+      inline G4int GetRayleighVolumeNameID() const       { return m_RayleighVolumeName; }
 
       inline void  SetPrimaryID(G4int j)        { m_primaryID = j; }
       inline G4int GetPrimaryID() const              { return m_primaryID; }
@@ -185,7 +192,7 @@ private:
       inline G4int GetSystemID() const { return m_systemID; }
 
       inline G4bool GoodForAnalysis() const
-      	  { return ( (m_process != "Transportation") || (m_edep!=0.) ); }
+      	  { return ( (m_process != GateNameTable::kTransportationID) || (m_edep!=0.) ); }
 
       // HDS : Added in order to record septal penetration
       inline void  SetNSeptal(G4int j)  { m_nSeptal = j; }
@@ -208,18 +215,20 @@ private:
 
 typedef G4THitsCollection<GateCrystalHit> GateCrystalHitsCollection;
 
-extern G4Allocator<GateCrystalHit> GateCrystalHitAllocator;
+// (hits are created and deleted by the thread processing the event)
+extern G4ThreadLocal G4Allocator<GateCrystalHit> *GateCrystalHitAllocator;
 
 inline void* GateCrystalHit::operator new(size_t)
 {
+  if (!GateCrystalHitAllocator) GateCrystalHitAllocator = new G4Allocator<GateCrystalHit>;
   void *aHit;
-  aHit = (void *) GateCrystalHitAllocator.MallocSingle();
+  aHit = (void *) GateCrystalHitAllocator->MallocSingle();
   return aHit;
 }
 
 inline void GateCrystalHit::operator delete(void *aHit)
 {
-  GateCrystalHitAllocator.FreeSingle((GateCrystalHit*) aHit);
+  GateCrystalHitAllocator->FreeSingle((GateCrystalHit*) aHit);
 }
 
 #endif
@@ -12,9 +12,11 @@ See LICENSE.md for further details
 
 #include "G4VSensitiveDetector.hh"
 #include "GateCrystalHit.hh"
+#include <unordered_map>
 class G4Step;
 class G4HCofThisEvent;
 class G4TouchableHistory;
+class G4VProcess;
 
 class GateVVolume;
 class GateVSystem;
@@ -41,6 +43,12 @@ typedef GateSystemList::const_iterator GateSystemConstIterator;
 
     - The GateCrystalSD generates hits of the class GateCrystalHit, which are stored in a regular
       hit collection.
+
+    - The volume ID, the output volume ID and the system of a hit only depend on the path of
+      the touchable (physical volume and copy number of each level). They are computed at the
+      first hit in a crystal and stored in a table indexed by this path, so that the next hits
+      only need a hash lookup. The table is cleared when physical volumes are deleted (see
+      GateVVolume::GetGeometryGeneration); the moves only update the placements and keep it.
 */
 //    Last modification in 12/2011 by Abdul-Fattah.Mohamad-Hadi@subatech.in2p3.fr, for the multi-system approach.
 
@@ -54,6 +62,9 @@ class GateCrystalSD : public G4VSensitiveDetector
       //! Destructor
       ~GateCrystalSD();
 
+      //! Returns a copy of the SD (attached to the same systems) for a worker thread
+      G4VSensitiveDetector* Clone() const;
+
       //! Method overloading the virtual method Initialize() of G4VSensitiveDetector
       void Initialize(G4HCofThisEvent*HCE);
 
@@ -74,15 +85,40 @@ class GateCrystalSD : public G4VSensitiveDetector
       //! next methods are for the multi-system approach
       inline GateSystemList* GetSystemList() const { return m_systemList; }
       void AddSystem(GateVSystem* aSystem);
-      GateVSystem* FindSystem(GateVolumeID volumeID);
+      GateVSystem* FindSystem(const GateVolumeID& volumeID);
       GateVSystem* FindSystem(G4String& systemName);
 
       G4int PrepareCreatorAttachment(GateVVolume* aCreator);
 
 
   protected:
+     //! IDs of the hits in a crystal
+     struct VolumeIDEntry {
+       GateVolumeID       volumeID;
+       GateOutputVolumeID outputVolumeID;
+       GateVSystem*       system;
+     };
+     //! Physical volume and copy number of each level of a touchable (without the world)
+     typedef std::vector< std::pair<const G4VPhysicalVolume*,G4int> > TouchablePath;
+     struct TouchablePathHash {
+       size_t operator()(const TouchablePath& path) const;
+     };
+     typedef std::unordered_map<TouchablePath,VolumeIDEntry,TouchablePathHash> VolumeIDTable;
+
+     //! Returns the IDs of the touchable, computed at the first call for its path
+     const VolumeIDEntry& GetVolumeIDEntry(const G4TouchableHistory* touchable);
+     //! GateNameTable ID of the name of the process, interned once per process
+     G4int GetProcessNameID(const G4VProcess* process);
+
      GateVSystem* m_system;                           //! System to which the SD is attached //mhadi_obso obsollete, because we use the multi-system approach
      GateSystemList* m_systemList;                    //! System list instead of one system
+
+     VolumeIDTable m_volumeIDTable;                   //! IDs of the crystals already hit
+     TouchablePath m_touchablePath;                   //! Key of the last lookup (kept to avoid allocations)
+     G4int m_volumeIDTableGeneration;                 //! Geometry generation of the table
+     std::unordered_map<const G4VProcess*,G4int> m_processNameIDs; //! Name IDs of the processes already met
+     const G4VProcess* m_lastProcess;                 //! Last process looked up by GetProcessNameID
+     G4int m_lastProcessNameID;
   private:
       GateCrystalHitsCollection * crystalCollection;  //! Hit collection
 
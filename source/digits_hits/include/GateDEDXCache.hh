@@ -0,0 +1,69 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class GateDEDXCache
+  \brief Tabulated unrestricted stopping powers used by the actors
+
+  G4EmCalculator is too slow to be called at each step. For each
+  (particle, material) pair, the dE/dx is tabulated on a logarithmic
+  energy grid and linearly interpolated. The nodes of a table are
+  computed with G4EmCalculator the first time they are needed, so only
+  the pairs and energies actually met during the run are computed.
+
+  There is one cache per thread (GetInstance). Invalidate() must be
+  called at the beginning of each run, as the physics tables may have
+  been rebuilt.
+*/
+
+#ifndef GATEDEDXCACHE_HH
+#define GATEDEDXCACHE_HH
+
+#include "globals.hh"
+#include "G4EmCalculator.hh"
+#include <map>
+#include <vector>
+#include <utility>
+
+class G4ParticleDefinition;
+class G4Material;
+
+//-----------------------------------------------------------------------------
+class GateDEDXCache
+{
+public:
+  static GateDEDXCache * GetInstance();
+  static void Invalidate();
+
+  G4double GetElectronicDEDX(G4double energy, const G4ParticleDefinition * p, const G4Material * m) {
+    return GetDEDX(0, energy, p, m);
+  }
+  G4double GetTotalDEDX(G4double energy, const G4ParticleDefinition * p, const G4Material * m) {
+    return GetDEDX(1, energy, p, m);
+  }
+
+protected:
+  GateDEDXCache();
+
+  // (type: 0 electronic, 1 total)
+  typedef std::pair<std::pair<const G4ParticleDefinition*, const G4Material*>, G4int> KeyType;
+
+  G4double GetDEDX(G4int type, G4double energy, const G4ParticleDefinition * p, const G4Material * m);
+  G4double ComputeDEDX(G4int type, G4double energy, const G4ParticleDefinition * p, const G4Material * m);
+  void Clear();
+
+  G4EmCalculator mEmCalculator;
+  std::map<KeyType, std::vector<G4double> > mTables;
+  KeyType mLastKey;
+  std::vector<G4double> * mLastTable;
+  G4int mGeneration;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEDEDXCACHE_HH */
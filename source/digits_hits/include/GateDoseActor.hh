@@ -31,6 +31,8 @@
 #include "GateVoxelizedMass.hh"
 #include "GateRegionDoseStat.hh"
 
+#include <atomic>
+
 class G4EmCalculator;
 
 class GateDoseActor : public GateVImageActor
@@ -75,9 +77,11 @@ public:
   void SetDoseAlgorithmType(G4String b) { mDoseAlgorithmType = b; }
   void ImportMassImage(G4String b) { mImportMassImage = b; }
   void ExportMassImage(G4String b) { mExportMassImage = b; }
+  void SetMassCacheDirectory(G4String b) { mMassCacheDirectory = b; }
   void VolumeFilter(G4String b) { mVolumeFilter = b; }
   void MaterialFilter(G4String b) { mMaterialFilter = b; }
   void setTestFlag(bool b) { mTestFlag = b; }
+  void EnableSharedScoring(bool b) { mIsSharedScoringEnabled = b; }
   //Regions
   void SetDoseByRegionsInputFilename(std::string f);
   void SetDoseByRegionsOutputFilename(std::string f);
@@ -85,15 +89,26 @@ public:
 
   virtual void BeginOfRunAction(const G4Run*r);
   virtual void BeginOfEventAction(const G4Event * event);
+  virtual void EndOfEventAction(const G4Event * event);
 
+  virtual void UserSteppingAction(const GateVVolume * v, const G4Step * step);
   virtual void UserSteppingActionInVoxel(const int index, const G4Step* step);
   virtual void UserPreTrackActionInVoxel(const int /*index*/, const G4Track* track);
   virtual void UserPostTrackActionInVoxel(const int /*index*/, const G4Track* /*t*/) {}
 
   //  Saves the data collected to the file
   virtual void SaveData();
+  virtual void SaveDataAsync();
   virtual void ResetData();
 
+  // Multithreading: the images of the worker threads are summed (the dose
+  // by regions statistics cannot be merged)
+  virtual bool IsMergeable() const { return !mDoseByRegionsFlag; }
+  virtual void MergeWorkerData(GateVActor * worker);
+  // With shared scoring, a single set of images is filled by all the
+  // threads with atomic additions (no per-thread copy, no merge)
+  virtual bool IsThreadSafe() const { return mIsSharedScoringEnabled; }
+
   // Scorer related
   virtual void Initialize(G4HCofThisEvent*){}
   virtual void EndOfEvent(G4HCofThisEvent*){}
@@ -103,7 +118,7 @@ protected:
   GateDoseActorMessenger* pMessenger;
   GateVoxelizedMass mVoxelizedMass;
 
-  int mCurrentEvent;
+  std::atomic<int> mCurrentEvent;
   StepHitType mUserStepHitType;
 
   bool mIsLastHitEventImageEnabled;
@@ -132,6 +147,7 @@ protected:
   //Others
   bool mIsNumberOfHitsImageEnabled;
   bool mTestFlag;
+  bool mIsSharedScoringEnabled;
 
   //Edep
   G4String mEdepFilename;
@@ -167,10 +183,12 @@ protected:
   G4String mDoseAlgorithmType;
   G4String mImportMassImage;
   G4String mExportMassImage;
+  G4String mMassCacheDirectory;
   G4String mVolumeFilter;
   G4String mMaterialFilter;
 
   G4EmCalculator* emcalc;
+  G4EmCalculator* GetEmCalculator();
 
 };
 
@@ -61,9 +61,11 @@ protected:
   G4UIcmdWithAString * pSetDoseAlgorithmCmd;
   G4UIcmdWithAString * pImportMassImageCmd;
   G4UIcmdWithAString * pExportMassImageCmd;
+  G4UIcmdWithAString * pMassCacheDirectoryCmd;
   G4UIcmdWithAString * pVolumeFilterCmd;
   G4UIcmdWithAString * pMaterialFilterCmd;
   G4UIcmdWithABool * pTestFlagCmd;
+  G4UIcmdWithABool * pEnableSharedScoringCmd;
   //Regions
   G4UIcmdWithAString * pDoseRegionInputCmd;
   G4UIcmdWithAString * pDoseRegionOutputCmd;
@@ -18,6 +18,8 @@ See LICENSE.md for further details
 #define GATEIMAGEWITHSTATISTIC_HH
 
 #include "GateImage.hh"
+#include "GateSnapshotWriter.hh"
+#include <unordered_map>
 
 //-----------------------------------------------------------------------------
 /// \brief
@@ -40,6 +42,25 @@ class GateImageWithStatistic
   void AddValueAndUpdate(const int index, double value);
   void AddValue(const int index, double value);
 
+  // Shared scoring: the image may be filled concurrently by several threads.
+  // The values are accumulated with atomic additions, and the per-event
+  // values needed by the squared image are kept in a small buffer of the
+  // calling thread, tagged with the event ID (no temporary image and no
+  // last-hit-event image are allocated). The buffer is flushed when
+  // another event ID is seen, by FlushEvent() and before saving.
+  void EnableSharedScoring(bool b);
+  bool IsSharedScoringEnabled() const { return mIsSharedScoringEnabled; }
+  void AddValueInEvent(const int eventID, const int index, double value);
+  void FlushEvent();
+  static void AtomicAdd(double & target, double value);
+  static void AtomicAdd(int & target, int value);
+  // Values deposited during the current event of a thread
+  struct EventBuffer {
+    EventBuffer():eventID(-1) {}
+    int eventID;
+    std::unordered_map<int, double> values;
+  };
+
   double GetValue(const int index);
   void  SetValue(const int index, double value );
   void Fill(double value);
@@ -52,6 +73,10 @@ class GateImageWithStatistic
 
   void SetFilename(G4String f);
   void SaveData(int numberOfEvents, bool normalise=false);
+  // Same as SaveData, but the uncertainty computation and the writing are
+  // done on a copy of the images, by the returned task (to be submitted to
+  // the GateSnapshotWriter)
+  GateSnapshotWriter::Task CreateSaveTask(int numberOfEvents, bool normalise=false);
 
   inline G4double GetVoxelVolume() const { return mValueImage.GetVoxelVolume(); }
 
@@ -59,6 +84,10 @@ class GateImageWithStatistic
   virtual void UpdateSquaredImage();
   virtual void UpdateUncertaintyImage(int numberOfEvents);
 
+  // Add the values (and squared values) of another image with the same
+  // size, e.g. the image of a worker thread. Its temporary image is flushed.
+  void Merge(GateImageWithStatistic & other);
+
   GateVImage & GetValueImage() { return mValueImage; }
   GateVImage & GetUncertaintyImage() { return mUncertaintyImage; }
 
@@ -67,6 +96,10 @@ class GateImageWithStatistic
   void SetTransformMatrix(const G4RotationMatrix & m);
 
   protected:
+  void PrepareSave();
+  void WriteImages(int numberOfEvents, bool normalise);
+  GateImageWithStatistic * CreateSnapshot() const;
+
   GateImageDouble mValueImage;
   GateImageDouble mSquaredImage;
   GateImageDouble mTempImage;
@@ -80,6 +113,13 @@ class GateImageWithStatistic
   bool mIsSquaredImageEnabled;
   bool mIsUncertaintyImageEnabled;
   bool mIsValuesMustBeScaled;
+  bool mIsSharedScoringEnabled;
+
+  // Position of the buffers of this image in the per-thread vector of
+  // buffers (set by EnableSharedScoring), and buffers of all the threads
+  int mEventBufferIndex;
+  std::vector<EventBuffer*> mEventBuffers;
+  EventBuffer & GetThreadEventBuffer();
 
   double mScaleFactor;
 
@@ -94,6 +94,7 @@ protected:
   bool mIsParallelCalculationEnabled;
 
   G4EmCalculator * emcalc;
+  G4Material * mWater;
 };
 
 MAKE_AUTO_CREATOR_ACTOR(LETActor,GateLETActor)
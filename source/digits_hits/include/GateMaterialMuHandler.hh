@@ -24,6 +24,7 @@ See LICENSE.md for further details
 #include "G4LossTableManager.hh"
 
 #include <map>
+#include <vector>
 
 
 using std::map;
@@ -83,6 +84,7 @@ public:
   void SetENumber(int n) { mEnergyNumber = n; }
   void SetAtomicShellEMin(double e) { mAtomicShellEnergyMin = e; }
   void SetPrecision(double p) { mPrecision = p; }
+  void SetLookupBinsPerOctave(int n) { mLookupBinsPerOctave = n; }
 
 private:
 
@@ -99,6 +101,10 @@ private:
   void MergeAtomicShell(std::vector<MuStorageStruct> *);
   double ProcessOneShot(G4VEmModel *,std::vector<G4DynamicParticle*> *, const G4MaterialCutsCouple *, const G4DynamicParticle *);
   double SquaredSigmaOnMean(double , double , double);
+  // - Simulated tables stored in the GatePhysicsTableCache directory
+  unsigned long long GetMuTableCacheHash();
+  bool ReadMuTableCache(unsigned long long hash);
+  void WriteMuTableCache(unsigned long long hash);
 
   map<const G4MaterialCutsCouple *, GateMuTable*> mCoupleTable;
   GateMuTable** mElementsTable;
@@ -111,12 +117,14 @@ private:
   int mEnergyNumber;
   double mAtomicShellEnergyMin;
   double mPrecision;
+  int mLookupBinsPerOctave;
 
   static GateMaterialMuHandler *singleton_MaterialMuHandler;
   
-  // - fast acces
+  // - fast acces (tables indexed by G4MaterialCutsCouple::GetIndex())
   void CheckLastCall(const G4MaterialCutsCouple *);
-  const G4MaterialCutsCouple *mLastCouple;
+  void BuildCoupleIndexTable();
+  std::vector<GateMuTable *> mCoupleIndexTable;
   GateMuTable *mLastMuTable;
 
 };
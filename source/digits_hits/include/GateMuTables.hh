@@ -19,13 +19,22 @@ See LICENSE.md for further details
 #include "G4MaterialCutsCouple.hh"
 #include "G4Material.hh"
 
+#include <vector>
+
 class GateMuTable
 {
 public:
   GateMuTable(const G4MaterialCutsCouple *couple, G4int size);
   ~GateMuTable();
   void PutValue(int index, double energy, double mu, double mu_en);
-  
+
+  // Resample the table on a grid uniform in log2(energy): each octave is
+  // split into binsPerOctave bins, so that a lookup is a direct index
+  // (from the exponent and mantissa of the energy) and a linear
+  // interpolation. Bins containing an atomic shell edge keep the exact
+  // log-log interpolation. binsPerOctave = 0 disables the grid.
+  void BuildLookupGrid(int binsPerOctave);
+
   double GetMuEn(double energy);
   double GetMuEnOverRho(double energy);
   double GetMu(double energy);
@@ -41,7 +50,10 @@ public:
   double* GetMuTable() {return mMu;}
 
 private:
-  
+
+  double ComputeFromTable(double energy, const double *table) const;
+  bool FindGridBin(double energy, int & bin, double & frac) const;
+
   const G4MaterialCutsCouple *mCouple;
   const G4Material *mMaterial;
   double mDensity;
@@ -49,11 +61,15 @@ private:
   double *mEnergy;
   double *mMu;
   double *mMu_en;
-  double lastEnergyMu;
-  double lastEnergyMuen;
-  double lastMu;
-  double lastMuen;
   G4int mSize;
+
+  // Lookup grid (linear values of mu/rho and muen/rho at the grid nodes)
+  int mGridBinsPerOctave;
+  int mGridFirstExponent;
+  int mGridNumberOfBins;
+  std::vector<double> mGridMu;
+  std::vector<double> mGridMu_en;
+  std::vector<bool> mGridIsExactBin;
 };
 
 
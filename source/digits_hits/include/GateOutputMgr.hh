@@ -19,6 +19,7 @@
 
 #include "GateConfiguration.h"
 #include "GateRecorderBase.hh"
+#include "GateProfiler.hh"
 #include "GateVOutputModule.hh"
 #include "GateCrystalHit.hh"
 #include "GatePhantomHit.hh"
@@ -145,6 +146,16 @@ protected :
   //! List of the output modules
   std::vector<GateVOutputModule*>   m_outputModules;
 
+  //! Profiling (see GateProfiler): sections of the event and step callbacks of the modules
+  enum { kProfiledBeginOfEvent, kProfiledEndOfEvent, kProfiledStep, kNumberOfProfiledCallbacks };
+  inline int GetProfilerSection(size_t iMod, int callback) {
+    if (!GateProfiler::IsEnabled()) return -1;
+    if (m_profilerSections.size() != m_outputModules.size()*kNumberOfProfiledCallbacks) CreateProfilerSections();
+    return m_profilerSections[iMod*kNumberOfProfiledCallbacks + callback];
+  }
+  void CreateProfilerSections();
+  std::vector<int> m_profilerSections;
+
   //! messenger for the Mgr specific commands
   GateOutputMgrMessenger*    m_messenger;
 
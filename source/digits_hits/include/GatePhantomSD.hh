@@ -21,6 +21,7 @@ class GatePhantomSD : public G4VSensitiveDetector
   public:
       GatePhantomSD(const G4String& name);
       ~GatePhantomSD();
+      G4VSensitiveDetector* Clone() const;
 
       void Initialize(G4HCofThisEvent*HCE);
       G4bool ProcessHits(G4Step*aStep,G4TouchableHistory*ROhist);
@@ -21,6 +21,7 @@
 
 #include "GateVActor.hh"
 #include "GatePhaseSpaceActorMessenger.hh"
+#include "GatePhaseSpaceBinaryFile.hh"
 
 struct iaea_header_type;
 struct iaea_record_type;
@@ -190,6 +191,7 @@ protected:
 
   iaea_record_type *pIAEARecordType;
   iaea_header_type *pIAEAheader;
+  GatePhaseSpaceBinaryWriter *pBinaryWriter;
 };
 
 MAKE_AUTO_CREATOR_ACTOR(PhaseSpaceActor,GatePhaseSpaceActor)
@@ -0,0 +1,110 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+/*!
+  \class GateProfilerActor
+  \brief Switches on the GateProfiler and writes its report
+
+  With this actor, the callbacks of the actors, the pulse processors,
+  the output modules and the source are timed (GateProfiler). The
+  actor also counts the steps per logical volume and per particle and
+  the time of each event (from BeginOfEventAction to EndOfEventAction).
+
+  SaveData writes a flat report (one line per timed section, sorted by
+  total time) to the save file, and the histogram of the event times
+  (logarithmic bins) to <file>_eventTime.txt.
+ */
+
+#ifndef GATEPROFILERACTOR_HH
+#define GATEPROFILERACTOR_HH
+
+#include "GateVActor.hh"
+#include "GateActorManager.hh"
+#include "GateActorMessenger.hh"
+
+#include <chrono>
+#include <map>
+#include <unordered_map>
+
+//-----------------------------------------------------------------------------
+class GateProfilerActor : public GateVActor
+{
+ public:
+
+  virtual ~GateProfilerActor();
+
+  //-----------------------------------------------------------------------------
+  // This macro initialize the CreatePrototype and CreateInstance
+  FCT_FOR_AUTO_CREATOR_ACTOR(GateProfilerActor)
+
+  //-----------------------------------------------------------------------------
+  // Constructs the sensor
+  virtual void Construct();
+
+  //-----------------------------------------------------------------------------
+  // Callbacks
+  virtual void BeginOfEventAction(const G4Event*);
+  virtual void EndOfEventAction(const G4Event*);
+  virtual void UserSteppingAction(const GateVVolume *, const G4Step*);
+
+  //-----------------------------------------------------------------------------
+  /// Saves the data collected to the file
+  virtual void SaveData();
+  virtual void ResetData();
+
+  // Multithreading: the step counts and the event times of the worker
+  // threads are summed (the timed sections are summed by the GateProfiler)
+  virtual bool IsMergeable() const { return true; }
+  virtual void MergeWorkerData(GateVActor * worker);
+
+protected:
+  GateProfilerActor(G4String name, G4int depth=0);
+
+  // Event time histogram: kBinsPerDecade bins per decade from
+  // kMinEventTime, plus an underflow and an overflow bin
+  static const int kBinsPerDecade = 10;
+  static const int kNumberOfDecades = 8;
+  static const double kMinEventTime; // in seconds
+  int GetEventTimeBin(double seconds) const;
+
+  struct StepCount {
+    StepCount() : steps(0) {}
+    G4String name;
+    long long steps;
+  };
+  typedef std::unordered_map<const void*, StepCount> StepCountMap;
+  typedef std::map<G4String, long long> NamedStepCountMap;
+
+  // The logical volumes may be deleted when the geometry is rebuilt:
+  // their counts are then moved to the named counts
+  void MoveVolumeCounts();
+  void SaveEventTimeHistogram();
+
+  long long mNumberOfEvents;
+  double mTotalEventTime;
+  std::vector<long long> mEventTimeHistogram;
+  std::chrono::steady_clock::time_point mEventStart;
+
+  StepCountMap mStepsPerVolume;
+  StepCountMap mStepsPerParticle;
+  NamedStepCountMap mStepsPerVolumeName;
+  G4int mGeometryGeneration;
+  // Counters of the previous step, most steps are in the same volume
+  // and for the same particle as the previous one
+  const void * pLastVolume;
+  long long * pLastVolumeSteps;
+  const void * pLastParticle;
+  long long * pLastParticleSteps;
+
+  GateActorMessenger * pMessenger;
+};
+
+MAKE_AUTO_CREATOR_ACTOR(ProfilerActor,GateProfilerActor)
+
+
+#endif /* end #define GATEPROFILERACTOR_HH */
@@ -60,7 +60,7 @@ protected:
 
   //helper functions
   void SetTrackIoH(GateImageOfHistograms*&);
-  void SetTLEIoH(GateImageOfHistograms*&);
+  void SetTLEIoH(GateImageOfHistograms*&, bool sparse = false);
   GateVImageVolume* GetPhantom();
   void BuildVarianceOutput(); //converts trackl,tracklsq into mImageGamma and tlevar per voxel. Not used.
   //void BuildSysVarianceOutput(); //converts trackl into mImageGamma and tlesysvarv. Not used.
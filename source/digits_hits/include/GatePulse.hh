@@ -15,9 +15,11 @@ See LICENSE.md for further details
 #include <iostream>
 #include <vector>
 #include "G4ThreeVector.hh"
+#include "G4Allocator.hh"
 
 #include "GateVolumeID.hh"
 #include "GateOutputVolumeID.hh"
+#include "GateNameTable.hh"
 
 /*! \class  GatePulse
     \brief  Class for storing a 'pulse' (luminous or electronic) derived from one or more hits
@@ -50,6 +52,11 @@ class GatePulse
     //! Destructor
     virtual inline ~GatePulse() {}
 
+    //! Pulses are copied at each stage of the digitizer chain: they are
+    //! allocated from a pool
+    inline void *operator new(size_t);
+    inline void operator delete(void *aPulse, size_t);
+
   public:
     //! \name getters and setters to acces the content of the pulse
     //@{
@@ -96,11 +103,15 @@ class GatePulse
       inline void  SetNCrystalRayleigh(G4int j)  { m_nCrystalRayleigh = j; }
       inline G4int GetNCrystalRayleigh() const        { return m_nCrystalRayleigh; }
 
-      inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeName = name; }
-      inline G4String GetComptonVolumeName() const        { return m_comptonVolumeName; }
+      inline void     SetComptonVolumeName(const G4String& name) { m_comptonVolumeName = GateNameTable::GetID(name); }
+      inline const G4String& GetComptonVolumeName() const        { return GateNameTable::GetName(m_comptonVolumeName); }
+      inline void  SetComptonVolumeNameID(G4int id)               { m_comptonVolumeName = id; }
+      inline G4int GetComptonVolumeNameID() const                 { return m_comptonVolumeName; }
 
-      inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeName = name; }
-      inline G4String GetRayleighVolumeName() const        { return m_RayleighVolumeName; }
+      inline void     SetRayleighVolumeName(const G4String& name) { m_RayleighVolumeName = GateNameTable::GetID(name); }
+      inline const G4String& GetRayleighVolumeName() const        { return GateNameTable::GetName(m_RayleighVolumeName); }
+      inline void  SetRayleighVolumeNameID(G4int id)               { m_RayleighVolumeName = id; }
+      inline G4int GetRayleighVolumeNameID() const                 { return m_RayleighVolumeName; }
 
       inline void  SetVolumeID(const GateVolumeID& volumeID)            { m_volumeID = volumeID; }
       inline const GateVolumeID& GetVolumeID() const                  	{ return m_volumeID; }
@@ -153,8 +164,8 @@ private:
   G4int m_nCrystalCompton;    	  //!< # of compton processes in the crystal occurred to the photon
   G4int m_nPhantomRayleigh;    	  //!< # of Rayleigh processes in the phantom occurred to the photon
   G4int m_nCrystalRayleigh;    	  //!< # of Rayleigh processes in the crystal occurred to the photon
-  G4String m_comptonVolumeName;   //!< name of the volume of the last (if any) compton scattering
-  G4String m_RayleighVolumeName;   //!< name of the volume of the last (if any) Rayleigh scattering
+  G4int m_comptonVolumeName;      //!< name (GateNameTable ID) of the volume of the last (if any) compton scattering
+  G4int m_RayleighVolumeName;     //!< name (GateNameTable ID) of the volume of the last (if any) Rayleigh scattering
   GateVolumeID m_volumeID;        //!< Volume ID in the world volume tree
   G4ThreeVector m_scannerPos; 	  //!< Position of the scanner
   G4double m_scannerRotAngle; 	  //!< Rotation angle of the scanner
@@ -206,6 +217,23 @@ class GatePulseList: public std::vector<GatePulse*>
 };
 
 
+extern G4Allocator<GatePulse> GatePulseAllocator;
+
+inline void* GatePulse::operator new(size_t size)
+{
+  // (derived classes do not fit into the pool)
+  if (size != sizeof(GatePulse)) return ::operator new(size);
+  return (void *) GatePulseAllocator.MallocSingle();
+}
+
+inline void GatePulse::operator delete(void *aPulse, size_t size)
+{
+  if (size != sizeof(GatePulse)) { ::operator delete(aPulse); return; }
+  GatePulseAllocator.FreeSingle((GatePulse*) aPulse);
+}
+
+
+
 //! Iterator on a pulse list
 typedef GatePulseList::iterator GatePulseIterator;
 
@@ -0,0 +1,60 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#ifndef GatePulseBatch_h
+#define GatePulseBatch_h 1
+
+#include "globals.hh"
+#include <vector>
+
+#include "GatePulse.hh"
+
+/*! \class  GatePulseBatch
+    \brief  Columnar (structure-of-arrays) view of a pulse-list
+
+    - GatePulseBatch is filled from an input pulse-list by GateVPulseProcessor::ProcessPulseList()
+      when the processor implements ProcessPulseBatch(). The processor works on the plain
+      energy, time and global position columns with simple loops, and clears the 'keep'
+      flag of the pulses it discards.
+
+    - The volume IDs and the other pulse attributes are not copied: they are reached
+      through GetPulse(i), and are carried over unchanged to the output pulses.
+
+    - The batch is owned by the processor and reused from one event to the next, so that
+      its columns are only reallocated when a larger pulse-list is met.
+
+      \sa GateVPulseProcessor, GatePulse, GatePulseList
+*/
+class GatePulseBatch
+{
+  public:
+    GatePulseBatch() {}
+
+    //! Load the columns from a pulse-list (null pulses are skipped)
+    void Fill(const GatePulseList& pulseList);
+
+    //! Copy the kept pulses into the output pulse-list, with the updated columns
+    void AppendKeptPulses(GatePulseList& outputPulseList) const;
+
+    inline size_t size() const                       { return m_pulses.size(); }
+    inline const GatePulse* GetPulse(size_t i) const { return m_pulses[i]; }
+
+    //! Columns. The position columns are in the global frame
+    std::vector<G4double> energy;
+    std::vector<G4double> time;
+    std::vector<G4double> posX;
+    std::vector<G4double> posY;
+    std::vector<G4double> posZ;
+    std::vector<char>     keep;
+
+  protected:
+    std::vector<const GatePulse*> m_pulses;
+};
+
+#endif
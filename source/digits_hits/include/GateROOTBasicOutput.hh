@@ -55,6 +55,7 @@ public:
   void RecordEndOfEvent(const G4Event * );
 
   void RecordStepWithVolume(const GateVVolume * v, const G4Step *);
+  G4bool IsRecordingSteps() const { return false; }
   void SetfileName(G4String name);
 
 private:
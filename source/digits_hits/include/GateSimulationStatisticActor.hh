@@ -50,6 +50,11 @@ class GateSimulationStatisticActor : public GateVActor
   virtual void SaveData();
   virtual void ResetData();
 
+  // Multithreading: the counters of the worker threads are summed (the
+  // runs are counted by the master actor)
+  virtual bool IsMergeable() const { return true; }
+  virtual void MergeWorkerData(GateVActor * worker);
+
 protected:
   GateSimulationStatisticActor(G4String name, G4int depth=0);
 
@@ -0,0 +1,61 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class GateSnapshotWriter
+  \brief Background thread writing the intermediate outputs of the actors
+
+  Actors with asynchronous saving enabled copy their data at the end of an
+  event and submit a task which computes and writes the output files. The
+  tasks are run one after the other by a single writer thread. Only the
+  latest snapshot of an actor is kept: a task still waiting in the queue
+  is replaced when the same actor submits a new one.
+*/
+
+#ifndef GATESNAPSHOTWRITER_HH
+#define GATESNAPSHOTWRITER_HH
+
+#include <deque>
+#include <utility>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//-----------------------------------------------------------------------------
+class GateSnapshotWriter
+{
+public:
+  static GateSnapshotWriter * GetInstance();
+  ~GateSnapshotWriter();
+
+  typedef std::function<void()> Task;
+
+  // Queue the task of the given owner (usually the actor)
+  void Submit(const void * owner, Task task);
+
+  // Drop the queued tasks of the owner and wait for its running task, if
+  // any, to complete. Used before a synchronous save to the same files.
+  void Wait(const void * owner);
+
+protected:
+  GateSnapshotWriter();
+  void Run();
+
+  std::deque<std::pair<const void *, Task> > mTasks;
+  const void * mRunningOwner;
+  bool mIsStopped;
+  std::mutex mMutex;
+  std::condition_variable mTaskAvailable;
+  std::condition_variable mTaskDone;
+  std::thread mThread;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATESNAPSHOTWRITER_HH */
@@ -10,6 +10,7 @@
 #define GateToASCII_H
 
 #include "GateVOutputModule.hh"
+#include "GateBufferedFileWriter.hh"
 
 #ifdef G4ANALYSIS_USE_FILE
 
@@ -37,6 +38,7 @@ public:
   //! saves the Hits in the ASCII files, and calls RecordDigitizer
   void RecordEndOfEvent(const G4Event *);
   void RecordStepWithVolume(const GateVVolume * , const G4Step *);
+  G4bool IsRecordingSteps() const { return false; }
   //! saves the geometry voxel information
   void RecordVoxels(GateVGeometryVoxelStore *);
 
@@ -76,9 +78,8 @@ public:
       G4String          m_fileBaseName;
       G4String          m_collectionName;
       G4int             m_fileCounter;
-      long              m_outputFileBegin;
       G4int	        m_collectionID;
-      std::ofstream   m_outputFile;
+      GateBufferedFileWriter m_outputFile;
 
       static long       m_outputFileSizeLimit;
   };
@@ -145,7 +146,7 @@ private:
   GateToASCIIMessenger* m_asciiMessenger;
 
   std::ofstream m_outFileRun;
-  std::ofstream m_outFileHits;
+  GateBufferedFileWriter m_outFileHits;
 
   G4String m_fileName;
 
@@ -29,6 +29,7 @@
 #include "GateSingleDigi.hh"
 #include "GatePrimaryGeneratorAction.hh"
 #include "GateRunManager.hh"
+#include "GateBufferedFileWriter.hh"
 
 class GateToBinaryMessenger;
 
@@ -102,6 +103,7 @@ public:
 	 *	\brief Record the step with the volume
 	 */
   virtual void RecordStepWithVolume( GateVVolume const*, G4Step const* );
+  virtual G4bool IsRecordingSteps() const { return false; }
 
   /*!
 	 *	\fn virtual void RecordVoxels( GateVGeometryVoxelStore* voxelStore )
@@ -310,7 +312,7 @@ public:
 			G4String m_collectionName; /*!< Name of the collection */
 			G4int m_fileCounter; /*!< Count of the file */
 			G4int	m_collectionID; /*!< Collection ID */
-			std::ofstream m_outputFile; /*!< Output file */
+			GateBufferedFileWriter m_outputFile; /*!< Output file */
 			static G4int m_outputFileSizeLimit; /*!< Output file size limit */
   } VOutputChannel;
 
@@ -397,10 +399,49 @@ protected:
 	std::vector< VOutputChannel* > m_outputChannelVector; /*!< Vector of output channel */
 
 	std::ofstream m_outFileRun; /*!< outfile for run */
-  std::ofstream m_outFileHits; /*!< outfile for hits */
+  GateBufferedFileWriter m_outFileHits; /*!< outfile for hits */
+
+	/*!
+	 *	\struct HitRecordHead GateToBinary.hh
+	 *	\brief Fields of a hit record written before the volume ID
+	 */
+	struct HitRecordHead
+	{
+		G4int runID;
+		G4int eventID;
+		G4int primaryID;
+		G4int sourceID;
+	};
+
+	static size_t const kStringFieldWidth = 8; /*!< Size of the string fields */
+
+	/*!
+	 *	\struct HitRecordTail GateToBinary.hh
+	 *	\brief Fields of a hit record written after the volume ID
+	 */
+	struct HitRecordTail
+	{
+		G4double time;
+		G4double eDep;
+		G4double stepLength;
+		G4double posX;
+		G4double posY;
+		G4double posZ;
+		G4int PDGEncoding;
+		G4int trackID;
+		G4int parentID;
+		G4int photonID;
+		G4int phCompton;
+		G4int phRayleigh;
+		char processName[ kStringFieldWidth ];
+		char comptonVolumeName[ kStringFieldWidth ];
+		char rayleighVolumeName[ kStringFieldWidth ];
+	};
 
 private:
     static G4String FixedWidthZeroPaddedString(const G4String & full, size_t length);
+    static void CopyFixedWidthZeroPaddedString(const G4String & full,
+        char (&field)[ kStringFieldWidth ]);
 };
 
 #endif
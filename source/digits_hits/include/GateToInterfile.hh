@@ -50,6 +50,7 @@ public:
     void RecordStepWithVolume(const GateVVolume *, const G4Step *)
         {
         }
+    G4bool IsRecordingSteps() const { return false; }
 
     //! saves the geometry voxel information
     void RecordVoxels(GateVGeometryVoxelStore *)
@@ -54,6 +54,7 @@ public :
   void RecordStep(const G4Step *) {};          //!< This function doesn't do anything.
 	const G4String& GiveNameOfFile(){ return m_nameOfFile; };          //!< This function doesn't do anything.
 	void RecordStepWithVolume(const GateVVolume *, const G4Step *) {}; //!< This function doesn't do anything.
+	G4bool IsRecordingSteps() const { return false; }
 
   //! saves the geometry voxel information
   void RecordVoxels(GateVGeometryVoxelStore *) {};
@@ -46,6 +46,7 @@ public:
   void RecordBeginOfEvent(const G4Event *) {}
   void RecordEndOfEvent(const G4Event *) {}
   void RecordStepWithVolume(const GateVVolume *, const G4Step *) {}
+  G4bool IsRecordingSteps() const { return false; }
 
 
   //! saves the geometry voxel information
@@ -40,12 +40,14 @@ See LICENSE.md for further details
 
 #include "globals.hh"
 #include <fstream>
+#include <map>
 
 #include "G4Run.hh"
 #include "G4Step.hh"
 #include "G4Event.hh"
 
 #include "GateRootDefs.hh"
+#include "GateRootAsyncTreeWriter.hh"
 #include "GateVOutputModule.hh"
 
 /* PY Descourt 08/09/2009 */
@@ -85,6 +87,8 @@ public:
   void RecordBeginOfEvent(const G4Event *);
   void RecordEndOfEvent(const G4Event *);
   void RecordStepWithVolume(const GateVVolume * v, const G4Step *);
+  //! The step data are kept by the tracking thread until the end of its event
+  G4bool IsStepRecordingThreadLocal() const { return true; }
 
   //! saves the geometry voxel information
   void RecordVoxels(GateVGeometryVoxelStore *);
@@ -134,21 +138,29 @@ public:
       : nVerboseLevel(0),
 	m_outputFlag(outputFlag),
 	m_collectionName(aCollectionName),
-	m_collectionID(-1)
+	m_collectionID(-1),
+	m_treeWriter(0)
     { }
     virtual inline ~VOutputChannel() {}
 
     virtual void Clear() = 0;
     virtual void RecordDigitizer() = 0 ;
     virtual void Book() = 0;
+    //! The tree booked by Book (0 if the channel is not written)
+    virtual TTree* GetTree() = 0;
 
     inline void SetOutputFlag(G4bool flag) { m_outputFlag = flag; };
     inline void SetVerboseLevel(G4int val) { nVerboseLevel = val; };
+    //! Trees are filled through this writer when it is set
+    inline void SetTreeWriter(GateRootAsyncTreeWriter* writer) { m_treeWriter = writer; };
+    inline void FillTree(TTree* tree)
+    { if (m_treeWriter) m_treeWriter->Fill(tree); else tree->Fill(); };
 
     G4int             nVerboseLevel;
     G4bool            m_outputFlag;
     G4String          m_collectionName;
     G4int	      m_collectionID;
+    GateRootAsyncTreeWriter* m_treeWriter;
   };
 
 
@@ -172,6 +184,7 @@ public:
 	m_tree->Init(m_buffer);
       }
     }
+    inline TTree* GetTree() { return m_outputFlag ? m_tree : 0; }
 
     void RecordDigitizer();
 
@@ -201,6 +214,7 @@ public:
 	m_tree->Init(m_buffer);
       }
     }
+    inline TTree* GetTree() { return m_outputFlag ? m_tree : 0; }
 
     void RecordDigitizer();
 
@@ -224,6 +238,15 @@ public:
   G4bool GetRootOpticalFlag()                   { return m_rootOpticalFlag; };
   void   SetRootOpticalFlag(G4bool flag)        { m_rootOpticalFlag = flag; };
 
+  //! The entries of the trees are filled in the ROOT file by a
+  //! background thread (see GateRootAsyncTreeWriter)
+  G4bool GetAsynchronousWritingFlag()             { return m_asyncWritingFlag; };
+  void   SetAsynchronousWritingFlag(G4bool flag);
+  //! Compression level (0-9) of the branches of a tree (default: file compression)
+  void   SetTreeCompressionLevel(const G4String& treeName, G4int level) { m_treeCompressionLevel[treeName] = level; };
+  //! Size (bytes) of the baskets of the branches of a tree (default: ROOT default)
+  void   SetTreeBasketSize(const G4String& treeName, G4int size)        { m_treeBasketSize[treeName] = size; };
+
 
   //! Get the output file name
   const  G4String& GetFileName()             { return m_fileName; };
@@ -247,6 +270,13 @@ public:
 
 void  PrintRecStep();
 
+  //! Applies the compression level and basket size of the tree and
+  //! registers it to the asynchronous writer
+  void SetupTree(TTree* tree);
+  //! Fills the tree, directly or through the asynchronous writer
+  inline void FillTree(TTree* tree)
+  { if (m_asyncWritingFlag) m_treeWriter.Fill(tree); else tree->Fill(); };
+
   void SetVerboseLevel(G4int val)
   {
     GateVOutputModule::SetVerboseLevel(val);
@@ -256,6 +286,10 @@ void  PrintRecStep();
 
 private:
 
+  //! Copies the per-event step data to the tracking thread buffer, and back
+  void LoadStepRecord();
+  void StoreStepRecord();
+
   G4ThreeVector  m_ionDecayPos;
   G4ThreeVector  m_positronGenerationPos;
   G4ThreeVector  m_positronAnnihilPos;
@@ -304,6 +338,11 @@ private:
   G4bool   m_rootNtupleFlag;
   G4bool   m_saveRndmFlag;
   G4bool   m_rootOpticalFlag;
+  G4bool   m_asyncWritingFlag;
+
+  std::map<G4String,G4int> m_treeCompressionLevel;
+  std::map<G4String,G4int> m_treeBasketSize;
+  GateRootAsyncTreeWriter  m_treeWriter;
 
   G4String m_fileName;
 
@@ -58,6 +58,9 @@ class GateToRootMessenger: public GateOutputModuleMessenger
     G4UIcmdWithABool*        RootRecordCmd;
     G4UIcmdWithABool*        SaveRndmCmd;
     G4UIcmdWithAString*      SetFileNameCmd;
+    G4UIcmdWithABool*        AsyncWritingCmd;
+    G4UIcommand*             TreeCompressionLevelCmd;
+    G4UIcommand*             TreeBasketSizeCmd;
 
     G4UIcommand*      CoincidenceMaskCmd;
 	G4int m_coincidenceMaskLength;
@@ -42,6 +42,7 @@ public:
   void RecordEndOfEvent(const G4Event *);
   //! Nothing to do for steps
   void RecordStepWithVolume(const GateVVolume *, const G4Step *) {}
+  G4bool IsRecordingSteps() const { return false; }
   //! Nothing to do
   void RecordVoxels(GateVGeometryVoxelStore *) {};
 
@@ -60,6 +60,10 @@ class GateUpholder : public GateVPulseProcessor
     //! The result of the pulse-processing is incorporated into the output pulse-list
     void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList);
 
+    //! Batch version of ProcessOnePulse(): pulses are discarded by a single loop over the energies
+    virtual G4bool IsBatchProcessor() const { return true; }
+    void ProcessPulseBatch(GatePulseBatch& batch);
+
   private:
     G4double m_uphold;     	      	      //!< Uphold value
     GateUpholderMessenger *m_messenger;       //!< Messenger
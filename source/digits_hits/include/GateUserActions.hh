@@ -51,13 +51,13 @@ class G4SliceTimer;
 class GateUserActions
 {
 public:
-  GateUserActions(GateRunManager* m, GateRecorderBase* r);
+  GateUserActions(G4RunManager* m, GateRecorderBase* r);
   ~GateUserActions();
 
   //-----------------------------------------------------------------------------
   /// \brief Sets the RunManager used
   /// *** MUST *** be called before simulation starts
-  void SetRunManager(GateRunManager* m) { pRunManager = m; }
+  void SetRunManager(G4RunManager* m) { pRunManager = m; }
   //-----------------------------------------------------------------------------
 
   //-----------------------------------------------------------------------------
@@ -102,8 +102,9 @@ public:
 protected:
 
   //-----------------------------------------------------------------------------
-  /// Pointer on the GateRunmanager
-  GateRunManager* pRunManager;
+  /// Pointer on the GateRunmanager (the worker run manager of the
+  /// current thread in multithreaded mode)
+  G4RunManager* pRunManager;
   //-----------------------------------------------------------------------------
 
   //-----------------------------------------------------------------------------
@@ -126,7 +127,7 @@ protected:
   long int mStepNumberInCurrentTrack;
   //-----------------------------------------------------------------------------
 
-  static GateUserActions* pUserActions;
+  static G4ThreadLocal GateUserActions* pUserActions;
 
   GateRecorderBase* recorder;
   GateRunAction* runAction;
@@ -32,6 +32,7 @@
 #include "GateFilterManager.hh"
 #include "GateObjectStore.hh"
 #include "GateVVolume.hh"
+#include "GateProfiler.hh"
 #include "G4VPrimitiveScorer.hh"
 #include "G4THitsMap.hh"
 #include "G4TouchableHistory.hh"
@@ -100,6 +101,16 @@ public:
   bool IsUserSteppingActionEnabled() const     { return mIsUserSteppingActionEnabled; }
   //-----------------------------------------------------------------------------
 
+  //-----------------------------------------------------------------------------
+  // Profiling (see GateProfiler): one section per callback, -1 when the
+  // callbacks are not timed. Created by the actor manager.
+  enum ProfiledCallback { kBeginOfRunAction, kEndOfRunAction, kBeginOfEventAction, kEndOfEventAction,
+                          kPreUserTrackingAction, kPostUserTrackingAction, kUserSteppingAction,
+                          kNumberOfProfiledCallbacks };
+  void CreateProfilerSections();
+  int GetProfilerSection(ProfiledCallback c) const { return mProfilerSections[c]; }
+  //-----------------------------------------------------------------------------
+
   //-----------------------------------------------------------------------------
   void SetSaveFilename(G4String  f);
   G4String GetSaveFilename() { return mSaveFilename; }
@@ -107,10 +118,35 @@ public:
   virtual void ResetData() = 0;
   void EnableSaveEveryNEvents(int n) { mSaveEveryNEvents = n; }
   void EnableSaveEveryNSeconds(int n) { mSaveEveryNSeconds = n; }
+  // Intermediate saves (every n events/seconds) may copy the data and leave
+  // the computation and writing of the outputs to the GateSnapshotWriter
+  // thread. Actors supporting it overload SaveDataAsync; by default the
+  // save is synchronous. The end of run save is always synchronous.
+  void EnableAsyncSave(bool b) { mIsAsyncSaveEnabled = b; }
+  virtual void SaveDataAsync() { SaveData(); }
+  // Intermediate save. A worker copy first merges its data into the master
+  // actor, which saves them.
+  void SaveIntermediateData();
   void SetOverWriteFilesFlag(bool b) { mOverWriteFilesFlag = b; }
   void EnableResetDataAtEachRun(bool b) { mResetDataAtEachRun = b; }
   //-----------------------------------------------------------------------------
 
+  //-----------------------------------------------------------------------------
+  // Multithreading: each worker thread has its own copy of the actors, linked
+  // to the actor of the master thread. At the end of each run, the data of
+  // the worker copy are merged into the master actor, which saves them.
+  // Actors which are not mergeable are shared by all the threads. Their
+  // callbacks are serialized, unless the actor is thread safe.
+  virtual bool IsMergeable() const { return false; }
+  virtual bool IsThreadSafe() const { return false; }
+  virtual void MergeWorkerData(GateVActor * /*worker*/) {}
+  void SetMasterActor(GateVActor * actor) { pMasterActor = actor; }
+  GateVActor * GetMasterActor() const { return pMasterActor; }
+  bool IsWorkerActor() const { return pMasterActor != 0; }
+  void SetSharedBetweenThreads(bool b) { mIsSharedBetweenThreads = b; }
+  bool IsSharedBetweenThreads() const { return mIsSharedBetweenThreads; }
+  //-----------------------------------------------------------------------------
+
   G4String GetVolumeName(){return mVolumeName;}
   GateVVolume * GetVolume(){return mVolume;}
   void SetVolumeName(G4String name){mVolumeName = name;}
@@ -126,10 +162,17 @@ protected:
 
   GateFilterManager * pFilterManager;
 
-  virtual G4bool ProcessHits(G4Step * step, G4TouchableHistory *) { UserSteppingAction(0, step); return true; }
+  virtual G4bool ProcessHits(G4Step * step, G4TouchableHistory *) {
+    GateProfilerScope scope(mProfilerSections[kUserSteppingAction]);
+    UserSteppingAction(0, step);
+    return true;
+  }
 
   G4int mNumOfFilters;
 
+  GateVActor * pMasterActor;
+  bool mIsSharedBetweenThreads;
+
   //-----------------------------------------------------------------------------
   bool mIsBeginOfRunActionEnabled;
   bool mIsEndOfRunActionEnabled;
@@ -138,11 +181,13 @@ protected:
   bool mIsPreUserTrackingActionEnabled;
   bool mIsPostUserTrackingActionEnabled;
   bool mIsUserSteppingActionEnabled;
+  int  mProfilerSections[kNumberOfProfiledCallbacks];
   //-----------------------------------------------------------------------------
 
   //-----------------------------------------------------------------------------
   int  mSaveEveryNEvents;
   int  mSaveEveryNSeconds;
+  bool mIsAsyncSaveEnabled;
   bool mOverWriteFilesFlag;
   bool mResetDataAtEachRun;
   G4String mSaveInitialFilename;
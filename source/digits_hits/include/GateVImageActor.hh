@@ -105,6 +105,7 @@ protected:
 
   int GetIndexFromTrackPosition(const GateVVolume *, const G4Track * track);
   int GetIndexFromStepPosition(const GateVVolume *, const G4Step  * step);
+  int GetIndexFromStepPosition(const GateVVolume *, const G4Step  * step, StepHitType hitType);
 
 }; // end class GateVImageActor
 
@@ -48,6 +48,12 @@ public:
 
   virtual void RecordTracks(GateSteppingAction*){} /* PY Descourt 08/09/2009 */
 
+  //! Returns false if RecordStepWithVolume() does nothing: the output manager then skips it at each step
+  virtual G4bool IsRecordingSteps() const { return true; }
+  //! Returns true if RecordStepWithVolume() only fills data of the calling thread,
+  //! so that the output manager does not have to serialize it in MT
+  virtual G4bool IsStepRecordingThreadLocal() const { return false; }
+
   virtual void SetVerboseLevel(G4int val) { nVerboseLevel = val; }
 
 /*
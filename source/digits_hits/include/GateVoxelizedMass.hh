@@ -58,16 +58,35 @@ class GateVoxelizedMass
 
   void    SetExternalMassImage(G4String);
 
+  // Directory where the dosel masses are stored, keyed by a hash of the
+  // geometry, so that later runs on the same geometry skip their calculation
+  void    SetMassCacheDirectory(G4String dir) { mMassCacheDirectory = dir; }
+
  protected:
 
   bool IsLVParameterized(const G4LogicalVolume*);
 
+  bool IsAxisAlignedBoxTree(const G4VPhysicalVolume*);
+  void BuildBoxTree(const G4VPhysicalVolume*);
+
   void GenerateVectors();
   void GenerateVoxels();
-  void GenerateDosels(int index);
+  void GenerateDosels(int index, double doselMin[3], double doselMax[3]);
+  void GenerateLabelTables();
+
+  // Thread-safe dosel computation (parameterised volume or axis-aligned boxes)
+  std::pair<double,double> ComputeDosel(int index);
+  void ComputeDoselRange(long int first, long int last, double & totalMass, double & totalCubicVolume);
 
   std::pair<double,double> ParameterizedVolume(int index);
   std::pair<double,double> VoxelIteration(const G4VPhysicalVolume*,int, G4RotationMatrix, G4ThreeVector,int index);
+  std::pair<double,double> BoxIteration(const G4VPhysicalVolume*, G4ThreeVector, const G4ThreeVector & doselMin, const G4ThreeVector & doselMax, int index, int & slot);
+
+  unsigned long long ComputeGeometryHash();
+  void HashVolume(unsigned long long & hash, const G4VPhysicalVolume*);
+  G4String GetMassCacheFileName(unsigned long long hash);
+  bool ReadMassCache(unsigned long long hash);
+  void WriteMassCache(unsigned long long hash);
 
   GateVImageVolume* imageVolume;
   const G4VPhysicalVolume* DAPV;
@@ -87,12 +106,19 @@ class GateVoxelizedMass
   std::vector<std::vector<std::pair<G4String,double> > > mMass;
   std::vector<std::vector<std::pair<G4String,double> > > mEdep;
 
+  // Boxes of the axis-aligned box tree in pre-order (their slots in
+  // mCubicVolume and mMass) and size of the subtree of each box
+  std::vector<std::pair<G4String,double> > mBoxTree;
+  std::vector<int> mBoxTreeSizes;
+
   //std::vector<double> doselReconstructedCubicVolume;
   std::vector<double> doselReconstructedMass;
-  std::vector<double> doselMin;
-  std::vector<double> doselMax;
   std::vector<double> doselExternalMass;
 
+  // Per-label density and material filter result of the parameterised volume
+  std::vector<double> mLabelDensity;
+  std::vector<char>   mLabelIsSelected;
+
   double voxelCubicVolume;
   double mFilteredVolumeMass;
   double mFilteredVolumeCubicVolume;
@@ -104,6 +130,7 @@ class GateVoxelizedMass
   G4String mMassFile;
   G4String mMaterialFilter;
   G4String mVolumeFilter;
+  G4String mMassCacheDirectory;
 
   bool mIsInitialized;
   bool mIsParameterised;
@@ -112,6 +139,7 @@ class GateVoxelizedMass
   bool mHasFilter;
   bool mHasExternalMassImage;
   bool mHasSameResolution;
+  bool mIsAxisAlignedBoxTree;
 
   int seconds;
 };
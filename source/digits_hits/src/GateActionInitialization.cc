@@ -0,0 +1,63 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+#include "GateActionInitialization.hh"
+#include "GateUserActions.hh"
+#include "GatePrimaryGeneratorAction.hh"
+#include "GateSteppingVerbose.hh"
+#include "GateActorManager.hh"
+#include "GateMessageManager.hh"
+
+#include "G4RunManager.hh"
+
+//-----------------------------------------------------------------------------
+GateActionInitialization::GateActionInitialization(GateRecorderBase * r)
+  : G4VUserActionInitialization(), pRecorder(r)
+{
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateActionInitialization::~GateActionInitialization()
+{
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateActionInitialization::BuildForMaster() const
+{
+  GateMessage("Core", 4, "GateActionInitialization -- BuildForMaster\n");
+  new GateUserActions(G4RunManager::GetRunManager(), pRecorder);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateActionInitialization::Build() const
+{
+  GateMessage("Core", 4, "GateActionInitialization -- Build (worker)\n");
+  // The basic ROOT output is not thread safe, it is only recorded by
+  // the master.
+  new GateUserActions(G4RunManager::GetRunManager(), 0);
+  SetUserAction(new GatePrimaryGeneratorAction());
+  // The actor manager of the thread must exist before the /gate/actor
+  // commands of the master are replayed on the worker
+  GateActorManager::GetInstance();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4VSteppingVerbose * GateActionInitialization::InitializeSteppingVerbose() const
+{
+  return new GateSteppingVerbose;
+}
+//-----------------------------------------------------------------------------
@@ -49,9 +49,12 @@
 
 #include "GateSteppingActionMessenger.hh"
 #include "GateCrystalSD.hh"
+#ifdef GATE_USE_MT
+#include "G4Threading.hh"
+#endif
 
-GateRunAction* GateRunAction::prunAction=0;
-GateEventAction* GateEventAction::peventAction=0;
+G4ThreadLocal GateRunAction* GateRunAction::prunAction=0;
+G4ThreadLocal GateEventAction* GateEventAction::peventAction=0;
 
 //-----------------------------------------------------------------------------
 GateRunAction::GateRunAction(GateUserActions * cbm, GateRecorderBase* r)
@@ -77,7 +80,12 @@ void GateRunAction::BeginOfRunAction(const G4Run* aRun)
 
 #ifdef G4ANALYSIS_USE_GENERAL
   // Here we fill the histograms of the Analysis manager
-  if(GateApplicationMgr::GetInstance()->GetOutputMode()){
+  // The output modules are shared: only the master records the runs
+  if(GateApplicationMgr::GetInstance()->GetOutputMode()
+#ifdef GATE_USE_MT
+     && !G4Threading::IsWorkerThread()
+#endif
+     ){
     GateOutputMgr* outputMgr = GateOutputMgr::GetInstance();
     outputMgr->RecordBeginOfRun(aRun);
   }
@@ -101,7 +109,12 @@ inline void GateRunAction::EndOfRunAction(const G4Run* aRun)
 
 #ifdef G4ANALYSIS_USE_GENERAL
   // Here we fill the histograms of the Analysis manager
-  if(GateApplicationMgr::GetInstance()->GetOutputMode()){
+  // The output modules are shared: only the master records the runs
+  if(GateApplicationMgr::GetInstance()->GetOutputMode()
+#ifdef GATE_USE_MT
+     && !G4Threading::IsWorkerThread()
+#endif
+     ){
     GateOutputMgr* outputMgr = GateOutputMgr::GetInstance();
     outputMgr->RecordEndOfRun(aRun);
   }
@@ -125,7 +138,7 @@ inline void GateEventAction::BeginOfEventAction(const G4Event* anEvent)
 {
   GateMessage("Core", 2, "Begin Of Event " << anEvent->GetEventID() << "\n");
 
-  TrackingMode theMode =( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) )->GetMode();
+  TrackingMode theMode =( (GateSteppingAction *)(G4RunManager::GetRunManager()->GetUserSteppingAction() ) )->GetMode();
   if ( theMode != kTracker )
     {
       if (GetFlagBasicOutput()){
@@ -166,7 +179,7 @@ inline void GateEventAction::EndOfEventAction(const G4Event* anEvent)
 
   /* PY Descourt 08/09/2009 */
 
-  GateSteppingAction* myAction = ( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) );
+  GateSteppingAction* myAction = ( (GateSteppingAction *)(G4RunManager::GetRunManager()->GetUserSteppingAction() ) );
   TrackingMode theMode = myAction->GetMode();
 
   if ( theMode == kTracker )
@@ -223,7 +236,7 @@ void GateTrackingAction::PreUserTrackingAction(const G4Track* a)
 
   /* PY Descourt 08/09/2009 */
 
-  GateSteppingAction*  myAction = (GateSteppingAction *) (GateRunManager::GetRunManager()->GetUserSteppingAction()) ;
+  GateSteppingAction*  myAction = (GateSteppingAction *) (G4RunManager::GetRunManager()->GetUserSteppingAction()) ;
 
   TrackingMode theMode = myAction->GetMode();
 
@@ -311,7 +324,7 @@ void GateTrackingAction::PostUserTrackingAction(const G4Track* aTrack)
       dummy_step_vector.clear();
     }
 
-  GateSteppingAction*  myAction = (GateSteppingAction *) (GateRunManager::GetRunManager()->GetUserSteppingAction()) ;
+  GateSteppingAction*  myAction = (GateSteppingAction *) (G4RunManager::GetRunManager()->GetUserSteppingAction()) ;
   TrackingMode theMode = myAction->GetMode();
   if ( theMode == kDetector )
     {
@@ -520,7 +533,6 @@ GateSteppingAction::GateSteppingAction(GateUserActions * cbm, GateRecorderBase*
   m_verboseLevel = 0;
   /* PY Descourt Tracker/Detector 18/12/2008 */
   m_steppingMessenger = new GateSteppingActionMessenger(this);
-  TheMode = kBoth;
   Boundary = 1;
   fStpAKill = fStopAndKill;
   fKeepOnlyP = 0;
@@ -594,6 +606,8 @@ void GateSteppingAction::StopAndKill(G4String aString )
 
 
 }
+std::atomic<TrackingMode> GateSteppingAction::TheMode(kBoth);
+
 void GateSteppingAction::SetMode( TrackingMode aMode)
 {
   TheMode = aMode;
@@ -1026,7 +1040,7 @@ void GateSteppingAction::UserSteppingAction(const GateVVolume *v, const G4Step*
   G4bool drawTrj = false;
   if (m_drawTrjLevel == 0) {
   } else if (m_drawTrjLevel == 1) {
-    G4int currentEvent = GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+    G4int currentEvent = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
     if (currentEvent <= 10) {
       drawTrj = true;
     }
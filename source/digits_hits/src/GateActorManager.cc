@@ -14,6 +14,25 @@
 #include "GateVActor.hh"
 #include "GateMultiSensitiveDetector.hh"
 
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+#endif
+
+namespace {
+#ifdef GATE_USE_MT
+  G4Mutex sharedActorMutex = G4MUTEX_INITIALIZER;
+  G4Mutex mergeActorMutex = G4MUTEX_INITIALIZER;
+  // Actors shared by the worker threads are called by one thread at a time,
+  // unless they are thread safe
+  inline bool MustBeSerialized(GateVActor * actor) { return actor->IsSharedBetweenThreads() && !actor->IsThreadSafe(); }
+  inline void LockIfShared(GateVActor * actor) { if (MustBeSerialized(actor)) G4MUTEXLOCK(&sharedActorMutex); }
+  inline void UnlockIfShared(GateVActor * actor) { if (MustBeSerialized(actor)) G4MUTEXUNLOCK(&sharedActorMutex); }
+#else
+  inline void LockIfShared(GateVActor *) {}
+  inline void UnlockIfShared(GateVActor *) {}
+#endif
+}
+
 //-----------------------------------------------------------------------------
 GateActorManager::GateActorManager()
 {
@@ -65,8 +84,11 @@ bool GateActorManager::GetResetAfterSaving() const
 void GateActorManager::AddActor(G4String actorType, G4String actorName, int depth)
 {
   GateDebugMessageInc("Actor",5,"Actor Manager -- AddActor(): "<<actorName<<" -- begin\n");
-  if (GateActorManager::theListOfActorPrototypes[actorType])
-    theListOfActors.push_back(GateActorManager::theListOfActorPrototypes[actorType](actorName,depth));
+  // The prototypes are registered (at load time) in the master manager only
+  std::map<G4String,maker_actor> & prototypes = GetMasterInstance()->theListOfActorPrototypes;
+  std::map<G4String,maker_actor>::const_iterator it = prototypes.find(actorType);
+  if (it != prototypes.end() && it->second)
+    theListOfActors.push_back(it->second(actorName,depth));
   else GateWarning("Actor type: "<<actorType<<" does not exist!");
   GateDebugMessageDec("Actor",5,"Actor Manager -- AddActor(): "<<actorName<<" -- end\n\n");
 }
@@ -86,14 +108,26 @@ GateVActor*  GateActorManager::GetActor(const G4String &actorType, const G4Strin
 //-----------------------------------------------------------------------------
 void GateActorManager::CreateListsOfEnabledActors()
 {
+  // On a worker thread, the actors shared with the master are already
+  // constructed and their run callbacks are called by the master only
+  bool isWorker = false;
+#ifdef GATE_USE_MT
+  isWorker = IsWorkerInstance();
+  if (isWorker && IsInitialized==0) LinkWorkerActorsToMaster();
+#endif
+
   std::vector<GateVActor*>::iterator sit;
   for (sit= theListOfActors.begin(); sit!=theListOfActors.end(); ++sit) {
     //if ((*sit)->GetObjectName() == "output") (*sit) = GateOutputMgr::GetInstance();
     //GateMessage("Core", 0, "Actor = " << (*sit)->GetObjectName() << Gateendl);
 
-    (*sit)->Construct();
-    if ((*sit)->IsBeginOfRunActionEnabled()       && IsInitialized<2) theListOfActorsEnabledForBeginOfRun.push_back( (*sit) );
-    if ((*sit)->IsEndOfRunActionEnabled()         && IsInitialized<2) theListOfActorsEnabledForEndOfRun.push_back( (*sit) );
+    bool sharedCopy = isWorker && (*sit)->IsSharedBetweenThreads();
+    if (!sharedCopy) (*sit)->Construct();
+    // Names of the filters resolved before the workers use them
+    if (!sharedCopy) (*sit)->GetFilterManager()->Initialize();
+    if (!sharedCopy && GateProfiler::IsEnabled()) (*sit)->CreateProfilerSections();
+    if ((*sit)->IsBeginOfRunActionEnabled()       && IsInitialized<2 && !sharedCopy) theListOfActorsEnabledForBeginOfRun.push_back( (*sit) );
+    if ((*sit)->IsEndOfRunActionEnabled()         && IsInitialized<2 && !sharedCopy) theListOfActorsEnabledForEndOfRun.push_back( (*sit) );
     if ((*sit)->IsBeginOfEventActionEnabled()     && IsInitialized<2) theListOfActorsEnabledForBeginOfEvent.push_back( (*sit) );
     if ((*sit)->IsEndOfEventActionEnabled()       && IsInitialized<2) theListOfActorsEnabledForEndOfEvent.push_back( (*sit) );
     if ((*sit)->IsPreUserTrackingActionEnabled()  && IsInitialized<2) theListOfActorsEnabledForPreUserTrackingAction.push_back( (*sit) );
@@ -115,6 +149,69 @@ void GateActorManager::CreateListsOfEnabledActors()
 }
 //-----------------------------------------------------------------------------
 
+#ifdef GATE_USE_MT
+//-----------------------------------------------------------------------------
+G4Mutex * GateActorManager::GetSharedActorMutex()
+{
+  return &sharedActorMutex;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+G4Mutex * GateActorManager::GetMergeActorMutex()
+{
+  return &mergeActorMutex;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Link each actor of this worker thread to the actor of the same name in
+// the master thread. Thread-safe actors, and actors which cannot merge
+// their data, are replaced by the master actor itself, shared by all the
+// threads.
+void GateActorManager::LinkWorkerActorsToMaster()
+{
+  GateActorManager * master = GetMasterInstance();
+  for (size_t i=0; i<theListOfActors.size(); i++) {
+    GateVActor * actor = theListOfActors[i];
+    GateVActor * masterActor = master->GetActor(actor->GetTypeName(), actor->GetName());
+    if (masterActor == NULL)
+      GateError("Actor " << actor->GetName() << " of a worker thread has no counterpart in the master thread!");
+    if (actor->IsThreadSafe()) {
+      masterActor->SetSharedBetweenThreads(true);
+      theListOfActors[i] = masterActor;
+    }
+    else if (actor->IsMergeable()) {
+      actor->SetMasterActor(masterActor);
+    }
+    else {
+      GateWarning("Actor " << actor->GetName() << " (" << actor->GetTypeName()
+                  << ") cannot merge the data of the worker threads: it is shared by all the threads and its callbacks are serialized.");
+      masterActor->SetSharedBetweenThreads(true);
+      // The worker copy is not deleted: it has never been constructed
+      theListOfActors[i] = masterActor;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Called at the end of each run of a worker thread: the data of the worker
+// actors are added to the master actors (which save them at the end of the
+// master run) and the worker copies are reset for the next run.
+void GateActorManager::MergeWorkerActorsIntoMaster()
+{
+  G4AutoLock lock(&mergeActorMutex);
+  std::vector<GateVActor*>::iterator sit;
+  for (sit = theListOfActors.begin(); sit!=theListOfActors.end(); ++sit) {
+    if (!(*sit)->IsWorkerActor()) continue;
+    (*sit)->GetMasterActor()->MergeWorkerData(*sit);
+    (*sit)->ResetData();
+  }
+}
+//-----------------------------------------------------------------------------
+#endif
+
 //-----------------------------------------------------------------------------
 void GateActorManager::PrintListOfActorTypes() const
 {
@@ -147,11 +244,19 @@ std::vector<GateVActor*> GateActorManager::ReturnListOfActors()
 //-----------------------------------------------------------------------------
 void GateActorManager::BeginOfRunAction(const G4Run* run)
 {
+#ifdef GATE_USE_MT
+  // Worker actors are created by the commands replayed on the thread: they
+  // are constructed at the beginning of the first run
+  if (IsWorkerInstance() && IsInitialized==0) CreateListsOfEnabledActors();
+#endif
+
   std::vector<GateVActor*>::iterator sit;
 
   //GateMessage("Core", 0, "Run " << run->GetRunID() << " is starting.\n");
-  for (sit = theListOfActorsEnabledForBeginOfRun.begin(); sit!=theListOfActorsEnabledForBeginOfRun.end(); ++sit)
+  for (sit = theListOfActorsEnabledForBeginOfRun.begin(); sit!=theListOfActorsEnabledForBeginOfRun.end(); ++sit) {
+    GateProfilerScope scope((*sit)->GetProfilerSection(GateVActor::kBeginOfRunAction));
     (*sit)->BeginOfRunAction(run);
+  }
 
 }
 //-----------------------------------------------------------------------------
@@ -159,9 +264,17 @@ void GateActorManager::BeginOfRunAction(const G4Run* run)
 //-----------------------------------------------------------------------------
 void GateActorManager::EndOfRunAction(const G4Run* run)
 {
+#ifdef GATE_USE_MT
+  if (IsWorkerInstance()) {
+    MergeWorkerActorsIntoMaster();
+    return;
+  }
+#endif
   std::vector<GateVActor*>::iterator sit;
-  for (sit = theListOfActorsEnabledForEndOfRun.begin(); sit!=theListOfActorsEnabledForEndOfRun.end(); ++sit)
+  for (sit = theListOfActorsEnabledForEndOfRun.begin(); sit!=theListOfActorsEnabledForEndOfRun.end(); ++sit) {
+    GateProfilerScope scope((*sit)->GetProfilerSection(GateVActor::kEndOfRunAction));
     (*sit)->EndOfRunAction(run);
+  }
   //GateMessage("Core", 0, "Run " << run->GetRunID() << " is ending.\n");
 }
 //-----------------------------------------------------------------------------
@@ -171,8 +284,14 @@ void GateActorManager::BeginOfEventAction(const G4Event* evt)
 {
   if (evt) mCurrentEventId = evt->GetEventID();
   std::vector<GateVActor*>::iterator sit;
-  for (sit = theListOfActorsEnabledForBeginOfEvent.begin(); sit!=theListOfActorsEnabledForBeginOfEvent.end(); ++sit)
-    (*sit)->BeginOfEventAction(evt);
+  for (sit = theListOfActorsEnabledForBeginOfEvent.begin(); sit!=theListOfActorsEnabledForBeginOfEvent.end(); ++sit) {
+    LockIfShared(*sit);
+    {
+      GateProfilerScope scope((*sit)->GetProfilerSection(GateVActor::kBeginOfEventAction));
+      (*sit)->BeginOfEventAction(evt);
+    }
+    UnlockIfShared(*sit);
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -180,8 +299,14 @@ void GateActorManager::BeginOfEventAction(const G4Event* evt)
 void GateActorManager::EndOfEventAction(const G4Event* evt)
 {
   std::vector<GateVActor*>::iterator sit;
-  for (sit = theListOfActorsEnabledForEndOfEvent.begin(); sit!=theListOfActorsEnabledForEndOfEvent.end(); ++sit)
-    (*sit)->EndOfEventAction(evt);
+  for (sit = theListOfActorsEnabledForEndOfEvent.begin(); sit!=theListOfActorsEnabledForEndOfEvent.end(); ++sit) {
+    LockIfShared(*sit);
+    {
+      GateProfilerScope scope((*sit)->GetProfilerSection(GateVActor::kEndOfEventAction));
+      (*sit)->EndOfEventAction(evt);
+    }
+    UnlockIfShared(*sit);
+  }
 }
 //-----------------------------------------------------------------------------
 
@@ -193,9 +318,12 @@ void GateActorManager::PreUserTrackingAction(const G4Track* track)
   std::vector<GateVActor*>::iterator sit;
   for (sit = theListOfActorsEnabledForPreUserTrackingAction.begin(); sit!=theListOfActorsEnabledForPreUserTrackingAction.end(); ++sit)
     {
-      if ((*sit)->GetNumberOfFilters()!=0)
-        if (!(*sit)->GetFilterManager()->Accept(track) ) continue;
-      (*sit)->PreUserTrackingAction(0,track);
+      LockIfShared(*sit);
+      if ((*sit)->GetNumberOfFilters()==0 || (*sit)->GetFilterManager()->Accept(track)) {
+        GateProfilerScope scope((*sit)->GetProfilerSection(GateVActor::kPreUserTrackingAction));
+        (*sit)->PreUserTrackingAction(0,track);
+      }
+      UnlockIfShared(*sit);
     }
 }
 //-----------------------------------------------------------------------------
@@ -206,9 +334,12 @@ void GateActorManager::PostUserTrackingAction(const G4Track* track)
   std::vector<GateVActor*>::iterator sit;
   for (sit = theListOfActorsEnabledForPostUserTrackingAction.begin(); sit!=theListOfActorsEnabledForPostUserTrackingAction.end(); ++sit)
     {
-      if ((*sit)->GetNumberOfFilters()!=0)
-        if (!(*sit)->GetFilterManager()->Accept(track) ) continue;
-      (*sit)->PostUserTrackingAction(0,track);
+      LockIfShared(*sit);
+      if ((*sit)->GetNumberOfFilters()==0 || (*sit)->GetFilterManager()->Accept(track)) {
+        GateProfilerScope scope((*sit)->GetProfilerSection(GateVActor::kPostUserTrackingAction));
+        (*sit)->PostUserTrackingAction(0,track);
+      }
+      UnlockIfShared(*sit);
     }
 }
 //-----------------------------------------------------------------------------
@@ -221,10 +352,12 @@ void GateActorManager::UserSteppingAction(const G4Step* step)
   for (sit = theListOfActorsEnabledForUserSteppingAction.begin(); sit!=theListOfActorsEnabledForUserSteppingAction.end(); ++sit)
     {
       // GateDebugMessage("Actor", 1, "Step for " << (*sit)->GetObjectName());
-      if ((*sit)->GetNumberOfFilters()!=0){
-        if (!(*sit)->GetFilterManager()->Accept(step) ) continue;
+      LockIfShared(*sit);
+      if ((*sit)->GetNumberOfFilters()==0 || (*sit)->GetFilterManager()->Accept(step)) {
+        GateProfilerScope scope((*sit)->GetProfilerSection(GateVActor::kUserSteppingAction));
+        (*sit)->UserSteppingAction(0, step);
       }
-      (*sit)->UserSteppingAction(0, step);
+      UnlockIfShared(*sit);
     }
 }
 //-----------------------------------------------------------------------------
@@ -307,9 +440,11 @@ G4bool GateActorManager::AddFilter(G4String filterType, G4String actorName )
 
   if (nActor==-1) GateError("Actor "<<actorName<<" not found!");
 
-  if (GateActorManager::theListOfFilterPrototypes[filterType])
+  std::map<G4String,maker_filter> & prototypes = GetMasterInstance()->theListOfFilterPrototypes;
+  std::map<G4String,maker_filter>::const_iterator it = prototypes.find(filterType);
+  if (it != prototypes.end() && it->second)
     {
-      theListOfActors[nActor]->GetFilterManager()->AddFilter(GateActorManager::theListOfFilterPrototypes[filterType]("/gate/actor/"+theListOfActors[nActor]->GetObjectName()+"/"+filterType));
+      theListOfActors[nActor]->GetFilterManager()->AddFilter(it->second("/gate/actor/"+theListOfActors[nActor]->GetObjectName()+"/"+filterType));
       theListOfActors[nActor]->IncNumberOfFilters();
     }
   else
@@ -324,5 +459,8 @@ G4bool GateActorManager::AddFilter(G4String filterType, G4String actorName )
 //-----------------------------------------------------------------------------
 
 GateActorManager *GateActorManager::singleton_ActorManager = 0;
+#ifdef GATE_USE_MT
+G4ThreadLocal GateActorManager *GateActorManager::singleton_WorkerActorManager = 0;
+#endif
 
 #endif /* end #define GATEACTORMANAGER_CC */
@@ -39,6 +39,7 @@ GateActorMessenger::~GateActorMessenger()
   delete pSaveEveryNSecondsCmd;
   delete pAddFilterCmd;
   delete pSetOverWriteFilesFlagCmd;
+  delete pEnableAsyncSaveCmd;
 }
 //-----------------------------------------------------------------------------
 
@@ -83,6 +84,11 @@ void GateActorMessenger::BuildCommands(G4String base)
   pSaveEveryNSecondsCmd->SetGuidance(guidance);
   pSaveEveryNSecondsCmd->SetParameterName("Number of seconds between next save",false);
 
+  bb = base+"/enableAsyncSave";
+  pEnableAsyncSaveCmd = new G4UIcmdWithABool(bb, this);
+  guidance = G4String("If true, the saves every n events/seconds copy the data and write the outputs in a background thread (only for the actors supporting it).");
+  pEnableAsyncSaveCmd->SetGuidance(guidance);
+
   bb = base+"/addFilter";
   pAddFilterCmd = new G4UIcmdWithAString(bb,this);
   guidance = "Add a new filter";
@@ -112,6 +118,9 @@ void GateActorMessenger::SetNewValue(G4UIcommand* command, G4String param)
   if (command == pSetOverWriteFilesFlagCmd)
     pActor->SetOverWriteFilesFlag(pSetOverWriteFilesFlagCmd->GetNewBoolValue(param));
 
+  if (command == pEnableAsyncSaveCmd)
+    pActor->EnableAsyncSave(pEnableAsyncSaveCmd->GetNewBoolValue(param));
+
   if (command == pSetResetDataAtEachRunFlagCmd)
     pActor->EnableResetDataAtEachRun(pSetResetDataAtEachRunFlagCmd->GetNewBoolValue(param));
 
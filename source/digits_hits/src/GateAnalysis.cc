@@ -317,7 +317,7 @@ void GateAnalysis::RecordEndOfEvent(const G4Event* event)
                 }
             } // end loop NpHits
 
-          TrackingMode theMode =( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) )->GetMode();
+          TrackingMode theMode =( (GateSteppingAction *)(G4RunManager::GetRunManager()->GetUserSteppingAction() ) )->GetMode();
 
 
           if (  theMode == kTracker ) // in tracker mode we store the infos about the number of compton and rayleigh
@@ -370,6 +370,14 @@ void GateAnalysis::RecordEndOfEvent(const G4Event* event)
           G4int sourceID = (((GateSourceMgr::GetInstance())->GetSourcesForThisEvent())[0])->GetSourceID();
           G4ThreeVector sourceVertex = m_trajectoryNavigator->FindSourcePosition();
 
+          // The volume names are interned once per event, not for each hit
+          G4int comptonVolumeID  = GateNameTable::GetID(theComptonVolumeName);
+          G4int comptonVolumeID1 = GateNameTable::GetID(theComptonVolumeName1);
+          G4int comptonVolumeID2 = GateNameTable::GetID(theComptonVolumeName2);
+          G4int rayleighVolumeID  = GateNameTable::GetID(theRayleighVolumeName);
+          G4int rayleighVolumeID1 = GateNameTable::GetID(theRayleighVolumeName1);
+          G4int rayleighVolumeID2 = GateNameTable::GetID(theRayleighVolumeName2);
+
           // Hits loop
           for (G4int iHit=0;iHit<NbHits;iHit++)
             {
@@ -426,8 +434,8 @@ void GateAnalysis::RecordEndOfEvent(const G4Event* event)
                     {
                       nPhantomCompton = photon1_phantom_compton;
                       nPhantomRayleigh = photon1_phantom_Rayleigh;
-                      theComptonVolumeName = theComptonVolumeName1;
-                      theRayleighVolumeName = theRayleighVolumeName1;
+                      comptonVolumeID = comptonVolumeID1;
+                      rayleighVolumeID = rayleighVolumeID1;
                       nCrystalCompton = photon1_crystal_compton;
                       nCrystalRayleigh = photon1_crystal_Rayleigh;
                     }
@@ -435,8 +443,8 @@ void GateAnalysis::RecordEndOfEvent(const G4Event* event)
                     {
                       nPhantomCompton = photon2_phantom_compton;
                       nPhantomRayleigh = photon2_phantom_Rayleigh;
-                      theComptonVolumeName = theComptonVolumeName2;
-                      theRayleighVolumeName = theRayleighVolumeName2;
+                      comptonVolumeID = comptonVolumeID2;
+                      rayleighVolumeID = rayleighVolumeID2;
                       nCrystalCompton = photon2_crystal_compton;
                       nCrystalRayleigh = photon2_crystal_Rayleigh;
                     }
@@ -448,8 +456,8 @@ void GateAnalysis::RecordEndOfEvent(const G4Event* event)
                   (*CHC)[iHit]->SetSourcePosition    (sourceVertex);
                   (*CHC)[iHit]->SetNPhantomCompton   (nPhantomCompton);
                   (*CHC)[iHit]->SetNPhantomRayleigh   (nPhantomRayleigh);
-                  (*CHC)[iHit]->SetComptonVolumeName (theComptonVolumeName);
-                  (*CHC)[iHit]->SetRayleighVolumeName (theRayleighVolumeName);
+                  (*CHC)[iHit]->SetComptonVolumeNameID (comptonVolumeID);
+                  (*CHC)[iHit]->SetRayleighVolumeNameID (rayleighVolumeID);
                   (*CHC)[iHit]->SetPhotonID          (photonID);
                   (*CHC)[iHit]->SetPrimaryID         (primaryID);
                   (*CHC)[iHit]->SetEventID           (eventID);
@@ -40,6 +40,25 @@ void GateBlurring::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& ou
 	outputPulseList.push_back(outputPulse);
 }
 
+
+
+void GateBlurring::ProcessPulseBatch(GatePulseBatch& batch)
+{
+	const size_t n = batch.size();
+	if (!n) return;
+	m_sigma.resize(n);
+	m_gauss.resize(n);
+	for (size_t i=0 ; i<n ; ++i)
+	  m_sigma[i] = m_blurringLaw->ComputeResolution(batch.energy[i])*batch.energy[i]/GateConstants::fwhm_to_sigma;
+	// Same random sequence as repeated calls to G4RandGauss::shoot(mean,sigma)
+	G4RandGauss::shootArray(n, &m_gauss[0]);
+	G4double* energy = &batch.energy[0];
+	const G4double* sigma = &m_sigma[0];
+	const G4double* gauss = &m_gauss[0];
+	for (size_t i=0 ; i<n ; ++i)
+	  energy[i] += sigma[i]*gauss[i];
+}
+
 void GateBlurring::DescribeMyself(size_t indent)
 {
  G4cout << GateTools::Indent(indent) << "Blurring law:\t" << m_blurringLaw->GetObjectName() << Gateendl;
@@ -0,0 +1,159 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateBufferedFileWriter.hh"
+#include "GateMessageManager.hh"
+
+#include <cstdio>
+
+//-----------------------------------------------------------------------------
+GateBufferedFileWriter::GateBufferedFileWriter()
+{
+  mIsOpen = false;
+  mSize = 0;
+  mBatchSize = kDefaultBatchSize;
+  mIsWriting = false;
+  mStop = false;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateBufferedFileWriter::~GateBufferedFileWriter()
+{
+  Close();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateBufferedFileWriter::Open(const G4String & filename, bool binary)
+{
+  Close();
+  if (binary) mFile.open(filename.c_str(), std::ios::out | std::ios::binary);
+  else mFile.open(filename.c_str(), std::ios::out);
+  if (!mFile.is_open()) {
+    GateWarning("Cannot open the output file '" << filename << "'" << Gateendl);
+    return false;
+  }
+  mIsOpen = true;
+  mSize = 0;
+  mStop = false;
+  mBatch.reserve(mBatchSize);
+  mThread = std::thread(&GateBufferedFileWriter::Run, this);
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedFileWriter::Close()
+{
+  if (!mIsOpen) return;
+  SubmitBatch();
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mStop = true;
+  }
+  mBatchReady.notify_one();
+  mThread.join();
+  mFile.close();
+  mIsOpen = false;
+  std::vector<std::vector<char> >().swap(mFreeBatches);
+  std::vector<char>().swap(mBatch);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedFileWriter::Flush()
+{
+  if (!mIsOpen) return;
+  SubmitBatch();
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (!mPendingBatches.empty() || mIsWriting) mBatchWritten.wait(lock);
+  // The writing thread is waiting for a batch, the file can be used here
+  mFile.flush();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedFileWriter::SubmitBatch()
+{
+  if (mBatch.empty()) return;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (mPendingBatches.size() >= kMaxPendingBatches) mBatchWritten.wait(lock);
+    mPendingBatches.push_back(std::vector<char>());
+    mPendingBatches.back().swap(mBatch);
+    // Reuse the memory of a batch already written
+    if (!mFreeBatches.empty()) {
+      mBatch.swap(mFreeBatches.back());
+      mFreeBatches.pop_back();
+    }
+  }
+  mBatchReady.notify_one();
+  mBatch.reserve(mBatchSize);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedFileWriter::Run()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (true) {
+    while (mPendingBatches.empty() && !mStop) mBatchReady.wait(lock);
+    // Stop only when all the batches are written
+    if (mPendingBatches.empty()) break;
+    std::vector<char> batch;
+    batch.swap(mPendingBatches.front());
+    mPendingBatches.pop_front();
+    mIsWriting = true;
+    lock.unlock();
+    mFile.write(&batch[0], batch.size());
+    batch.clear();
+    lock.lock();
+    mIsWriting = false;
+    if (mFreeBatches.size() < kMaxPendingBatches) mFreeBatches.push_back(std::vector<char>());
+    mFreeBatches.back().swap(batch);
+    mBatchWritten.notify_all();
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedFileWriter::WriteInt(long value, int width)
+{
+  char buffer[24];
+  char * end = buffer + sizeof(buffer);
+  char * p = end;
+  unsigned long u = (value < 0 ? 0UL-(unsigned long)value : (unsigned long)value);
+  do {
+    *--p = '0' + (u % 10);
+    u /= 10;
+  } while (u);
+  if (value < 0) *--p = '-';
+  for(int n = end-p; n < width; n++) WriteChar(' ');
+  Write(p, end-p);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateBufferedFileWriter::WriteScientific(double value, int width, int precision)
+{
+  char buffer[64];
+  int n = snprintf(buffer, sizeof(buffer), "%*.*e", width, precision, value);
+  if (n < 0) return;
+  if (n >= (int)sizeof(buffer)) n = sizeof(buffer)-1;
+  Write(buffer, n);
+}
+//-----------------------------------------------------------------------------
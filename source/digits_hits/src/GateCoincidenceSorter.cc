@@ -24,6 +24,8 @@ See LICENSE.md for further details
 #include "GateVSystem.hh"
 #include "GateCoincidenceDigiMaker.hh"
 
+#include <algorithm>
+
 //#include <map>
 
 //------------------------------------------------------------------------------------------------------
@@ -47,7 +49,8 @@ GateCoincidenceSorter::GateCoincidenceSorter(GateDigitizer* itsDigitizer,
     m_allPulseOpenCoincGate(false),
     m_depth(1),
     m_presortBufferSize(256),
-    m_presortWarning(false)
+    m_presortWarning(false),
+    m_goodPairsStride(0)
 {
 
   // Create the messenger
@@ -130,10 +133,9 @@ void GateCoincidenceSorter::SetMultiplesPolicy(const G4String& policy)
 void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
 {
   GatePulse* pulse;
-  std::list<GatePulse*>::iterator buf_iter;                // presort buffer iterator
+  std::deque<GatePulse*>::iterator buf_iter;               // presort buffer iterator
   std::deque<GateCoincidencePulse*>::iterator coince_iter; // coincidence list iterator
-
-  G4bool inCoincidence;
+  std::deque<GateCoincidencePulse*>::iterator coince_end;  // end of the windows containing the pulse
 
   GateCoincidencePulse* coincidence;
   G4double window, offset;
@@ -154,20 +156,20 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
     // make a copy of the pulse
     pulse = new GatePulse(**gpl_iter);
 
-    if(m_presortBuffer.empty())
+    // the buffer is sorted by increasing time: most pulses arrive after the
+    // latest buffered one and are simply appended
+    if(m_presortBuffer.empty() || !(pulse->GetTime() < m_presortBuffer.back()->GetTime()))
       m_presortBuffer.push_back(pulse);
-    else if(pulse->GetTime() < m_presortBuffer.back()->GetTime())    // check that even isn't earlier than the earliest event in the buffer
+    else if(pulse->GetTime() < m_presortBuffer.front()->GetTime())    // check that even isn't earlier than the earliest event in the buffer
     {
       if(!m_presortWarning)
         GateWarning("Event is earlier than earliest event in coincidence presort buffer. Consider using a larger buffer.");
       m_presortWarning = true;
-      m_presortBuffer.push_back(pulse); // this will probably not cause a problem, but coincidences may be missed
+      m_presortBuffer.push_front(pulse); // this will probably not cause a problem, but coincidences may be missed
     }
-    else // put the event into the presort buffer in the right place
+    else // put the event into the presort buffer in the right place, after pulses with the same time
     {
-      buf_iter = m_presortBuffer.begin();
-      while(pulse->GetTime() < (*buf_iter)->GetTime())
-        buf_iter++;
+      buf_iter = std::upper_bound(m_presortBuffer.begin(), m_presortBuffer.end(), pulse, IsEarlierPulse);
       m_presortBuffer.insert(buf_iter, pulse);
     }
 
@@ -176,8 +178,8 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
   //  once buffer reaches the specified size look for coincidences
   for(G4int i = m_presortBuffer.size();i > m_presortBufferSize;i--)
   {
-    pulse = m_presortBuffer.back();
-    m_presortBuffer.pop_back();
+    pulse = m_presortBuffer.front();
+    m_presortBuffer.pop_front();
 
     // process completed coincidence pulse window at front of list
     while(!m_coincidencePulses.empty() && m_coincidencePulses.front()->IsAfterWindow(pulse))
@@ -188,22 +190,28 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
       ProcessCompletedCoincidenceWindow(coincidence);
     }
 
-    // add event to coincidences
-    inCoincidence = false;
-    coince_iter = m_coincidencePulses.begin();
-    while( coince_iter != m_coincidencePulses.end() && (*coince_iter)->IsInCoincidence(pulse) )
-    {
-      inCoincidence = true;
-      (*coince_iter)->push_back(new GatePulse(pulse)); // add a copy so we can delete safely
-      coince_iter++;
-    }
+    // find the windows the event falls in
+    coince_end = m_coincidencePulses.begin();
+    while( coince_end != m_coincidencePulses.end() && (*coince_end)->IsInCoincidence(pulse) )
+      coince_end++;
 
     // if not after or in the windows, it must be before the rest of coincidence windows
     // so there's no need to check the rest of the coincidence list
 
-    // update coincidence pulse list
-    if(m_allPulseOpenCoincGate || !inCoincidence)
+    if(coince_end != m_coincidencePulses.begin() && !m_allPulseOpenCoincGate)
     {
+      // add copies of the event to all windows but the last one, which takes the event itself
+      // since it does not open a window of its own
+      for(coince_iter = m_coincidencePulses.begin(); coince_iter+1 != coince_end; coince_iter++)
+        (*coince_iter)->push_back(new GatePulse(pulse));
+      (*coince_iter)->push_back(pulse);
+    }
+    else
+    {
+      // add a copy so we can delete safely
+      for(coince_iter = m_coincidencePulses.begin(); coince_iter != coince_end; coince_iter++)
+        (*coince_iter)->push_back(new GatePulse(pulse));
+
       if(m_coincidenceWindowJitter > 0.0)
         window = G4RandGauss::shoot(m_coincidenceWindow,m_coincidenceWindowJitter);
       else
@@ -217,8 +225,6 @@ void GateCoincidenceSorter::ProcessSinglePulseList(GatePulseList* inp)
       coincidence = new GateCoincidencePulse(m_outputName,pulse,window,offset);
       m_coincidencePulses.push_back(coincidence);
     }
-    else
-      delete pulse; // pulses that don't open a coincidence window can be discarded
   }
 
 }
@@ -272,11 +278,14 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
       return;
     }
 
+    // the pair validity is used several times below: evaluate it once
+    ComputeGoodPairs(coincidence, coincidence->IsDelayed()?1:(nPulses-1));
+
     // count the goods (iterate over all pairs because we're considering the multi as a unit, not breaking it up into pairs)
     nGoods = 0;
     for(i=0; i<(coincidence->IsDelayed()?1:(nPulses-1)); i++)
       for(j=i+1; j<nPulses; j++)
-        if(!IsForbiddenCoincidence(coincidence->at(i),coincidence->at(j)))
+        if(IsGoodPair(i,j))
           nGoods++;
 
     if( nGoods == 0 )  // all of the remaining options expect at least one good
@@ -308,7 +317,7 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
       for(j=i+1; j<nPulses; j++)
       {
         // this time we might only be counting goods on the subset involving the first event
-        if(!IsForbiddenCoincidence(coincidence->at(i),coincidence->at(j)))
+        if(IsGoodPair(i,j))
           nGoods++;
 
         E = coincidence->at(i)->GetEnergy() + coincidence->at(j)->GetEnergy();
@@ -328,7 +337,7 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
 
     if(m_multiplesPolicy==kTakeWinnerIfIsGood)
     {
-      if(!IsForbiddenCoincidence(coincidence->at(winner_i),coincidence->at(winner_j)) )
+      if(IsGoodPair(winner_i,winner_j))
         m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, winner_i, winner_j));
       delete coincidence;
       return;
@@ -345,7 +354,7 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
       {
         for(i=0; i<(coincidence->IsDelayed()?1:(nPulses-1)); i++)
           for(j=i+1; j<nPulses; j++)
-            if(!IsForbiddenCoincidence(coincidence->at(i),coincidence->at(j)))
+            if(IsGoodPair(i,j))
               m_digitizer->StoreCoincidencePulse(CreateSubPulse(coincidence, i, j));
         delete coincidence;
         return;
@@ -375,7 +384,7 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
       for(i=0; i<(PairWithFirstPulseOnly?1:(nPulses-1)); i++)
         for(j=i+1; j<nPulses; j++)
         {
-          if(!IsForbiddenCoincidence(coincidence->at(i),coincidence->at(j)))
+          if(IsGoodPair(i,j))
           {
             E = coincidence->at(i)->GetEnergy() + coincidence->at(j)->GetEnergy();
             if(E>maxE)
@@ -397,6 +406,20 @@ void GateCoincidenceSorter::ProcessCompletedCoincidenceWindow(GateCoincidencePul
 
 }
 
+//------------------------------------------------------------------------------------------------------
+void GateCoincidenceSorter::ComputeGoodPairs(GateCoincidencePulse* coincidence, G4int nRows)
+{
+  G4int nPulses = coincidence->size();
+  m_goodPairsStride = nPulses;
+  if((G4int)m_goodPairs.size() < nPulses*nPulses)
+    m_goodPairs.resize(nPulses*nPulses);
+  for(G4int i=0; i<nRows; i++)
+    for(G4int j=i+1; j<nPulses; j++)
+      m_goodPairs[i*nPulses+j] = !IsForbiddenCoincidence(coincidence->at(i),coincidence->at(j));
+}
+//------------------------------------------------------------------------------------------------------
+
+
 GateCoincidencePulse* GateCoincidenceSorter::CreateSubPulse(GateCoincidencePulse* coincidence, G4int i, G4int j)
 {
   GatePulse* pulse1 = new GatePulse(coincidence->at(i));
@@ -460,12 +483,10 @@ G4bool GateCoincidenceSorter::IsForbiddenCoincidence(const GatePulse* pulse1, co
   // the geometry construction of the scanner (spherical for system ecatAccel and cylindrical
   // for other systems as Ecat, CPET and cylindricalPET)
 
-  const G4String name = m_system->GetName();
-  G4String nameComp = "systems/ecatAccel";
-  //G4cout << "NAME OF THE SYSTEM: " << name << "; NAME TO COMPARE: " << nameComp << Gateendl;
-  int comp = strcmp(name,nameComp);
+  const G4String& name = m_system->GetName();
+  //G4cout << "NAME OF THE SYSTEM: " << name << "; NAME TO COMPARE: systems/ecatAccel" << Gateendl;
 
-  if (comp == 0) {
+  if (name == "systems/ecatAccel") {
     // Compute the sector difference
     G4int sectorID1 = m_system->ComputeSectorIDSphere(blockID1),
     sectorID2 = m_system->ComputeSectorIDSphere(blockID2);
@@ -17,16 +17,19 @@ See LICENSE.md for further details
 #include "GateCrystalHit.hh"
 
 
-G4Allocator<GateCrystalHit> GateCrystalHitAllocator;
+G4ThreadLocal G4Allocator<GateCrystalHit> *GateCrystalHitAllocator = 0;
 
 //---------------------------------------------------------------------
 GateCrystalHit::GateCrystalHit()
 : m_edep(0),
   m_stepLength(0),
   m_time(0.),
+  m_process(0),
   m_PDGEncoding(0),
   m_trackID(0),
   m_parentID(0),
+  m_comptonVolumeName(0),
+  m_RayleighVolumeName(0),
   m_systemID(-1)
 {;}
 //---------------------------------------------------------------------
@@ -70,7 +73,7 @@ std::ostream& operator<<(std::ostream& flux, const GateCrystalHit& hit)
 {
   flux   << "("
 	 << "E=" << G4BestUnit(hit.m_edep,"Energy") << ", "
-	 << "proc=" << hit.m_process << ", "
+	 << "proc=" << hit.GetProcess() << ", "
 	 << "particle= " << ( (hit.m_PDGEncoding == 22) ? "gamma" : ( (hit.m_PDGEncoding == 11) ? "e-" : "?" ) ) << ", "
 	 << "track=" << hit.m_trackID  << " (son of " << hit.m_parentID    << ") " << ", "
 //	 << "outputID= " << hit.GetOutputVolumeID() << ", "
@@ -107,9 +110,9 @@ std::ofstream& operator<<(std::ofstream& flux, GateCrystalHit* hit)
 	 << " " << std::setw(3) << hit->m_photonID
 	 << " " << std::setw(4) << hit->m_nPhantomCompton
 	 << " " << std::setw(4) << hit->m_nPhantomRayleigh
-	 << " " << hit->m_process
-	 << " " << hit->m_comptonVolumeName
-	 << " " << hit->m_RayleighVolumeName
+	 << " " << hit->GetProcess()
+	 << " " << hit->GetComptonVolumeName()
+	 << " " << hit->GetRayleighVolumeName()
 	 << Gateendl;
 
   return flux;
@@ -36,13 +36,26 @@ const G4String GateCrystalSD::theCrystalCollectionName = "crystalCollection";
 //------------------------------------------------------------------------------
 // Constructor
 GateCrystalSD::GateCrystalSD(const G4String& name)
-:G4VSensitiveDetector(name),m_system(0)
+:G4VSensitiveDetector(name),m_system(0),m_systemList(0),
+ m_volumeIDTableGeneration(-1),m_lastProcess(0),m_lastProcessNameID(GateNameTable::kEmptyID)
 {
   collectionName.insert(theCrystalCollectionName);
 }
 //------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------
+// Copy of the SD for a worker thread: the systems are shared with the master
+G4VSensitiveDetector* GateCrystalSD::Clone() const
+{
+  GateCrystalSD* aClone = new GateCrystalSD(SensitiveDetectorName);
+  aClone->m_system = m_system;
+  if (m_systemList) aClone->m_systemList = new GateSystemList(*m_systemList);
+  return aClone;
+}
+//------------------------------------------------------------------------------
+
+
 //------------------------------------------------------------------------------
 // Destructor
 GateCrystalSD::~GateCrystalSD()
@@ -56,8 +69,7 @@ GateCrystalSD::~GateCrystalSD()
 // Method overloading the virtual method Initialize() of G4VSensitiveDetector
 void GateCrystalSD::Initialize(G4HCofThisEvent*HCE)
 {
-  static int HCID = -1; // Static variable storing the hit collection ID
-// Not thread safe but moving to local variable doesn't work
+  static G4ThreadLocal int HCID = -1; // Static variable storing the hit collection ID (one per thread)
   // Creation of a new hit collection
   crystalCollection = new GateCrystalHitsCollection
                    (SensitiveDetectorName,theCrystalCollectionName);
@@ -97,22 +109,19 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
 
   //  Get the process name
   const G4VProcess* process = newStepPoint->GetProcessDefinedStep();
-  G4String processName = ( (process != NULL) ? process->GetProcessName() : G4String() ) ;
+  G4int processNameID = GetProcessNameID(process);
 
   //  For all processes except transportation, we select the PostStepPoint volume
   //  For the transportation, we select the PreStepPoint volume
   const G4TouchableHistory* touchable;
-  if ( processName == "Transportation" )
+  if ( processNameID == GateNameTable::kTransportationID )
       touchable = (const G4TouchableHistory*)(oldStepPoint->GetTouchable() );
   else
       touchable = (const G4TouchableHistory*)(newStepPoint->GetTouchable() );
 
-
-  GateVolumeID volumeID(touchable);
-
-
-  if (volumeID.IsInvalid())
-    G4Exception( "GateCrystalSD::ProcessHits", "ProcessHits", FatalException, "could not get the volume ID! Aborting!\n");
+  // Volume ID, output volume ID and system of the crystal
+  const VolumeIDEntry& volumeIDEntry = GetVolumeIDEntry(touchable);
+  const GateVolumeID& volumeID = volumeIDEntry.volumeID;
 
   // Get the hit global position
   //Modifs Seb 22-06-2011
@@ -129,7 +138,7 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
 
   // Get the scanner position and rotation angle
 /*  GateSystemComponent* baseComponent = GetSystem()->GetBaseComponent();*/
-  GateVSystem* system = FindSystem(volumeID);
+  GateVSystem* system = volumeIDEntry.system;
   GateSystemComponent* baseComponent = system->GetBaseComponent();
   G4ThreeVector scannerPos = baseComponent->GetCurrentTranslation();
   G4double scannerRotAngle = 0;
@@ -162,7 +171,7 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   aHit->SetTime( aTime );
   aHit->SetGlobalPos( position );
   aHit->SetLocalPos( localPosition );
-  aHit->SetProcess( processName );
+  aHit->SetProcessID( processNameID );
   aHit->SetTrackID( trackID );
  // Seb Modif 5/4/2016 
   aHit->SetTrackLength( trackLength );
@@ -174,12 +183,8 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
   aHit->SetScannerRotAngle( scannerRotAngle );
   aHit->SetSystemID(system->GetItsNumber());
 
-  // Ask the system to compute the output volume ID and store it into the hit
-
-//Seb Modif 24/02/2009
-/*  GateOutputVolumeID outputVolumeID = GetSystem()->ComputeOutputVolumeID(aHit->GetVolumeID());*/
-  GateOutputVolumeID outputVolumeID = system->ComputeOutputVolumeID(aHit->GetVolumeID());
-  aHit->SetOutputVolumeID(outputVolumeID);
+  // Store the output volume ID computed by the system into the hit
+  aHit->SetOutputVolumeID(volumeIDEntry.outputVolumeID);
 
   // Insert the new hit into the hit collection
   crystalCollection->insert( aHit );
@@ -189,6 +194,71 @@ G4bool GateCrystalSD::ProcessHits(G4Step*aStep, G4TouchableHistory*)
 //------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------
+size_t GateCrystalSD::TouchablePathHash::operator()(const TouchablePath& path) const
+{
+  size_t h = path.size();
+  for (size_t i=0; i<path.size(); ++i) {
+    h ^= std::hash<const void*>()(path[i].first) + 0x9e3779b9 + (h<<6) + (h>>2);
+    h ^= std::hash<G4int>()(path[i].second) + 0x9e3779b9 + (h<<6) + (h>>2);
+  }
+  return h;
+}
+//------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------
+const GateCrystalSD::VolumeIDEntry& GateCrystalSD::GetVolumeIDEntry(const G4TouchableHistory* touchable)
+{
+  if (!touchable)
+    G4Exception( "GateCrystalSD::ProcessHits", "ProcessHits", FatalException, "could not get the volume ID! Aborting!\n");
+
+  // The physical volumes of the table may have been deleted
+  if (m_volumeIDTableGeneration != GateVVolume::GetGeometryGeneration()) {
+    m_volumeIDTable.clear();
+    m_volumeIDTableGeneration = GateVVolume::GetGeometryGeneration();
+  }
+
+  G4int depth = touchable->GetHistoryDepth();
+  m_touchablePath.resize(depth);
+  for (G4int i=0; i<depth; ++i)
+    m_touchablePath[i] = std::make_pair(touchable->GetVolume(i), touchable->GetReplicaNumber(i));
+
+  VolumeIDTable::iterator it = m_volumeIDTable.find(m_touchablePath);
+  if (it != m_volumeIDTable.end())
+    return it->second;
+
+  // First hit in this crystal: compute its IDs
+  VolumeIDEntry entry;
+  entry.volumeID = GateVolumeID(touchable);
+  if (entry.volumeID.IsInvalid())
+    G4Exception( "GateCrystalSD::ProcessHits", "ProcessHits", FatalException, "could not get the volume ID! Aborting!\n");
+  entry.system = FindSystem(entry.volumeID);
+  entry.outputVolumeID = entry.system->ComputeOutputVolumeID(entry.volumeID);
+  return m_volumeIDTable.insert(std::make_pair(m_touchablePath, entry)).first->second;
+}
+//------------------------------------------------------------------------------
+
+
+//------------------------------------------------------------------------------
+G4int GateCrystalSD::GetProcessNameID(const G4VProcess* process)
+{
+  // The table is only looked up when the process changes, and the name is
+  // only interned (under lock in MT) the first time the process is met
+  if (process != m_lastProcess) {
+    m_lastProcess = process;
+    std::unordered_map<const G4VProcess*,G4int>::const_iterator it = m_processNameIDs.find(process);
+    if (it != m_processNameIDs.end()) m_lastProcessNameID = it->second;
+    else {
+      m_lastProcessNameID = (process ? GateNameTable::GetID(process->GetProcessName()) : G4int(GateNameTable::kEmptyID));
+      m_processNameIDs[process] = m_lastProcessNameID;
+    }
+  }
+  return m_lastProcessNameID;
+}
+//------------------------------------------------------------------------------
+
+
 //------------------------------------------------------------------------------
 //! Next method underwent an important modification to be compatible with the multi-system approach
 G4int GateCrystalSD::PrepareCreatorAttachment(GateVVolume* aCreator)
@@ -242,7 +312,7 @@ void GateCrystalSD::AddSystem(GateVSystem* aSystem)
 
 
 //------------------------------------------------------------------------------
-GateVSystem* GateCrystalSD::FindSystem(GateVolumeID volumeID)
+GateVSystem* GateCrystalSD::FindSystem(const GateVolumeID& volumeID)
 {
    // MP Garcia (24/03/2014) Modif to handle imbricated boxes between the SPECThead volume and the world
     //size_t m = volumeID.size();
@@ -0,0 +1,100 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateDEDXCache.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <atomic>
+#include <cmath>
+
+namespace {
+  // Energy grid: 1 keV to 100 GeV, 100 nodes per decade
+  const G4double kMinEnergy = 1*keV;
+  const G4double kMaxEnergy = 100*GeV;
+  const G4double kNodesPerDecade = 100;
+  const G4double kLogMinEnergy = std::log(kMinEnergy);
+  const G4double kNodesPerLogUnit = kNodesPerDecade/std::log(10.0);
+  const G4int kNumberOfNodes = G4int(std::log(kMaxEnergy/kMinEnergy)*kNodesPerLogUnit) + 2;
+
+  // Incremented at each Invalidate(), the per-thread caches compare it with
+  // their own generation
+  std::atomic<G4int> gGeneration(0);
+
+  G4ThreadLocal GateDEDXCache * threadCache = 0;
+}
+
+//-----------------------------------------------------------------------------
+GateDEDXCache * GateDEDXCache::GetInstance()
+{
+  if (!threadCache) threadCache = new GateDEDXCache;
+  if (threadCache->mGeneration != gGeneration.load(std::memory_order_relaxed)) threadCache->Clear();
+  return threadCache;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDEDXCache::Invalidate()
+{
+  gGeneration++;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateDEDXCache::GateDEDXCache()
+{
+  mLastTable = 0;
+  mGeneration = gGeneration.load();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDEDXCache::Clear()
+{
+  mTables.clear();
+  mLastTable = 0;
+  mGeneration = gGeneration.load();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateDEDXCache::GetDEDX(G4int type, G4double energy,
+                                const G4ParticleDefinition * p, const G4Material * m)
+{
+  if (energy < kMinEnergy || energy >= kMaxEnergy) return ComputeDEDX(type, energy, p, m);
+
+  // Consecutive steps are most often the same particle in the same material
+  KeyType key(std::make_pair(p, m), type);
+  if (!mLastTable || key != mLastKey) {
+    std::vector<G4double> & table = mTables[key];
+    if (table.empty()) table.resize(kNumberOfNodes, -1.0);
+    mLastKey = key;
+    mLastTable = &table;
+  }
+
+  const G4double u = (std::log(energy) - kLogMinEnergy)*kNodesPerLogUnit;
+  const G4int i = G4int(u);
+  G4double * v = &(*mLastTable)[i];
+  if (v[0] < 0) v[0] = ComputeDEDX(type, std::exp(kLogMinEnergy + i/kNodesPerLogUnit), p, m);
+  if (v[1] < 0) v[1] = ComputeDEDX(type, std::exp(kLogMinEnergy + (i+1)/kNodesPerLogUnit), p, m);
+  return v[0] + (u-i)*(v[1]-v[0]);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4double GateDEDXCache::ComputeDEDX(G4int type, G4double energy,
+                                    const G4ParticleDefinition * p, const G4Material * m)
+{
+  if (type == 0) return mEmCalculator.ComputeElectronicDEDX(energy, p, m);
+  return mEmCalculator.ComputeTotalDEDX(energy, p, m);
+}
+//-----------------------------------------------------------------------------
@@ -30,6 +30,17 @@
 #include "G4ParticleTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4ProcessManager.hh"
+#include "G4RunManager.hh"
+#include "GateSnapshotWriter.hh"
+#include "GateDEDXCache.hh"
+
+#include <memory>
+
+namespace {
+  // G4EmCalculator caches its last request: one instance per thread when
+  // the actor is shared
+  G4ThreadLocal G4EmCalculator * threadEmCalculator = 0;
+}
 
 //-----------------------------------------------------------------------------
 GateDoseActor::GateDoseActor(G4String name, G4int depth):
@@ -65,9 +76,11 @@ GateDoseActor::GateDoseActor(G4String name, G4int depth):
   mDoseAlgorithmType = "VolumeWeighting";
   mImportMassImage = "";
   mExportMassImage = "";
+  mMassCacheDirectory = "";
   mVolumeFilter = "";
   mMaterialFilter = "";
   mTestFlag = false;
+  mIsSharedScoringEnabled = false;
 
   pMessenger = new GateDoseActorMessenger(this);
   GateDebugMessageDec("Actor",4,"GateDoseActor() -- end\n");
@@ -156,12 +169,18 @@ void GateDoseActor::Construct() {
   // Record the stepHitType
   mUserStepHitType = mStepHitType;
 
-  // Enable callbacks
+  // Enable callbacks (with shared scoring, the step hit type is chosen at
+  // each step instead of being stored at the beginning of the track)
   EnableBeginOfRunAction(true);
   EnableBeginOfEventAction(true);
-  EnablePreUserTrackingAction(true);
+  EnableEndOfEventAction(true);
+  EnablePreUserTrackingAction(!mIsSharedScoringEnabled);
   EnableUserSteppingAction(true);
 
+  if (mIsSharedScoringEnabled && mDoseByRegionsFlag)
+    GateError("The DoseActor " << GetObjectName()
+              << " cannot use shared scoring with the dose by regions.");
+
   // Check if at least one image is enabled
   if (!mIsEdepImageEnabled &&
       !mIsDoseImageEnabled &&
@@ -189,11 +208,13 @@ void GateDoseActor::Construct() {
   SetOriginTransformAndFlagToImage(mLastHitEventImage);
   SetOriginTransformAndFlagToImage(mMassImage);
 
-  // Resize and allocate images
-  if (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
-      mIsDoseSquaredImageEnabled || mIsDoseUncertaintyImageEnabled ||
-      mIsDoseToWaterSquaredImageEnabled || mIsDoseToWaterUncertaintyImageEnabled ||
-      mIsDoseToOtherMaterialSquaredImageEnabled || mIsDoseToOtherMaterialUncertaintyImageEnabled)
+  // Resize and allocate images (shared scoring tags the values with the
+  // event ID instead of using a last hit image)
+  if (!mIsSharedScoringEnabled &&
+      (mIsEdepSquaredImageEnabled || mIsEdepUncertaintyImageEnabled ||
+       mIsDoseSquaredImageEnabled || mIsDoseUncertaintyImageEnabled ||
+       mIsDoseToWaterSquaredImageEnabled || mIsDoseToWaterUncertaintyImageEnabled ||
+       mIsDoseToOtherMaterialSquaredImageEnabled || mIsDoseToOtherMaterialUncertaintyImageEnabled))
     {
       mLastHitEventImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
       mLastHitEventImage.Allocate();
@@ -207,6 +228,7 @@ void GateDoseActor::Construct() {
     // Force the computation of squared image if uncertainty is enabled
     if (mIsEdepUncertaintyImageEnabled) mEdepImage.EnableSquaredImage(true);
     mEdepImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mEdepImage.EnableSharedScoring(mIsSharedScoringEnabled);
     mEdepImage.Allocate();
     mEdepImage.SetFilename(mEdepFilename);
   }
@@ -216,6 +238,7 @@ void GateDoseActor::Construct() {
     mDoseImage.EnableSquaredImage(mIsDoseSquaredImageEnabled);
     mDoseImage.EnableUncertaintyImage(mIsDoseUncertaintyImageEnabled);
     mDoseImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mDoseImage.EnableSharedScoring(mIsSharedScoringEnabled);
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseUncertaintyImageEnabled) mDoseImage.EnableSquaredImage(true);
     mDoseImage.Allocate();
@@ -228,6 +251,7 @@ void GateDoseActor::Construct() {
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseToWaterUncertaintyImageEnabled) mDoseToWaterImage.EnableSquaredImage(true);
     mDoseToWaterImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mDoseToWaterImage.EnableSharedScoring(mIsSharedScoringEnabled);
     mDoseToWaterImage.Allocate();
     mDoseToWaterImage.SetFilename(mDoseToWaterFilename);
   }
@@ -238,6 +262,7 @@ void GateDoseActor::Construct() {
     // Force the computation of squared image if uncertainty is enabled
     if (mIsDoseToOtherMaterialUncertaintyImageEnabled) mDoseToOtherMaterialImage.EnableSquaredImage(true);
     mDoseToOtherMaterialImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
+    mDoseToOtherMaterialImage.EnableSharedScoring(mIsSharedScoringEnabled);
     mDoseToOtherMaterialImage.Allocate();
     mDoseToOtherMaterialImage.SetFilename(mDoseToOtherMaterialFilename);
   }
@@ -273,12 +298,17 @@ void GateDoseActor::Construct() {
     mVoxelizedMass.SetMaterialFilter(mMaterialFilter);
     mVoxelizedMass.SetVolumeFilter(mVolumeFilter);
     mVoxelizedMass.SetExternalMassImage(mImportMassImage);
+    mVoxelizedMass.SetMassCacheDirectory(mMassCacheDirectory);
     mVoxelizedMass.Initialize(mVolumeName, &mDoseImage.GetValueImage());
+    // The dosel masses are computed lazily: compute them all now when
+    // several threads may ask for them
+    if (mIsSharedScoringEnabled && mImportMassImage == "") mVoxelizedMass.GetDoselMassVector();
     if (mExportMassImage != "") {
       mMassImage.SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
       mMassImage.Allocate();
       mVoxelizedMass.UpdateImage(&mMassImage);
-      mMassImage.Write(mExportMassImage);
+      // Only the master actor writes the exported mass image
+      if (!IsWorkerActor()) mMassImage.Write(mExportMassImage);
     }
   }
 
@@ -322,13 +352,15 @@ void GateDoseActor::Construct() {
               "\tDose algorithm    = " << mDoseAlgorithmType << Gateendl <<
               "\tMass image (import) = " << mImportMassImage << Gateendl <<
               "\tMass image (export) = " << mExportMassImage << Gateendl <<
+              "\tMass cache directory = " << mMassCacheDirectory << Gateendl <<
               "\tEdepFilename      = " << mEdepFilename << Gateendl <<
               "\tDoseFilename      = " << mDoseFilename << Gateendl <<
               "\tDose by regions           = " << mDoseByRegionsFlag << Gateendl <<
               "\tDoseByRegionsInput        = " << mDoseByRegionsInputFilename << Gateendl <<
               "\tDoseByRegionsOutput       = " << mDoseByRegionsOutputFilename << Gateendl <<
               "\tNumber of regions         = " << mMapIdToSingleRegion.size() << Gateendl <<
-              "\tNb Hits filename  = " << mNbOfHitsFilename << Gateendl);
+              "\tNb Hits filename  = " << mNbOfHitsFilename << Gateendl <<
+              "\tShared scoring    = " << mIsSharedScoringEnabled << Gateendl);
 
   ResetData();
   GateMessageDec("Actor", 4, "GateDoseActor -- Construct - end\n");
@@ -336,6 +368,39 @@ void GateDoseActor::Construct() {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+/// Save data in the background (intermediate saves)
+void GateDoseActor::SaveDataAsync() {
+  // The dose by regions output is small, but its update is not separated from its writing
+  if (mDoseByRegionsFlag) { SaveData(); return; }
+
+  // The images are copied now, and written by the snapshot writer thread
+  std::vector<GateSnapshotWriter::Task> tasks;
+  if (mIsEdepImageEnabled) tasks.push_back(mEdepImage.CreateSaveTask(mCurrentEvent+1));
+  if (mIsDoseImageEnabled)
+    tasks.push_back(mDoseImage.CreateSaveTask(mCurrentEvent+1, mIsDoseNormalisationEnabled));
+  if (mIsDoseToWaterImageEnabled)
+    tasks.push_back(mDoseToWaterImage.CreateSaveTask(mCurrentEvent+1, mIsDoseToWaterNormalisationEnabled));
+  if (mIsDoseToOtherMaterialImageEnabled)
+    tasks.push_back(mDoseToOtherMaterialImage.CreateSaveTask(mCurrentEvent+1, mIsDoseToOtherMaterialNormalisationEnabled));
+
+  if (mIsLastHitEventImageEnabled) {
+    mLastHitEventImage.Fill(-1); // reset
+  }
+
+  if (mIsNumberOfHitsImageEnabled) {
+    std::shared_ptr<GateImageInt> nbOfHits(new GateImageInt(mNumberOfHitsImage));
+    G4String filename = mNbOfHitsFilename;
+    tasks.push_back([nbOfHits, filename]() { nbOfHits->Write(filename); });
+  }
+
+  GateSnapshotWriter::GetInstance()->Submit(this, [tasks]() {
+      for (size_t i=0; i<tasks.size(); i++) tasks[i]();
+    });
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 /// Save data
 void GateDoseActor::SaveData() {
@@ -425,11 +490,40 @@ void GateDoseActor::ResetData() {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateDoseActor::MergeWorkerData(GateVActor * worker) {
+  GateDoseActor * w = dynamic_cast<GateDoseActor*>(worker);
+  if (!w) GateError("Cannot merge actor " << worker->GetName() << " into DoseActor " << GetName());
+
+  if (mIsEdepImageEnabled) mEdepImage.Merge(w->mEdepImage);
+  if (mIsDoseImageEnabled) mDoseImage.Merge(w->mDoseImage);
+  if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.Merge(w->mDoseToWaterImage);
+  if (mIsDoseToOtherMaterialImageEnabled) mDoseToOtherMaterialImage.Merge(w->mDoseToOtherMaterialImage);
+  if (mIsNumberOfHitsImageEnabled) {
+    GateImageInt::iterator pi = mNumberOfHitsImage.begin();
+    GateImageInt::const_iterator po = w->mNumberOfHitsImage.begin();
+    GateImageInt::const_iterator pe = mNumberOfHitsImage.end();
+    while (pi != pe) {
+      *pi += *po;
+      ++pi;
+      ++po;
+    }
+  }
+
+  // Events counted by the worker since the previous merge
+  mCurrentEvent += w->mCurrentEvent+1;
+  w->mCurrentEvent = -1;
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateDoseActor::BeginOfRunAction(const G4Run * r) {
   GateVActor::BeginOfRunAction(r);
   GateDebugMessage("Actor", 3, "GateDoseActor -- Begin of Run\n");
   mDose2WaterWarningFlag = true;
+  // physics tables may have changed
+  GateDEDXCache::Invalidate();
   // ResetData(); // Do no reset here !! (when multiple run);
 }
 //-----------------------------------------------------------------------------
@@ -445,6 +539,46 @@ void GateDoseActor::BeginOfEventAction(const G4Event * e) {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateDoseActor::EndOfEventAction(const G4Event * e) {
+  // Move the values deposited by this thread during the event into the images
+  if (mIsSharedScoringEnabled) {
+    if (mIsEdepImageEnabled) mEdepImage.FlushEvent();
+    if (mIsDoseImageEnabled) mDoseImage.FlushEvent();
+    if (mIsDoseToWaterImageEnabled) mDoseToWaterImage.FlushEvent();
+    if (mIsDoseToOtherMaterialImageEnabled) mDoseToOtherMaterialImage.FlushEvent();
+  }
+  GateVActor::EndOfEventAction(e);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4EmCalculator * GateDoseActor::GetEmCalculator()
+{
+  if (!mIsSharedScoringEnabled) return emcalc;
+  if (!threadEmCalculator) threadEmCalculator = new G4EmCalculator;
+  return threadEmCalculator;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateDoseActor::UserSteppingAction(const GateVVolume * v, const G4Step * step)
+{
+  if (!mIsSharedScoringEnabled) {
+    GateVImageActor::UserSteppingAction(v, step);
+    return;
+  }
+  // Same hit type as UserPreTrackActionInVoxel, without modifying the actor
+  StepHitType hitType = mUserStepHitType;
+  if (step->GetTrack()->GetDefinition() == G4Gamma::Gamma()) hitType = PostStepHitType;
+  int index = GetIndexFromStepPosition(GetVolume(), step, hitType);
+  UserSteppingActionInVoxel(index, step);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateDoseActor::UserPreTrackActionInVoxel(const int /*index*/, const G4Track* track)
 {
@@ -488,7 +622,11 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   // compute sameEvent
   // sameEvent is false the first time some energy is deposited for each primary particle
   bool sameEvent=true;
-  if (mIsLastHitEventImageEnabled) {
+  int eventID = -1;
+  if (mIsSharedScoringEnabled) {
+    eventID = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+  }
+  else if (mIsLastHitEventImageEnabled) {
     GateDebugMessage("Actor", 2,  "GateDoseActor -- UserSteppingActionInVoxel: Last event in index = " << mLastHitEventImage.GetValue(index) << Gateendl);
     if (mCurrentEvent != mLastHitEventImage.GetValue(index)) {
       sameEvent = false;
@@ -556,7 +694,7 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
         }
       }
       if(mTestFlag){
-        G4double dedx = emcalc->ComputeElectronicDEDX(energy, p, current_material);
+        G4double dedx = GetEmCalculator()->ComputeElectronicDEDX(energy, p, current_material);
 
         G4cout<<"Particle : "<<p->GetParticleName()<<"\t energy : "<<energy<<"\t material : "<<current_material->GetName()<<"\t dedx : "<<dedx<<"\t efficiency : "<<efficiency<<"\t dose : "<<dose;
       }
@@ -575,7 +713,6 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   double doseToWater = 0;
   if (mIsDoseToWaterImageEnabled)
     {
-      double cut =  DBL_MAX;
       // dedx
       double DEDX=0, DEDX_Water=0;
       //other material
@@ -588,8 +725,9 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
       //For neutrons the dose is neglected - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is < 0.01%
       //		when comparing dose and dosetowater in the material G4_WATER (we are systematically missing a little bit of dose of course with this solution)
       if (p == G4Gamma::Gamma())  p = G4Electron::Electron();
-      DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-      DEDX_Water = emcalc->ComputeTotalDEDX(energy, p, water, cut);
+      GateDEDXCache * dedxCache = GateDEDXCache::GetInstance();
+      DEDX = dedxCache->GetTotalDEDX(energy, p, current_material);
+      DEDX_Water = dedxCache->GetTotalDEDX(energy, p, water);
       //In current implementation, dose deposited directly by neutrons is neglected - the below lines prevent "inf or NaN"
       if (DEDX==0 || DEDX_Water==0){
       	doseToWater=0;
@@ -605,8 +743,8 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
       /*
 			//if calculation for a given particle does not work using DEDX (neutron etc, use an electron instead)
 			if(DEDX == 0) {
-      DEDX = emcalc->ComputeTotalDEDX(energy, G4Electron::Electron(), current_material, cut);
-      DEDX_Water = emcalc->ComputeTotalDEDX(energy, G4Electron::Electron(), water, cut);
+      DEDX = GetEmCalculator()->ComputeTotalDEDX(energy, G4Electron::Electron(), current_material, cut);
+      DEDX_Water = GetEmCalculator()->ComputeTotalDEDX(energy, G4Electron::Electron(), water, cut);
 			}
 
 			if (DEDX_Water == 0 or DEDX == 0)
@@ -677,8 +815,8 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     if(mTestFlag){
       // DISPLAY parameters of particles having DEDX=0
       // Mainly gamma and neutron
-      DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-      DEDX_OtherMaterial = emcalc->ComputeTotalDEDX(energy, p, OtherMaterial, cut);
+      DEDX = GetEmCalculator()->ComputeTotalDEDX(energy, p, current_material, cut);
+      DEDX_OtherMaterial = GetEmCalculator()->ComputeTotalDEDX(energy, p, OtherMaterial, cut);
       if(DEDX==0){
         G4cout<<"Particle : "<<p->GetParticleName()<<"\t energy : "<<energy<<"\t current material : "<<current_material->GetName()<<"\t dedx : "<<DEDX<<"\t density : "<<current_density*e_SI<<"\t dose : "<<dose<<G4endl;
         G4cout<<"Particle : "<<p->GetParticleName()<<"\t energy : "<<energy<<"\t other material : "<<mOtherMaterial<<"\t dedx other : "<<DEDX_OtherMaterial<<"\t density other : "<<Density_OtherMaterial*e_SI<<"\t dose to other: "<<DoseToOtherMaterial<<G4endl;
@@ -698,8 +836,9 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
     //For neutrons the dose is neglected - testing with 1.3 MeV photon beam or 150 MeV protons or 1500 MeV carbon ion beam showed that the error induced is < 0.01%
     //		we are systematically missing a little bit of dose of course with this solution
 		if (p == G4Gamma::Gamma())  p = G4Electron::Electron();
-    DEDX = emcalc->ComputeTotalDEDX(energy, p, current_material, cut);
-    DEDX_OtherMaterial = emcalc->ComputeTotalDEDX(energy, p, OtherMaterial, cut);
+    GateDEDXCache * dedxCache = GateDEDXCache::GetInstance();
+    DEDX = dedxCache->GetTotalDEDX(energy, p, current_material);
+    DEDX_OtherMaterial = dedxCache->GetTotalDEDX(energy, p, OtherMaterial);
     //In current implementation, dose deposited directly by neutrons is neglected - the below lines prevent "inf or NaN"
     if (DEDX==0 || DEDX_OtherMaterial==0){
       DoseToOtherMaterial=0;
@@ -717,7 +856,8 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   //Edep
   if (mIsEdepImageEnabled)
     {
-      if (mIsEdepUncertaintyImageEnabled || mIsEdepSquaredImageEnabled)
+      if (mIsSharedScoringEnabled) mEdepImage.AddValueInEvent(eventID, index, edep);
+      else if (mIsEdepUncertaintyImageEnabled || mIsEdepSquaredImageEnabled)
         {
           if (sameEvent) mEdepImage.AddTempValue(index, edep);
           else mEdepImage.AddValueAndUpdate(index, edep);
@@ -732,7 +872,8 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   //Dose
   if (mIsDoseImageEnabled)
     {
-      if (mIsDoseUncertaintyImageEnabled || mIsDoseSquaredImageEnabled)
+      if (mIsSharedScoringEnabled) mDoseImage.AddValueInEvent(eventID, index, dose);
+      else if (mIsDoseUncertaintyImageEnabled || mIsDoseSquaredImageEnabled)
         {
           if (sameEvent) mDoseImage.AddTempValue(index, dose);
           else mDoseImage.AddValueAndUpdate(index, dose);
@@ -743,7 +884,8 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   //DoseToWater
   if (mIsDoseToWaterImageEnabled)
     {
-      if (mIsDoseToWaterUncertaintyImageEnabled || mIsDoseToWaterSquaredImageEnabled)
+      if (mIsSharedScoringEnabled) mDoseToWaterImage.AddValueInEvent(eventID, index, doseToWater);
+      else if (mIsDoseToWaterUncertaintyImageEnabled || mIsDoseToWaterSquaredImageEnabled)
         {
           if (sameEvent) mDoseToWaterImage.AddTempValue(index, doseToWater);
           else mDoseToWaterImage.AddValueAndUpdate(index, doseToWater);
@@ -754,7 +896,8 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
   //DoseToOtherMaterial
   if (mIsDoseToOtherMaterialImageEnabled)
     {
-      if (mIsDoseToOtherMaterialUncertaintyImageEnabled || mIsDoseToOtherMaterialSquaredImageEnabled)
+      if (mIsSharedScoringEnabled) mDoseToOtherMaterialImage.AddValueInEvent(eventID, index, DoseToOtherMaterial);
+      else if (mIsDoseToOtherMaterialUncertaintyImageEnabled || mIsDoseToOtherMaterialSquaredImageEnabled)
         {
           if (sameEvent) mDoseToOtherMaterialImage.AddTempValue(index, DoseToOtherMaterial);
           else mDoseToOtherMaterialImage.AddValueAndUpdate(index, DoseToOtherMaterial);
@@ -762,7 +905,11 @@ void GateDoseActor::UserSteppingActionInVoxel(const int index, const G4Step* ste
       else mDoseToOtherMaterialImage.AddValue(index, DoseToOtherMaterial);
     }
 
-  if (mIsNumberOfHitsImageEnabled) mNumberOfHitsImage.AddValue(index, weight);
+  if (mIsNumberOfHitsImageEnabled) {
+    if (mIsSharedScoringEnabled)
+      GateImageWithStatistic::AtomicAdd(*(mNumberOfHitsImage.begin()+index), static_cast<int>(weight));
+    else mNumberOfHitsImage.AddValue(index, weight);
+  }
 
   //Dose regions
   if (mDoseByRegionsFlag) {
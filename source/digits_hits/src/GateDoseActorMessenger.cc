@@ -46,9 +46,11 @@ GateDoseActorMessenger::GateDoseActorMessenger(GateDoseActor* sensor)
   pSetDoseAlgorithmCmd= 0;
   pImportMassImageCmd= 0;
   pExportMassImageCmd= 0;
+  pMassCacheDirectoryCmd= 0;
   pVolumeFilterCmd= 0;
   pMaterialFilterCmd= 0;
   pTestFlagCmd= 0;
+  pEnableSharedScoringCmd= 0;
   //Dose in regions
   pDoseRegionInputCmd = 0;
   pDoseRegionOutputCmd = 0;
@@ -91,9 +93,12 @@ GateDoseActorMessenger::~GateDoseActorMessenger()
   if(pSetDoseAlgorithmCmd) delete pSetDoseAlgorithmCmd;
   if(pImportMassImageCmd) delete pImportMassImageCmd;
   if(pExportMassImageCmd) delete pExportMassImageCmd;
+  if(pMassCacheDirectoryCmd) delete pMassCacheDirectoryCmd;
 
   if(pVolumeFilterCmd) delete pVolumeFilterCmd;
   if(pMaterialFilterCmd) delete pMaterialFilterCmd;
+  if(pTestFlagCmd) delete pTestFlagCmd;
+  if(pEnableSharedScoringCmd) delete pEnableSharedScoringCmd;
 
   if(pDoseRegionOutputCmd) delete pDoseRegionOutputCmd;
   if(pDoseRegionInputCmd) delete pDoseRegionInputCmd;
@@ -222,6 +227,12 @@ void GateDoseActorMessenger::BuildCommands(G4String base)
   pExportMassImageCmd->SetGuidance(guid);
   pExportMassImageCmd->SetParameterName("Export mass image",false);
 
+  n = base+"/setMassCacheDirectory";
+  pMassCacheDirectoryCmd = new G4UIcmdWithAString(n, this);
+  guid = G4String("Store the computed dosel masses in this directory, and reuse them in later runs on the same geometry");
+  pMassCacheDirectoryCmd->SetGuidance(guid);
+  pMassCacheDirectoryCmd->SetParameterName("Mass cache directory",false);
+
 
   n = base+"/setVolumeFilter";
   pVolumeFilterCmd = new G4UIcmdWithAString(n, this);
@@ -240,6 +251,11 @@ void GateDoseActorMessenger::BuildCommands(G4String base)
   guid = G4String("Set Test Flag for debug/validation purposes");
   pTestFlagCmd->SetGuidance(guid);
 
+  n = base+"/enableSharedScoring";
+  pEnableSharedScoringCmd = new G4UIcmdWithABool(n, this);
+  guid = G4String("Use one set of images shared (and filled concurrently) by all the threads instead of one copy per thread");
+  pEnableSharedScoringCmd->SetGuidance(guid);
+
   n = base+"/inputDoseByRegions";
   pDoseRegionInputCmd = new G4UIcmdWithAString(n, this);
   guid = G4String("Image filename to read the region labels.");
@@ -293,9 +309,11 @@ void GateDoseActorMessenger::SetNewValue(G4UIcommand* cmd, G4String newValue)
   if (cmd == pSetDoseAlgorithmCmd) pDoseActor->SetDoseAlgorithmType(newValue);
   if (cmd == pImportMassImageCmd) pDoseActor->ImportMassImage(newValue);
   if (cmd == pExportMassImageCmd) pDoseActor->ExportMassImage(newValue);
+  if (cmd == pMassCacheDirectoryCmd) pDoseActor->SetMassCacheDirectory(newValue);
   if (cmd == pVolumeFilterCmd) pDoseActor->VolumeFilter(newValue);
   if (cmd == pMaterialFilterCmd) pDoseActor->MaterialFilter(newValue);
   if (cmd ==pTestFlagCmd) pDoseActor->setTestFlag(pTestFlagCmd->GetNewBoolValue(newValue));
+  if (cmd == pEnableSharedScoringCmd) pDoseActor->EnableSharedScoring(pEnableSharedScoringCmd->GetNewBoolValue(newValue));
   //Regions
   if (cmd == pDoseRegionInputCmd) pDoseActor->SetDoseByRegionsInputFilename(newValue);
   if (cmd == pDoseRegionOutputCmd) pDoseActor->SetDoseByRegionsOutputFilename(newValue);
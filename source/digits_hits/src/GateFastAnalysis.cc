@@ -103,8 +103,8 @@ void GateFastAnalysis::RecordEndOfEvent(const G4Event* event)
         (*CHC)[iHit]->SetSourcePosition(sourcePosition);
 	(*CHC)[iHit]->SetNPhantomCompton(-1);
 	(*CHC)[iHit]->SetNPhantomRayleigh(-1);
-	(*CHC)[iHit]->SetComptonVolumeName("NULL");
-	(*CHC)[iHit]->SetRayleighVolumeName("NULL");
+	(*CHC)[iHit]->SetComptonVolumeNameID(GateNameTable::kNullID);
+	(*CHC)[iHit]->SetRayleighVolumeNameID(GateNameTable::kNullID);
 	(*CHC)[iHit]->SetPhotonID(-1);
 	(*CHC)[iHit]->SetPrimaryID(-1);
 	(*CHC)[iHit]->SetNCrystalCompton(-1);
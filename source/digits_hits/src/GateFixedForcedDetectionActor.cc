@@ -650,7 +650,7 @@ void GateFixedForcedDetectionActor::UserSteppingAction(const GateVVolume * v, co
           && step->GetTrack()->GetDefinition()->GetParticleName() == "gamma")
         {
 
-        ForceDetectionOfInteraction(GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID(),
+        ForceDetectionOfInteraction(G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(),
                                     G4String("IsotropicPrimary"),
                                     step->GetPreStepPoint()->GetPosition(),
                                     step->GetPreStepPoint()->GetMomentumDirection(),
@@ -692,7 +692,7 @@ void GateFixedForcedDetectionActor::UserSteppingAction(const GateVVolume * v, co
         if (nameSecondary == G4String("gamma"))
           {
 
-          ForceDetectionOfInteraction(GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID(),
+          ForceDetectionOfInteraction(G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(),
                                       process->GetProcessName(),
                                       step->GetPostStepPoint()->GetPosition(),
                                       (*list)[i]->GetMomentumDirection(),
@@ -708,7 +708,7 @@ void GateFixedForcedDetectionActor::UserSteppingAction(const GateVVolume * v, co
       }
     else
       {
-      ForceDetectionOfInteraction(GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID(),
+      ForceDetectionOfInteraction(G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID(),
                                   process->GetProcessName(),
                                   step->GetPostStepPoint()->GetPosition(),
                                   step->GetPreStepPoint()->GetMomentumDirection(),
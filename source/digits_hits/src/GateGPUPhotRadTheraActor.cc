@@ -211,7 +211,7 @@ void GateGPUPhotRadTheraActor::UserSteppingAction(const GateVVolume * /*v*/,
     // Store a photon
     cpu_photons.E[ct_photons] = preStep->GetKineticEnergy()/MeV;
     cpu_photons.eventID[ct_photons] = 
-                          GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+                          G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
     cpu_photons.trackID[ct_photons] = step->GetTrack()->GetTrackID();
     cpu_photons.t[ct_photons] = preStep->GetGlobalTime();
     cpu_photons.type[ct_photons] = 22; // G4_gamma
@@ -107,8 +107,8 @@ void GateHitConvertor::ProcessOneHit(const GateCrystalHit* hit,GatePulseList* pu
   pulse->SetNCrystalCompton( hit->GetNCrystalCompton() );
   pulse->SetNPhantomRayleigh( hit->GetNPhantomRayleigh() );
   pulse->SetNCrystalRayleigh( hit->GetNCrystalRayleigh() );
-  pulse->SetComptonVolumeName( hit->GetComptonVolumeName() );
-  pulse->SetRayleighVolumeName( hit->GetRayleighVolumeName() );
+  pulse->SetComptonVolumeNameID( hit->GetComptonVolumeNameID() );
+  pulse->SetRayleighVolumeNameID( hit->GetRayleighVolumeNameID() );
   pulse->SetVolumeID( hit->GetVolumeID() );
   pulse->SetScannerPos( hit->GetScannerPos() );
   pulse->SetScannerRotAngle( hit->GetScannerRotAngle() );
@@ -117,13 +117,13 @@ void GateHitConvertor::ProcessOneHit(const GateCrystalHit* hit,GatePulseList* pu
 #endif
   pulse->SetNSeptal( hit->GetNSeptal() );  // HDS : septal penetration
 
-  if (hit->GetComptonVolumeName().empty()) {
-    pulse->SetComptonVolumeName( "NULL" );
+  if (hit->GetComptonVolumeNameID() == GateNameTable::kEmptyID) {
+    pulse->SetComptonVolumeNameID( GateNameTable::kNullID );
     pulse->SetSourceID( -1 );
   }
 
-  if (hit->GetRayleighVolumeName().empty()) {
-    pulse->SetRayleighVolumeName( "NULL" );
+  if (hit->GetRayleighVolumeNameID() == GateNameTable::kEmptyID) {
+    pulse->SetRayleighVolumeNameID( GateNameTable::kNullID );
     pulse->SetSourceID( -1 );
   }
 
@@ -11,9 +11,28 @@
 #ifndef GATEIMAGEWITHSTATISTIC_CC
 #define GATEIMAGEWITHSTATISTIC_CC
 
+#include "GateConfiguration.h"
 #include "GateImageWithStatistic.hh"
+#include <memory>
 #include "GateMessageManager.hh"
 #include "GateMiscFunctions.hh"
+#include "G4Types.hh"
+
+#include <atomic>
+
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+namespace { G4Mutex eventBufferMutex = G4MUTEX_INITIALIZER; }
+#endif
+
+namespace {
+  // Event buffers of the calling thread, indexed by the event buffer
+  // index of the images (owned by the images)
+  G4ThreadLocal std::vector<GateImageWithStatistic::EventBuffer*> * threadEventBuffers = 0;
+  // Indices are never reused, so that the entry of a deleted image is
+  // never read again
+  std::atomic<int> nextEventBufferIndex(0);
+}
 
 //-----------------------------------------------------------------------------
 /// Constructor
@@ -21,6 +40,8 @@ GateImageWithStatistic::GateImageWithStatistic()  {
   mIsSquaredImageEnabled = false;
   mIsUncertaintyImageEnabled = false;
   mIsValuesMustBeScaled = false;
+  mIsSharedScoringEnabled = false;
+  mEventBufferIndex = -1;
   mOverWriteFilesFlag = true;
   mNormalizedToMax = false;
   mNormalizedToIntegral = false;
@@ -31,6 +52,8 @@ GateImageWithStatistic::GateImageWithStatistic()  {
 //-----------------------------------------------------------------------------
 /// Destructor
 GateImageWithStatistic::~GateImageWithStatistic()  {
+  // Buffers of all the threads
+  for (size_t i=0; i<mEventBuffers.size(); i++) delete mEventBuffers[i];
 }
 //-----------------------------------------------------------------------------
 
@@ -108,13 +131,13 @@ void GateImageWithStatistic::Allocate() {
     mUncertaintyImage.Allocate();
     if (!mIsSquaredImageEnabled) {
       mSquaredImage.Allocate();
-      mTempImage.Allocate();
+      if (!mIsSharedScoringEnabled) mTempImage.Allocate();
       if (mIsValuesMustBeScaled) mScaledSquaredImage.Allocate();
     }
   }
   if (mIsSquaredImageEnabled) {
     mSquaredImage.Allocate();
-    mTempImage.Allocate();
+    if (!mIsSharedScoringEnabled) mTempImage.Allocate();
     if (mIsValuesMustBeScaled) mScaledSquaredImage.Allocate();
   }
   if (mIsValuesMustBeScaled) mScaledValueImage.Allocate();
@@ -124,6 +147,10 @@ void GateImageWithStatistic::Allocate() {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::Reset(double val) {
+  for (size_t i=0; i<mEventBuffers.size(); i++) {
+    mEventBuffers[i]->eventID = -1;
+    mEventBuffers[i]->values.clear();
+  }
   mValueImage.Fill(val);
   if (mIsUncertaintyImageEnabled) {
     mUncertaintyImage.Fill(0.0);
@@ -167,7 +194,8 @@ void GateImageWithStatistic::SetValue(const int index, double value) {
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::AddValue(const int index, double value) {
   GateDebugMessage("Actor", 2, "AddValue index=" << index << " value=" << value << Gateendl);
-  mValueImage.AddValue(index, value);
+  if (mIsSharedScoringEnabled) AtomicAdd(*(mValueImage.begin()+index), value);
+  else mValueImage.AddValue(index, value);
 }
 //-----------------------------------------------------------------------------
 
@@ -193,6 +221,88 @@ void GateImageWithStatistic::AddValueAndUpdate(const int index, double value) {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::AddValueInEvent(const int eventID, const int index, double value) {
+  if (!mIsSquaredImageEnabled && !mIsUncertaintyImageEnabled) {
+    AddValue(index, value);
+    return;
+  }
+  EventBuffer & buffer = GetThreadEventBuffer();
+  if (buffer.eventID != eventID) {
+    FlushEvent();
+    buffer.eventID = eventID;
+  }
+  buffer.values[index] += value;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::EnableSharedScoring(bool b) {
+  mIsSharedScoringEnabled = b;
+  if (b && mEventBufferIndex < 0) mEventBufferIndex = nextEventBufferIndex++;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Buffer of the calling thread, created at its first event
+GateImageWithStatistic::EventBuffer & GateImageWithStatistic::GetThreadEventBuffer() {
+  if (!threadEventBuffers) threadEventBuffers = new std::vector<EventBuffer*>;
+  std::vector<EventBuffer*> & buffers = *threadEventBuffers;
+  if ((int)buffers.size() <= mEventBufferIndex) buffers.resize(mEventBufferIndex+1, 0);
+  EventBuffer * & buffer = buffers[mEventBufferIndex];
+  if (!buffer) {
+    buffer = new EventBuffer;
+#ifdef GATE_USE_MT
+    G4AutoLock lock(&eventBufferMutex);
+#endif
+    mEventBuffers.push_back(buffer);
+  }
+  return *buffer;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Move the values of the last event of the calling thread into the value
+// and squared images
+void GateImageWithStatistic::FlushEvent() {
+  if (!threadEventBuffers || mEventBufferIndex < 0 ||
+      (int)threadEventBuffers->size() <= mEventBufferIndex) return;
+  EventBuffer * buffer = (*threadEventBuffers)[mEventBufferIndex];
+  if (!buffer) return;
+  std::unordered_map<int, double> & values = buffer->values;
+  for (std::unordered_map<int, double>::const_iterator pi = values.begin(); pi != values.end(); ++pi) {
+    AtomicAdd(*(mValueImage.begin()+pi->first), pi->second);
+    AtomicAdd(*(mSquaredImage.begin()+pi->first), pi->second*pi->second);
+  }
+  values.clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Compare-and-swap loop (there is no atomic fetch_add for double in C++11)
+void GateImageWithStatistic::AtomicAdd(double & target, double value) {
+  double expected;
+  double desired;
+  __atomic_load(&target, &expected, __ATOMIC_RELAXED);
+  do {
+    desired = expected + value;
+  } while (!__atomic_compare_exchange(&target, &expected, &desired, true,
+                                      __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::AtomicAdd(int & target, int value) {
+  __atomic_fetch_add(&target, value, __ATOMIC_RELAXED);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SetFilename(G4String f) {
   mFilename = f;
@@ -208,6 +318,25 @@ void GateImageWithStatistic::SetFilename(G4String f) {
 
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
+  PrepareSave();
+  WriteImages(numberOfEvents, normalise);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateSnapshotWriter::Task GateImageWithStatistic::CreateSaveTask(int numberOfEvents, bool normalise) {
+  PrepareSave();
+  std::shared_ptr<GateImageWithStatistic> snapshot(CreateSnapshot());
+  return [snapshot, numberOfEvents, normalise]() {
+    snapshot->WriteImages(numberOfEvents, normalise);
+  };
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::PrepareSave() {
 
   // Filename
   if (!mOverWriteFilesFlag) {
@@ -216,13 +345,53 @@ void GateImageWithStatistic::SaveData(int numberOfEvents, bool normalise) {
     mUncertaintyFilename = GetSaveCurrentFilename(mUncertaintyInitialFilename);
   }
 
-  double factor=1.0;
-  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) { UpdateImage(); }
-  if (mIsSquaredImageEnabled) { UpdateSquaredImage(); }
-  if (mIsUncertaintyImageEnabled) {
-    if (!mIsSquaredImageEnabled) UpdateSquaredImage();
-    UpdateUncertaintyImage(numberOfEvents);
+  // Bring the value and squared images up to date
+  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {
+    if (mIsSharedScoringEnabled) {
+      // (the other threads have flushed their buffers at the end of their events)
+      FlushEvent();
+    }
+    else {
+      UpdateImage();
+      UpdateSquaredImage();
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateImageWithStatistic * GateImageWithStatistic::CreateSnapshot() const {
+  // Only the images read by WriteImages are copied (no temporary image)
+  GateImageWithStatistic * snapshot = new GateImageWithStatistic;
+  snapshot->mOverWriteFilesFlag = true; // filenames are already set
+  snapshot->mNormalizedToMax = mNormalizedToMax;
+  snapshot->mNormalizedToIntegral = mNormalizedToIntegral;
+  snapshot->mIsSquaredImageEnabled = mIsSquaredImageEnabled;
+  snapshot->mIsUncertaintyImageEnabled = mIsUncertaintyImageEnabled;
+  snapshot->mIsValuesMustBeScaled = mIsValuesMustBeScaled;
+  snapshot->mScaleFactor = mScaleFactor;
+  snapshot->mFilename = mFilename;
+  snapshot->mSquaredFilename = mSquaredFilename;
+  snapshot->mUncertaintyFilename = mUncertaintyFilename;
+
+  snapshot->mValueImage = mValueImage;
+  snapshot->mScaledValueImage = mScaledValueImage;
+  if (mIsSquaredImageEnabled || mIsUncertaintyImageEnabled) {
+    snapshot->mSquaredImage = mSquaredImage;
+    snapshot->mScaledSquaredImage = mScaledSquaredImage;
   }
+  if (mIsUncertaintyImageEnabled) snapshot->mUncertaintyImage = mUncertaintyImage;
+  return snapshot;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::WriteImages(int numberOfEvents, bool normalise) {
+
+  double factor=1.0;
+  if (mIsUncertaintyImageEnabled) UpdateUncertaintyImage(numberOfEvents);
 
   if (mIsValuesMustBeScaled == true) {
     factor = mScaleFactor;
@@ -302,6 +471,44 @@ void GateImageWithStatistic::UpdateSquaredImage() {
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateImageWithStatistic::Merge(GateImageWithStatistic & other)
+{
+  if (other.mValueImage.GetNumberOfValues() != mValueImage.GetNumberOfValues()) {
+    GateError("Cannot merge images of different sizes ("
+              << other.mValueImage.GetNumberOfValues() << " and "
+              << mValueImage.GetNumberOfValues() << " voxels)");
+  }
+
+  bool squared = mIsSquaredImageEnabled || mIsUncertaintyImageEnabled;
+  if (squared) {
+    other.UpdateImage();
+    other.UpdateSquaredImage();
+  }
+
+  GateImageDouble::iterator pi = mValueImage.begin();
+  GateImageDouble::const_iterator po = other.mValueImage.begin();
+  GateImageDouble::const_iterator pe = mValueImage.end();
+  while (pi != pe) {
+    *pi += *po;
+    ++pi;
+    ++po;
+  }
+
+  if (squared) {
+    pi = mSquaredImage.begin();
+    po = other.mSquaredImage.begin();
+    pe = mSquaredImage.end();
+    while (pi != pe) {
+      *pi += *po;
+      ++pi;
+      ++po;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateImageWithStatistic::UpdateUncertaintyImage(int numberOfEvents)
 {
@@ -15,6 +15,7 @@
 // gate
 #include "GateLETActor.hh"
 #include "GateMiscFunctions.hh"
+#include "GateDEDXCache.hh"
 
 // g4
 #include <G4EmCalculator.hh>
@@ -34,6 +35,7 @@ GateLETActor::GateLETActor(G4String name, G4int depth):
   mIsAverageKinEnergy=false;
 
   mIsLETtoWaterEnabled = false;
+  mWater = 0;
   mIsParallelCalculationEnabled = false;
   mAveragingType = "DoseAverage";
   pMessenger = new GateLETActorMessenger(this);
@@ -59,7 +61,7 @@ void GateLETActor::Construct() {
 
   // Find G4_WATER. This it needed here because we will used this
   // material for dedx computation for LETtoWater.
-  G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
+  mWater = G4NistManager::Instance()->FindOrBuildMaterial("G4_WATER");
 
   // Enable callbacks
   EnableBeginOfRunAction(true);
@@ -172,6 +174,8 @@ void GateLETActor::ResetData() {
 void GateLETActor::BeginOfRunAction(const G4Run * r) {
   GateVActor::BeginOfRunAction(r);
   GateDebugMessage("Actor", 3, "GateLETActor -- Begin of Run\n");
+  // physics tables may have changed
+  GateDEDXCache::Invalidate();
   // ResetData(); // Do no reset here !! (when multiple run);
 }
 //-----------------------------------------------------------------------------
@@ -220,7 +224,8 @@ void GateLETActor::UserSteppingActionInVoxel(const int index, const G4Step* step
 
   // Compute the dedx for the current particle in the current material
   double weightedLET =0;
-  G4double dedx = emcalc->ComputeElectronicDEDX(energy, partname, material);
+  GateDEDXCache * dedxCache = GateDEDXCache::GetInstance();
+  G4double dedx = dedxCache->GetElectronicDEDX(energy, partname, material);
 
 
   double normalizationVal = 0;
@@ -246,7 +251,7 @@ void GateLETActor::UserSteppingActionInVoxel(const int index, const G4Step* step
   }
 
   if (mIsLETtoWaterEnabled){
-    weightedLET = (weightedLET/dedx)*	emcalc->ComputeTotalDEDX(energy, partname->GetParticleName(), "G4_WATER") ;
+    weightedLET = (weightedLET/dedx)*	dedxCache->GetTotalDEDX(energy, partname, mWater) ;
   }
 
   mWeightedLETImage.AddValue(index, weightedLET);
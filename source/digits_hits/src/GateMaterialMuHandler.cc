@@ -6,11 +6,14 @@
 #include "GateMuDatabase.hh"
 #include "GateMiscFunctions.hh"
 #include "GateConfiguration.h"
+#include "GatePhysicsTableCache.hh"
 #include <string>
 #include <sstream>
+#include <iomanip>
 #include <iostream>
 #include <fstream>
 #include <map>
+#include <algorithm>
 
 using std::map;
 using std::string;
@@ -31,8 +34,8 @@ GateMaterialMuHandler::GateMaterialMuHandler()
   mEnergyNumber = 40;
   mAtomicShellEnergyMin = 1. * keV;
   mPrecision = 0.01;
+  mLookupBinsPerOctave = 64;
 
-  mLastCouple = 0;
   mLastMuTable = 0;
 }
 //-----------------------------------------------------------------------------
@@ -49,9 +52,26 @@ void GateMaterialMuHandler::CheckLastCall(const G4MaterialCutsCouple* couple)
 {
   if(!mIsInitialized) { Initialize(); }
 
-  if(couple != mLastCouple) {
-    mLastCouple = couple;
-    mLastMuTable = mCoupleTable[mLastCouple];
+  size_t index = couple->GetIndex();
+  if(index >= mCoupleIndexTable.size() || !mCoupleIndexTable[index]) {
+    // couple created after the initialization
+    mCoupleIndexTable.resize(std::max(mCoupleIndexTable.size(), index+1), 0);
+    mCoupleIndexTable[index] = mCoupleTable[couple];
+  }
+  mLastMuTable = mCoupleIndexTable[index];
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateMaterialMuHandler::BuildCoupleIndexTable()
+{
+  mCoupleIndexTable.clear();
+  map<const G4MaterialCutsCouple *, GateMuTable *>::iterator it;
+  for(it = mCoupleTable.begin(); it != mCoupleTable.end(); it++)
+  {
+    size_t index = it->first->GetIndex();
+    if(index >= mCoupleIndexTable.size()) { mCoupleIndexTable.resize(index+1, 0); }
+    mCoupleIndexTable[index] = it->second;
   }
 }
 //-----------------------------------------------------------------------------
@@ -115,7 +135,14 @@ void GateMaterialMuHandler::Initialize()
 {
   if(mDatabaseName == "simulated")
   {
-    SimulateMaterialTable();
+    GatePhysicsTableCache *cache = GatePhysicsTableCache::GetInstance();
+    unsigned long long hash = 0;
+    if(cache->IsEnabled()) { hash = GetMuTableCacheHash(); }
+    if(!cache->IsEnabled() || !ReadMuTableCache(hash))
+    {
+      SimulateMaterialTable();
+      if(cache->IsStoringEnabled()) { WriteMuTableCache(hash); }
+    }
   }
   else if(mDatabaseName == "NIST" || mDatabaseName == "EPDL")
   {
@@ -154,6 +181,7 @@ void GateMaterialMuHandler::Initialize()
     GateError("GateMaterialMuHandler -- mu/muen database option '" << mDatabaseName << "' doesn't exist. Available database are 'NIST', 'EPDL' and 'user'");
   }
 
+  BuildCoupleIndexTable();
   mIsInitialized = true;
 }
 //-----------------------------------------------------------------------------
@@ -257,6 +285,7 @@ void GateMaterialMuHandler::ConstructMaterial(const G4MaterialCutsCouple *couple
     table->PutValue(i, log(energies[i]), log(Mu[i]), log(MuEn[i]));
   }
   GateMessage("Physic",3," \n");
+  table->BuildLookupGrid(mLookupBinsPerOctave);
 
   mCoupleTable.insert(std::pair<const G4MaterialCutsCouple *, GateMuTable *>(couple,table));
 
@@ -517,12 +546,117 @@ void GateMaterialMuHandler::SimulateMaterialTable()
 	GateMessage("Physic",3," " << muStorage[e].energy << " " << muStorage[e].mu << " " << muStorage[e].muen << Gateendl);
       }
       GateMessage("Physic",3," \n");
+      table->BuildLookupGrid(mLookupBinsPerOctave);
       mCoupleTable.insert(std::pair<const G4MaterialCutsCouple *, GateMuTable *>(couple,table));
     }
   }
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+unsigned long long GateMaterialMuHandler::GetMuTableCacheHash()
+{
+  // The simulated tables depend on the models, the cuts of the couples,
+  // the fluorescence and the simulation options
+  GatePhysicsTableCache *cache = GatePhysicsTableCache::GetInstance();
+  bool isFluoActive = false;
+  if(G4LossTableManager::Instance()->AtomDeexcitation()) { isFluoActive = G4LossTableManager::Instance()->AtomDeexcitation()->IsFluoActive();}
+
+  std::ostringstream description;
+  description << std::setprecision(17)
+              << cache->GetPhysicsDescription() << cache->GetCouplesDescription()
+              << "MuHandler " << mEnergyMin << " " << mEnergyMax << " " << mEnergyNumber << " "
+              << mAtomicShellEnergyMin << " " << mPrecision << " " << isFluoActive << "\n";
+  return GatePhysicsTableCache::Hash(description.str());
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+bool GateMaterialMuHandler::ReadMuTableCache(unsigned long long hash)
+{
+  const G4String fileName = GatePhysicsTableCache::GetInstance()->GetFileName("mu", hash, ".bin");
+  std::ifstream is(fileName.c_str(), std::ios::in | std::ios::binary);
+  if(!is) { return false; }
+
+  G4ProductionCutsTable *productionCutList = G4ProductionCutsTable::GetProductionCutsTable();
+  unsigned long long fileHash(0), nbOfCouples(0);
+  is.read((char*)&fileHash,    sizeof(fileHash));
+  is.read((char*)&nbOfCouples, sizeof(nbOfCouples));
+  if(!is || fileHash != hash || nbOfCouples != productionCutList->GetTableSize()) {
+    GateWarning("Mu/muen table cache " << fileName << " does not match the materials. Ignored.");
+    return false;
+  }
+
+  // One table per couple, in the order of the production cuts table
+  std::vector<GateMuTable *> tables;
+  for(unsigned int m=0; m<nbOfCouples && is; m++)
+  {
+    G4int size(0);
+    is.read((char*)&size, sizeof(size));
+    if(!is || size <= 0) { break; }
+    std::vector<double> values(3*size);
+    is.read((char*)&values[0], values.size()*sizeof(double));
+    if(!is) { break; }
+
+    GateMuTable *table = new GateMuTable(productionCutList->GetMaterialCutsCouple(m), size);
+    for(int e=0; e<size; e++) { table->PutValue(e, values[3*e], values[3*e+1], values[3*e+2]); }
+    table->BuildLookupGrid(mLookupBinsPerOctave);
+    tables.push_back(table);
+  }
+  if(tables.size() != nbOfCouples) {
+    GateWarning("Mu/muen table cache " << fileName << " is truncated. Ignored.");
+    for(unsigned int m=0; m<tables.size(); m++) { delete tables[m]; }
+    return false;
+  }
+
+  for(unsigned int m=0; m<tables.size(); m++) {
+    mCoupleTable.insert(std::pair<const G4MaterialCutsCouple *, GateMuTable *>(productionCutList->GetMaterialCutsCouple(m),tables[m]));
+  }
+  GateMessage("Physic",1,"Mu/muen tables read from " << fileName << Gateendl);
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateMaterialMuHandler::WriteMuTableCache(unsigned long long hash)
+{
+  GatePhysicsTableCache *cache = GatePhysicsTableCache::GetInstance();
+  const G4String fileName = cache->GetFileName("mu", hash, ".bin");
+  const G4String tmpName = cache->GetTemporaryName(fileName);
+  std::ofstream os(tmpName.c_str(), std::ios::out | std::ios::binary);
+  if(!os) {
+    GateWarning("Cannot write the mu/muen table cache in " << cache->GetDirectory());
+    return;
+  }
+
+  G4ProductionCutsTable *productionCutList = G4ProductionCutsTable::GetProductionCutsTable();
+  const unsigned long long nbOfCouples(productionCutList->GetTableSize());
+  os.write((const char*)&hash,        sizeof(hash));
+  os.write((const char*)&nbOfCouples, sizeof(nbOfCouples));
+  for(unsigned int m=0; m<nbOfCouples; m++)
+  {
+    GateMuTable *table = mCoupleTable[productionCutList->GetMaterialCutsCouple(m)];
+    G4int size = table->GetSize();
+    std::vector<double> values(3*size);
+    for(int e=0; e<size; e++) {
+      values[3*e]   = table->GetEnergies()[e];
+      values[3*e+1] = table->GetMuTable()[e];
+      values[3*e+2] = table->GetMuEnTable()[e];
+    }
+    os.write((const char*)&size, sizeof(size));
+    os.write((const char*)&values[0], values.size()*sizeof(double));
+  }
+  os.close();
+
+  if(!os || !cache->Commit(tmpName, fileName)) {
+    GateWarning("Cannot write the mu/muen table cache " << fileName);
+  }
+  else {
+    GateMessage("Physic",1,"Mu/muen tables stored in " << fileName << Gateendl);
+  }
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 double GateMaterialMuHandler::ProcessOneShot(G4VEmModel *model,std::vector<G4DynamicParticle*> *secondaries, const G4MaterialCutsCouple *couple, const G4DynamicParticle *primary)
 {
@@ -3,6 +3,8 @@
 #include "GateMuTables.hh"
 #include "GateMiscFunctions.hh"
 
+#include <cmath>
+
 //-----------------------------------------------------------------------------
 GateMuTable::GateMuTable(const G4MaterialCutsCouple *couple, G4int size)
 {
@@ -10,10 +12,9 @@ GateMuTable::GateMuTable(const G4MaterialCutsCouple *couple, G4int size)
   mMu = new double[size];
   mMu_en = new double[size];
   mSize = size;
-  lastMu = -1.0;
-  lastMuen = -1.0;
-  lastEnergyMu = -1.0;
-  lastEnergyMuen = -1.0;
+  mGridBinsPerOctave = 0;
+  mGridFirstExponent = 0;
+  mGridNumberOfBins = 0;
 
   mCouple = couple;
   mDensity = -1;
@@ -53,30 +54,97 @@ inline double interpol(double x1, double x, double x2,
 //-----------------------------------------------------------------------------
 
 //-----------------------------------------------------------------------------
-double GateMuTable::GetMuEnOverRho(double energy)
+// Log-log interpolation in the original table (energies and values are
+// stored as logarithms)
+double GateMuTable::ComputeFromTable(double energy, const double *table) const
+{
+  energy = log(energy);
+
+  int inf = 0;
+  int sup = mSize-1;
+  while(sup - inf > 1)
+  {
+    int tmp_bound = (inf + sup)/2;
+    if(mEnergy[tmp_bound] > energy) { sup = tmp_bound; }
+    else { inf = tmp_bound; }
+  }
+  double e_inf = mEnergy[inf];
+  double e_sup = mEnergy[sup];
+
+  if( energy > e_inf && energy < e_sup) { return exp(interpol(e_inf, energy, e_sup, table[inf], table[sup])); }
+  if( energy >= e_sup) { return exp(table[sup]); }
+  return exp(table[inf]);
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateMuTable::BuildLookupGrid(int binsPerOctave)
 {
-  if (energy != lastEnergyMuen)
+  mGridMu.clear();
+  mGridMu_en.clear();
+  mGridIsExactBin.clear();
+  mGridBinsPerOctave = 0;
+  mGridNumberOfBins = 0;
+  if(binsPerOctave <= 0 || mSize < 2) { return; }
+
+  // The octave of exponent x (as given by frexp) is [2^(x-1), 2^x[
+  int lastExponent;
+  frexp(exp(mEnergy[0]), &mGridFirstExponent);
+  frexp(exp(mEnergy[mSize-1]), &lastExponent);
+  mGridBinsPerOctave = binsPerOctave;
+  mGridNumberOfBins = (lastExponent - mGridFirstExponent + 1) * binsPerOctave;
+
+  mGridMu.resize(mGridNumberOfBins+1);
+  mGridMu_en.resize(mGridNumberOfBins+1);
+  for(int i = 0; i <= mGridNumberOfBins; i++)
   {
-    lastEnergyMuen = energy;
-
-    energy = log(energy);
-
-    int inf = 0;
-    int sup = mSize-1;
-    while(sup - inf > 1)
-    {
-      int tmp_bound = (inf + sup)/2;
-      if(mEnergy[tmp_bound] > energy) { sup = tmp_bound; }
-      else { inf = tmp_bound; }
-    }
-    double e_inf = mEnergy[inf];
-    double e_sup = mEnergy[sup];
-
-    if( energy > e_inf && energy < e_sup) { lastMuen = exp(interpol(e_inf, energy, e_sup, mMu_en[inf], mMu_en[sup])); }
-    else { lastMuen = exp(mMu_en[inf]); }
+    double energy = ldexp(1. + double(i % binsPerOctave) / binsPerOctave,
+                          mGridFirstExponent - 1 + i / binsPerOctave);
+    mGridMu[i] = ComputeFromTable(energy, mMu);
+    mGridMu_en[i] = ComputeFromTable(energy, mMu_en);
   }
 
-  return lastMuen;
+  // Atomic shell edges are stored as two values for the same (or almost
+  // the same) energy, and the table is clamped outside of its range: the
+  // bins around these points cannot be interpolated linearly
+  double logBinWidth = log(2.) / binsPerOctave;
+  mGridIsExactBin.assign(mGridNumberOfBins, false);
+  for(int i = 0; i < mSize; i++)
+  {
+    bool isEdge = (i > 0 && mEnergy[i] - mEnergy[i-1] < logBinWidth);
+    if(!isEdge && i != 0 && i != mSize-1) { continue; }
+    int bin;
+    double frac;
+    FindGridBin(exp(mEnergy[i]), bin, frac);
+    mGridIsExactBin[bin] = true;
+    if(bin > 0) { mGridIsExactBin[bin-1] = true; }
+  }
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// Returns false if the bin must use the exact interpolation
+bool GateMuTable::FindGridBin(double energy, int & bin, double & frac) const
+{
+  int exponent;
+  double x = (2. * frexp(energy, &exponent) - 1.) * mGridBinsPerOctave;
+  int sub = int(x);
+  bin = (exponent - mGridFirstExponent) * mGridBinsPerOctave + sub;
+  frac = x - sub;
+  if(bin < 0) { bin = 0; frac = 0.; }
+  else if(bin >= mGridNumberOfBins) { bin = mGridNumberOfBins - 1; frac = 1.; }
+  return !mGridIsExactBin[bin];
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+double GateMuTable::GetMuEnOverRho(double energy)
+{
+  int bin;
+  double frac;
+  if(mGridBinsPerOctave && FindGridBin(energy, bin, frac))
+    return mGridMu_en[bin] + frac * (mGridMu_en[bin+1] - mGridMu_en[bin]);
+  return ComputeFromTable(energy, mMu_en);
 }
 //-----------------------------------------------------------------------------
 
@@ -90,28 +158,11 @@ double GateMuTable::GetMuEn(double energy)
 //-----------------------------------------------------------------------------
 double GateMuTable::GetMuOverRho(double energy)
 {
-  if (energy != lastEnergyMu)
-  {
-    lastEnergyMu = energy;
-
-    energy = log(energy);
-
-    int inf = 0;
-    int sup = mSize-1;
-    while(sup - inf > 1)
-    {
-      int tmp_bound = (inf + sup)/2;
-      if(mEnergy[tmp_bound] > energy) { sup = tmp_bound; }
-      else { inf = tmp_bound; }
-    }
-    double e_inf = mEnergy[inf];
-    double e_sup = mEnergy[sup];
-
-    if( energy > e_inf && energy < e_sup) { lastMu = exp(interpol(e_inf, energy, e_sup, mMu[inf], mMu[sup])); }
-    else { lastMu = exp(mMu[inf]); }
-  }
-
-  return lastMu;
+  int bin;
+  double frac;
+  if(mGridBinsPerOctave && FindGridBin(energy, bin, frac))
+    return mGridMu[bin] + frac * (mGridMu[bin+1] - mGridMu[bin]);
+  return ComputeFromTable(energy, mMu);
 }
 //-----------------------------------------------------------------------------
 
@@ -35,6 +35,13 @@
 #include "GateARFDataToRoot.hh"
 #include "GateToRoot.hh"
 
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+// The output modules (and the digitizer behind GateToDigi) are shared by all
+// the worker threads: their event and step callbacks are serialized.
+namespace { G4Mutex outputMgrMutex = G4MUTEX_INITIALIZER; }
+#endif
+
 GateOutputMgr* GateOutputMgr::instance = 0;
 
 
@@ -146,10 +153,17 @@ void GateOutputMgr::RecordBeginOfEvent(const G4Event* event)
 {
   GateMessage("Output", 5, "GateOutputMgr::RecordBeginOfEvent\n";);
 
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&outputMgrMutex);
+#endif
+
 
   for (size_t iMod=0; iMod<m_outputModules.size(); iMod++) {
     if ( m_outputModules[iMod]->IsEnabled() )
-      m_outputModules[iMod]->RecordBeginOfEvent(event);
+      {
+        GateProfilerScope scope(GetProfilerSection(iMod, kProfiledBeginOfEvent));
+        m_outputModules[iMod]->RecordBeginOfEvent(event);
+      }
   }
 }
 //----------------------------------------------------------------------------------
@@ -160,6 +174,10 @@ void GateOutputMgr::RecordEndOfEvent(const G4Event* event)
 {
   GateMessage("Output", 5, "GateOutputMgr::RecordEndOfEvent\n";);
 
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&outputMgrMutex);
+#endif
+
 #ifdef G4ANALYSIS_USE_ROOT
   if (m_digiMode==kofflineMode)
     GateHitFileReader::GetInstance()->PrepareEndOfEvent();
@@ -168,6 +186,7 @@ void GateOutputMgr::RecordEndOfEvent(const G4Event* event)
   for (size_t iMod=0; iMod<m_outputModules.size(); iMod++) {
     if ( m_outputModules[iMod]->IsEnabled() )
       {
+        GateProfilerScope scope(GetProfilerSection(iMod, kProfiledEndOfEvent));
         m_outputModules[iMod]->RecordEndOfEvent(event);
       }
   }
@@ -234,6 +253,9 @@ void GateOutputMgr::RecordBeginOfAcquisition()
   }
   m_acquisitionStarted = true;
 
+  // The step callbacks may run concurrently: build the profiler sections now
+  if (GateProfiler::IsEnabled()) CreateProfilerSections();
+
   // Start the timer
   m_timer.Start();
 
@@ -281,13 +303,37 @@ void GateOutputMgr::RecordStepWithVolume(const GateVVolume * v, const G4Step* st
   if (nVerboseLevel > 2)
     G4cout << "GateOutputMgr::RecordStep\n";
 
+  // Only the modules that record steps are called. In MT, only those which
+  // keep their step data in the tracking thread are called without lock:
+  // they hand them over at the end of the event
   for (size_t iMod=0; iMod<m_outputModules.size(); iMod++) {
-    if ( m_outputModules[iMod]->IsEnabled() )
-      m_outputModules[iMod]->RecordStepWithVolume(v, step);
+    GateVOutputModule * module = m_outputModules[iMod];
+    if ( !module->IsEnabled() || !module->IsRecordingSteps() ) continue;
+    GateProfilerScope scope(GetProfilerSection(iMod, kProfiledStep));
+#ifdef GATE_USE_MT
+    if ( !module->IsStepRecordingThreadLocal() ) {
+      G4AutoLock lock(&outputMgrMutex);
+      module->RecordStepWithVolume(v, step);
+      continue;
+    }
+#endif
+    module->RecordStepWithVolume(v, step);
   }
 }
 //----------------------------------------------------------------------------------
 
+
+//----------------------------------------------------------------------------------
+void GateOutputMgr::CreateProfilerSections()
+{
+  static const char * names[kNumberOfProfiledCallbacks] = { "RecordBeginOfEvent", "RecordEndOfEvent", "RecordStepWithVolume" };
+  m_profilerSections.clear();
+  for (size_t iMod=0; iMod<m_outputModules.size(); iMod++)
+    for (int i=0; i<kNumberOfProfiledCallbacks; i++)
+      m_profilerSections.push_back(GateProfiler::GetSection("Output", m_outputModules[iMod]->GetName() + " " + names[i]));
+}
+//----------------------------------------------------------------------------------
+
 //----------------------------------------------------------------------------------
 void GateOutputMgr::RecordVoxels(GateVGeometryVoxelStore* voxelStore)
 {
@@ -556,8 +602,9 @@ void GateOutputMgr::UserSteppingAction(const GateVVolume * /*v*/, const G4Step *
 
 void GateOutputMgr::RecordTracks(GateSteppingAction* mySteppingAction){
 
-
-
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&outputMgrMutex);
+#endif
   for (size_t iMod=0; iMod<m_outputModules.size(); iMod++) {
     if ( m_outputModules[iMod]->IsEnabled() )
       m_outputModules[iMod]->RecordTracks(mySteppingAction);
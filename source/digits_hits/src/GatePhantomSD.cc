@@ -32,6 +32,15 @@ GatePhantomSD::GatePhantomSD(const G4String& name)
 //------------------------------------------------------------------------------
 
 
+//------------------------------------------------------------------------------
+// Copy of the SD for a worker thread
+G4VSensitiveDetector* GatePhantomSD::Clone() const
+{
+  return new GatePhantomSD(SensitiveDetectorName);
+}
+//------------------------------------------------------------------------------
+
+
 /*GatePhantomSD::GatePhantomSD(G4String name)
 :G4VSensitiveDetector(name)
 {
@@ -44,8 +53,7 @@ GatePhantomSD::~GatePhantomSD(){;}
 
 void GatePhantomSD::Initialize(G4HCofThisEvent*HCE)
 {
-  static int HCID = -1;
-  // Not thread safe but moving to local variable doesn't work
+  static G4ThreadLocal int HCID = -1; // one per thread
   phantomCollection = new GatePhantomHitsCollection
                    (SensitiveDetectorName,thePhantomCollectionName);
   if(HCID<0)
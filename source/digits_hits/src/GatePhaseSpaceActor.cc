@@ -79,6 +79,7 @@ GatePhaseSpaceActor::GatePhaseSpaceActor(G4String name, G4int depth):
   mNevent = 0;
   pIAEARecordType = 0;
   pIAEAheader = 0;
+  pBinaryWriter = 0;
   mFileSize = 0;
   GateDebugMessageDec("Actor", 4, "GatePhaseSpaceActor() -- end\n");
 
@@ -98,6 +99,7 @@ GatePhaseSpaceActor::~GatePhaseSpaceActor()
   free(pIAEARecordType);
   pIAEAheader = 0;
   pIAEARecordType = 0;
+  delete pBinaryWriter;
   delete pMessenger;
   GateDebugMessageDec("Actor", 4, "~GatePhaseSpaceActor() -- end\n");
 }
@@ -122,8 +124,9 @@ void GatePhaseSpaceActor::Construct()
 
   if (extension == "root") mFileType = "rootFile";
   else if (extension == "IAEAphsp" || extension == "IAEAheader" ) mFileType = "IAEAFile";
+  else if (extension == "gphsp") mFileType = "binaryFile";
   else GateError( "Unknow phase space file extension. Knowns extensions are : "
-                  << Gateendl << ".IAEAphsp (or IAEAheader), .root\n");
+                  << Gateendl << ".IAEAphsp (or IAEAheader), .root, .gphsp\n");
 
   if (mFileType == "rootFile") {
 
@@ -195,6 +198,10 @@ void GatePhaseSpaceActor::Construct()
       GateWarning("'Mass' is not available in IAEA phase space.");
     }
     if ( pIAEAheader->set_record_contents(pIAEARecordType) == FAIL) GateError("Record contents not setted.");
+  } else if (mFileType == "binaryFile") {
+    // Fixed record: PDG code, energy, position, direction, weight and time
+    pBinaryWriter = new GatePhaseSpaceBinaryWriter;
+    pBinaryWriter->Open(mSaveFilename);
   }
 }
 // --------------------------------------------------------------------
@@ -345,7 +352,7 @@ void GatePhaseSpaceActor::UserSteppingAction(const GateVVolume *, const G4Step *
 
   trackid = step->GetTrack()->GetTrackID();
   parentid = step->GetTrack()->GetParentID();
-  eventid = GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+  eventid = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
   runid   = GateRunManager::GetRunManager()->GetCurrentRun()->GetRunID();
 
   x = localPosition.x();
@@ -439,7 +446,7 @@ void GatePhaseSpaceActor::UserSteppingAction(const GateVVolume *, const G4Step *
                    << " local=" << G4BestUnit(stepPoint->GetLocalTime(), "Time") << Gateendl);
   GateDebugMessage("Actor", 4, "trackid="
                    << step->GetTrack()->GetParentID()
-                   << " event=" << GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID()
+                   << " event=" << G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID()
                    << " run=" << GateRunManager::GetRunManager()->GetCurrentRun()->GetRunID() << Gateendl);
   GateDebugMessage("Actor", 4, "pos = " << x << " " << y  << " " << z << Gateendl);
   GateDebugMessage("Actor", 4, "E = " << G4BestUnit(stepPoint->GetKineticEnergy(), "Energy") << Gateendl);
@@ -521,6 +528,20 @@ void GatePhaseSpaceActor::UserSteppingAction(const GateVVolume *, const G4Step *
     pIAEAheader->update_counters(pIAEARecordType);
 
   }
+  else if (mFileType == "binaryFile") {
+    GatePhaseSpaceBinaryRecord record;
+    record.pdgCode = bPDGCode;
+    record.energy = e;
+    record.x = x;
+    record.y = y;
+    record.z = z;
+    record.dx = dx;
+    record.dy = dy;
+    record.dz = dz;
+    record.weight = w;
+    record.time = t;
+    pBinaryWriter->Write(record);
+  }
   mIsFistStep = false;
 }
 // --------------------------------------------------------------------
@@ -551,6 +572,8 @@ void GatePhaseSpaceActor::SaveData()
 
     fclose(pIAEAheader->fheader);
     fclose(pIAEARecordType->p_file);
+  } else if (mFileType == "binaryFile") {
+    pBinaryWriter->Flush();
   }
 }
 // --------------------------------------------------------------------
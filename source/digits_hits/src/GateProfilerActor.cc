@@ -0,0 +1,284 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*
+  \brief Class GateProfilerActor :
+  \brief
+*/
+
+#ifndef GATEPROFILERACTOR_CC
+#define GATEPROFILERACTOR_CC
+
+#include "GateProfilerActor.hh"
+#include "GateProfiler.hh"
+#include "GateMiscFunctions.hh"
+#include "G4Event.hh"
+
+#include <algorithm>
+#include <cmath>
+
+const double GateProfilerActor::kMinEventTime = 1e-6;
+
+namespace {
+  bool SortByTime(const GateProfiler::Entry & a, const GateProfiler::Entry & b) { return a.seconds > b.seconds; }
+  bool SortBySteps(const std::pair<G4String, long long> & a, const std::pair<G4String, long long> & b) { return a.second > b.second; }
+}
+
+//-----------------------------------------------------------------------------
+/// Constructors (Prototype)
+GateProfilerActor::GateProfilerActor(G4String name, G4int depth):
+  GateVActor(name,depth)
+{
+  GateDebugMessageInc("Actor",4,"GateProfilerActor() -- begin\n");
+  // The actors constructed from now (including this one) are timed
+  GateProfiler::Enable();
+  pMessenger = new GateActorMessenger(this);
+  ResetData();
+  GateDebugMessageDec("Actor",4,"GateProfilerActor() -- end\n");
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+/// Destructor
+GateProfilerActor::~GateProfilerActor()
+{
+  delete pMessenger;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+/// Construct
+void GateProfilerActor::Construct()
+{
+  GateVActor::Construct();
+  // Enable callbacks
+  EnableBeginOfEventAction(true);
+  EnableEndOfEventAction(true);
+  EnableUserSteppingAction(true);
+  ResetData();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Callback Begin Event
+void GateProfilerActor::BeginOfEventAction(const G4Event*e)
+{
+  GateVActor::BeginOfEventAction(e);
+  mEventStart = std::chrono::steady_clock::now();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Callback End Event
+void GateProfilerActor::EndOfEventAction(const G4Event*e)
+{
+  double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - mEventStart).count();
+  mNumberOfEvents++;
+  mTotalEventTime += t;
+  mEventTimeHistogram[GetEventTimeBin(t)]++;
+  GateVActor::EndOfEventAction(e);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateProfilerActor::GetEventTimeBin(double seconds) const
+{
+  const int n = kBinsPerDecade*kNumberOfDecades;
+  if (seconds < kMinEventTime) return 0;
+  double b = std::floor(std::log10(seconds/kMinEventTime)*kBinsPerDecade);
+  if (b >= n) return n+1;
+  return 1 + (int)b;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Callbacks
+void GateProfilerActor::UserSteppingAction(const GateVVolume * v, const G4Step * step)
+{
+  GateVActor::UserSteppingAction(v, step);
+
+  if (GateVVolume::GetGeometryGeneration() != mGeometryGeneration) MoveVolumeCounts();
+
+  const G4VPhysicalVolume * pv = step->GetPreStepPoint()->GetPhysicalVolume();
+  const G4LogicalVolume * lv = (pv ? pv->GetLogicalVolume() : 0);
+  if (lv != pLastVolume || !pLastVolumeSteps) {
+    StepCount & c = mStepsPerVolume[lv];
+    if (c.name.empty()) c.name = (lv ? lv->GetName() : G4String("(none)"));
+    pLastVolume = lv;
+    pLastVolumeSteps = &c.steps;
+  }
+  (*pLastVolumeSteps)++;
+
+  const G4ParticleDefinition * particle = step->GetTrack()->GetDefinition();
+  if (particle != pLastParticle || !pLastParticleSteps) {
+    StepCount & c = mStepsPerParticle[particle];
+    if (c.name.empty()) c.name = particle->GetParticleName();
+    pLastParticle = particle;
+    pLastParticleSteps = &c.steps;
+  }
+  (*pLastParticleSteps)++;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateProfilerActor::MoveVolumeCounts()
+{
+  for (StepCountMap::const_iterator it = mStepsPerVolume.begin(); it != mStepsPerVolume.end(); ++it)
+    mStepsPerVolumeName[it->second.name] += it->second.steps;
+  mStepsPerVolume.clear();
+  pLastVolume = 0;
+  pLastVolumeSteps = 0;
+  mGeometryGeneration = GateVVolume::GetGeometryGeneration();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+/// Save data
+void GateProfilerActor::SaveData()
+{
+  GateVActor::SaveData();
+  std::ofstream os;
+  OpenFileOutput(mSaveFilename, os);
+
+  // Timed sections, the time of a section includes the sections called
+  // inside it
+  std::vector<GateProfiler::Entry> entries = GateProfiler::GetEntries();
+  std::sort(entries.begin(), entries.end(), SortByTime);
+
+  os << "# NumberOfEvents = " << mNumberOfEvents << Gateendl
+     << "# EventTime      = " << mTotalEventTime << " s" << Gateendl
+     << "# MeanEventTime  = " << (mNumberOfEvents ? mTotalEventTime/mNumberOfEvents : 0.0)*1e6 << " us" << Gateendl
+     << "#" << Gateendl
+     << "# Timed sections (inclusive times, % of the event time)" << Gateendl
+     << "# " << std::setw(10) << std::left << "Category"
+     << std::setw(60) << "Name" << std::right
+     << std::setw(14) << "Calls"
+     << std::setw(14) << "Total(s)"
+     << std::setw(14) << "Mean(us)"
+     << std::setw(10) << "%" << Gateendl;
+  for (size_t i=0; i<entries.size(); i++) {
+    const GateProfiler::Entry & e = entries[i];
+    if (e.calls == 0) continue;
+    os << "  " << std::setw(10) << std::left << e.category
+       << std::setw(60) << e.name << std::right
+       << std::setw(14) << e.calls
+       << std::setw(14) << e.seconds
+       << std::setw(14) << e.seconds/e.calls*1e6
+       << std::setw(10) << (mTotalEventTime > 0 ? 100.0*e.seconds/mTotalEventTime : 0.0) << Gateendl;
+  }
+
+  // Steps per logical volume (including the volumes of the previous
+  // geometries) and per particle
+  NamedStepCountMap volumes = mStepsPerVolumeName;
+  for (StepCountMap::const_iterator it = mStepsPerVolume.begin(); it != mStepsPerVolume.end(); ++it)
+    volumes[it->second.name] += it->second.steps;
+  NamedStepCountMap particles;
+  for (StepCountMap::const_iterator it = mStepsPerParticle.begin(); it != mStepsPerParticle.end(); ++it)
+    particles[it->second.name] += it->second.steps;
+
+  const NamedStepCountMap * maps[2] = { &volumes, &particles };
+  const char * titles[2] = { "Steps per logical volume", "Steps per particle" };
+  for (int m=0; m<2; m++) {
+    std::vector<std::pair<G4String, long long> > counts(maps[m]->begin(), maps[m]->end());
+    std::sort(counts.begin(), counts.end(), SortBySteps);
+    os << "#" << Gateendl
+       << "# " << titles[m] << Gateendl;
+    for (size_t i=0; i<counts.size(); i++)
+      os << "  " << std::setw(70) << std::left << counts[i].first << std::right
+         << std::setw(14) << counts[i].second << Gateendl;
+  }
+
+  if (!os) {
+    GateMessage("Output",1,"Error Writing file: " <<mSaveFilename << Gateendl);
+  }
+  os.flush();
+  os.close();
+
+  SaveEventTimeHistogram();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateProfilerActor::SaveEventTimeHistogram()
+{
+  std::string filename = removeExtension(mSaveFilename) + "_eventTime.txt";
+  std::ofstream os;
+  OpenFileOutput(filename, os);
+  os << "# Event time histogram, " << kBinsPerDecade << " bins per decade" << Gateendl
+     << "# Number of events: " << mNumberOfEvents << Gateendl
+     << "# 3 columns: 1) bin low edge (s) 2) bin high edge (s) 3) number of events" << Gateendl;
+  const int n = kBinsPerDecade*kNumberOfDecades;
+  for (int b=0; b<n+2; b++) {
+    double low = (b == 0 ? 0.0 : kMinEventTime*std::pow(10.0, (double)(b-1)/kBinsPerDecade));
+    double high = (b == n+1 ? HUGE_VAL : kMinEventTime*std::pow(10.0, (double)b/kBinsPerDecade));
+    os << low << " " << high << " " << mEventTimeHistogram[b] << Gateendl;
+  }
+  os.flush();
+  os.close();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateProfilerActor::MergeWorkerData(GateVActor * worker)
+{
+  GateProfilerActor * w = dynamic_cast<GateProfilerActor*>(worker);
+  if (!w) GateError("Cannot merge actor " << worker->GetName() << " into ProfilerActor " << GetName());
+  mNumberOfEvents += w->mNumberOfEvents;
+  mTotalEventTime += w->mTotalEventTime;
+  for (size_t b=0; b<mEventTimeHistogram.size(); b++) mEventTimeHistogram[b] += w->mEventTimeHistogram[b];
+
+  // The volumes and the particles are shared by the threads
+  for (StepCountMap::const_iterator it = w->mStepsPerVolume.begin(); it != w->mStepsPerVolume.end(); ++it) {
+    StepCount & c = mStepsPerVolume[it->first];
+    c.name = it->second.name;
+    c.steps += it->second.steps;
+  }
+  for (StepCountMap::const_iterator it = w->mStepsPerParticle.begin(); it != w->mStepsPerParticle.end(); ++it) {
+    StepCount & c = mStepsPerParticle[it->first];
+    c.name = it->second.name;
+    c.steps += it->second.steps;
+  }
+  for (NamedStepCountMap::const_iterator it = w->mStepsPerVolumeName.begin(); it != w->mStepsPerVolumeName.end(); ++it)
+    mStepsPerVolumeName[it->first] += it->second;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateProfilerActor::ResetData()
+{
+  mNumberOfEvents = 0;
+  mTotalEventTime = 0;
+  mEventTimeHistogram.assign(kBinsPerDecade*kNumberOfDecades+2, 0);
+  mStepsPerVolume.clear();
+  mStepsPerParticle.clear();
+  mStepsPerVolumeName.clear();
+  mGeometryGeneration = GateVVolume::GetGeometryGeneration();
+  pLastVolume = 0;
+  pLastVolumeSteps = 0;
+  pLastParticle = 0;
+  pLastParticleSteps = 0;
+  // The worker copies are reset after each merge, the timed sections
+  // are only reset with the master actor
+  if (!IsWorkerActor()) GateProfiler::Reset();
+}
+//-----------------------------------------------------------------------------
+
+
+#endif /* end #define GATEPROFILERACTOR_CC */
@@ -64,8 +64,9 @@ void GatePromptGammaTLEActor::Construct()
   data.Read(mInputDataFilename);
   data.InitializeMaterial(mIsDebugOutputEnabled);
 
-  //set up and allocate runtime images.
-  SetTLEIoH(mImageGamma);
+  //set up and allocate runtime images. Most voxels are never reached
+  //by a proton, so the gamma image only stores the non empty spectra.
+  SetTLEIoH(mImageGamma, true);
   if (mIsDebugOutputEnabled){
     //set up and allocate lasthiteventimage
     SetOriginTransformAndFlagToImage(mLastHitEventImage);
@@ -342,8 +343,9 @@ GateVImageVolume* GatePromptGammaTLEActor::GetPhantom() {
 
 
 //-----------------------------------------------------------------------------
-void GatePromptGammaTLEActor::SetTLEIoH(GateImageOfHistograms*& ioh) {
+void GatePromptGammaTLEActor::SetTLEIoH(GateImageOfHistograms*& ioh, bool sparse) {
   ioh = new GateImageOfHistograms("double");
+  ioh->SetSparseStorage(sparse);
   ioh->SetResolutionAndHalfSize(mResolution, mHalfSize, mPosition);
   ioh->SetOrigin(mOrigin);
   ioh->SetTransformMatrix(mImage.GetTransformMatrix());
@@ -12,6 +12,10 @@ See LICENSE.md for further details
 
 #include "G4UnitsTable.hh"
 
+// The pulses are only created and deleted by the digitizer, which is not
+// run concurrently
+G4Allocator<GatePulse> GatePulseAllocator;
+
 GatePulse::GatePulse(const void* itsMother)
   : m_runID(-1),
     m_eventID(-1),
@@ -20,6 +24,8 @@ GatePulse::GatePulse(const void* itsMother)
     m_energy(0),
     m_nPhantomCompton(-1),
     m_nPhantomRayleigh(-1),
+    m_comptonVolumeName(0),
+    m_RayleighVolumeName(0),
 #ifdef GATE_USE_OPTICAL
     m_optical(false),
 #endif
@@ -0,0 +1,50 @@
+/*----------------------
+   Copyright (C): OpenGATE Collaboration
+
+This software is distributed under the terms
+of the GNU Lesser General  Public Licence (LGPL)
+See LICENSE.md for further details
+----------------------*/
+
+
+#include "GatePulseBatch.hh"
+
+//---------------------------------------------------------------------
+void GatePulseBatch::Fill(const GatePulseList& pulseList)
+{
+  m_pulses.clear();
+  energy.clear();
+  time.clear();
+  posX.clear();
+  posY.clear();
+  posZ.clear();
+
+  for (GatePulseConstIterator iter = pulseList.begin() ; iter != pulseList.end() ; ++iter) {
+    const GatePulse* pulse = *iter;
+    if (!pulse) continue;
+    m_pulses.push_back(pulse);
+    energy.push_back(pulse->GetEnergy());
+    time.push_back(pulse->GetTime());
+    const G4ThreeVector& pos = pulse->GetGlobalPos();
+    posX.push_back(pos.x());
+    posY.push_back(pos.y());
+    posZ.push_back(pos.z());
+  }
+  keep.assign(m_pulses.size(), 1);
+}
+//---------------------------------------------------------------------
+
+
+//---------------------------------------------------------------------
+void GatePulseBatch::AppendKeptPulses(GatePulseList& outputPulseList) const
+{
+  for (size_t i=0 ; i<m_pulses.size() ; ++i) {
+    if (!keep[i]) continue;
+    GatePulse* outputPulse = new GatePulse(*m_pulses[i]);
+    outputPulse->SetEnergy(energy[i]);
+    outputPulse->SetTime(time[i]);
+    outputPulse->SetGlobalPos(G4ThreeVector(posX[i], posY[i], posZ[i]));
+    outputPulseList.push_back(outputPulse);
+  }
+}
+//---------------------------------------------------------------------
@@ -172,6 +172,20 @@ void GateSimulationStatisticActor::SaveData()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateSimulationStatisticActor::MergeWorkerData(GateVActor * worker)
+{
+  GateSimulationStatisticActor * w = dynamic_cast<GateSimulationStatisticActor*>(worker);
+  if (!w) GateError("Cannot merge actor " << worker->GetName() << " into SimulationStatisticActor " << GetName());
+  mNumberOfEvents += w->mNumberOfEvents;
+  mNumberOfTrack += w->mNumberOfTrack;
+  mNumberOfSteps += w->mNumberOfSteps;
+  mNumberOfGeometricalSteps += w->mNumberOfGeometricalSteps;
+  mNumberOfPhysicalSteps += w->mNumberOfPhysicalSteps;
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateSimulationStatisticActor::ResetData()
 {
@@ -0,0 +1,93 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateSnapshotWriter.hh"
+
+//-----------------------------------------------------------------------------
+GateSnapshotWriter * GateSnapshotWriter::GetInstance()
+{
+  static GateSnapshotWriter writer;
+  return &writer;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateSnapshotWriter::GateSnapshotWriter()
+  : mRunningOwner(0), mIsStopped(false)
+{
+  mThread = std::thread(&GateSnapshotWriter::Run, this);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateSnapshotWriter::~GateSnapshotWriter()
+{
+  // Pending snapshots are still written
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mIsStopped = true;
+  }
+  mTaskAvailable.notify_all();
+  mThread.join();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateSnapshotWriter::Submit(const void * owner, Task task)
+{
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::deque<std::pair<const void *, Task> >::iterator it = mTasks.begin();
+    while (it != mTasks.end() && it->first != owner) ++it;
+    if (it != mTasks.end()) it->second = task;
+    else mTasks.push_back(std::make_pair(owner, task));
+  }
+  mTaskAvailable.notify_one();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateSnapshotWriter::Wait(const void * owner)
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  std::deque<std::pair<const void *, Task> >::iterator it = mTasks.begin();
+  while (it != mTasks.end()) {
+    if (it->first == owner) it = mTasks.erase(it);
+    else ++it;
+  }
+  while (mRunningOwner == owner) mTaskDone.wait(lock);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateSnapshotWriter::Run()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (true) {
+    while (mTasks.empty() && !mIsStopped) mTaskAvailable.wait(lock);
+    if (mTasks.empty()) return; // stopped
+
+    Task task = mTasks.front().second;
+    mRunningOwner = mTasks.front().first;
+    mTasks.pop_front();
+
+    lock.unlock();
+    task();
+    task = Task(); // release the snapshot before signaling
+    lock.lock();
+
+    mRunningOwner = 0;
+    mTaskDone.notify_all();
+  }
+}
+//-----------------------------------------------------------------------------
@@ -15,7 +15,6 @@
 #include "GateCrystalHit.hh"
 #include "GatePhantomHit.hh"
 #include "GateRecorderBase.hh"
-#include "GatePrimaryGeneratorAction.hh"
 #include "GateVVolume.hh"
 #include "GateDigitizer.hh"
 #include "GateSingleDigi.hh"
@@ -42,6 +41,101 @@
 #include <iostream>
 #include <sstream>
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
+
+// The records are formatted directly in the output batches. The
+// formats are the same as the operator<<(std::ofstream&, ...) of
+// GateCrystalHit, GateSingleDigi and GateCoincidenceDigi.
+namespace {
+
+  // Like 'std::setw(width) << volumeID' (GateOutputVolumeID.cc)
+  void WriteVolumeID(GateBufferedFileWriter & out, const GateOutputVolumeID & volumeID, int width)
+  {
+    for (size_t i=0; i<volumeID.size(); ++i) {
+      out.WriteInt(volumeID[i], width);
+      out.WriteChar(' ');
+    }
+    // The width is not consumed by an empty ID, it pads the next " "
+    if (volumeID.empty())
+      for (int i=1; i<width; i++) out.WriteChar(' ');
+  }
+
+  void WriteHit(GateBufferedFileWriter & out, const GateCrystalHit * hit)
+  {
+    out.WriteChar(' '); out.WriteInt(hit->GetRunID(), 7);
+    out.WriteChar(' '); out.WriteInt(hit->GetEventID(), 7);
+    out.WriteChar(' '); out.WriteInt(hit->GetPrimaryID(), 3);
+    out.WriteChar(' '); out.WriteInt(hit->GetSourceID(), 3);
+    out.WriteChar(' '); WriteVolumeID(out, hit->GetOutputVolumeID(), 5);
+    out.WriteChar(' '); out.WriteScientific(hit->GetTime()/s, 30, 23);
+    out.WriteChar(' '); out.WriteScientific(hit->GetEdep()/MeV, 10, 3);
+    out.WriteChar(' '); out.WriteScientific(hit->GetStepLength()/mm, 10, 3);
+    out.WriteChar(' '); out.WriteScientific(hit->GetGlobalPos().x()/mm, 10, 3);
+    out.WriteChar(' '); out.WriteScientific(hit->GetGlobalPos().y()/mm, 10, 3);
+    out.WriteChar(' '); out.WriteScientific(hit->GetGlobalPos().z()/mm, 10, 3);
+    out.WriteChar(' '); out.WriteInt(hit->GetPDGEncoding(), 7);
+    out.WriteChar(' '); out.WriteInt(hit->GetTrackID(), 5);
+    out.WriteChar(' '); out.WriteInt(hit->GetParentID(), 5);
+    out.WriteChar(' '); out.WriteInt(hit->GetPhotonID(), 3);
+    out.WriteChar(' '); out.WriteInt(hit->GetNPhantomCompton(), 4);
+    out.WriteChar(' '); out.WriteInt(hit->GetNPhantomRayleigh(), 4);
+    out.WriteChar(' '); out.WriteString(hit->GetProcess());
+    out.WriteChar(' '); out.WriteString(hit->GetComptonVolumeName());
+    out.WriteChar(' '); out.WriteString(hit->GetRayleighVolumeName());
+    out.WriteChar('\n');
+  }
+
+  void WriteSingle(GateBufferedFileWriter & out, const GateSingleDigi * digi)
+  {
+    if ( GateSingleDigi::GetSingleASCIIMask(0) ) { out.WriteChar(' '); out.WriteInt(digi->GetRunID(), 7); }
+    if ( GateSingleDigi::GetSingleASCIIMask(1) ) { out.WriteChar(' '); out.WriteInt(digi->GetEventID(), 7); }
+    if ( GateSingleDigi::GetSingleASCIIMask(2) ) { out.WriteChar(' '); out.WriteInt(digi->GetSourceID(), 5); }
+    if ( GateSingleDigi::GetSingleASCIIMask(3) ) { out.WriteChar(' '); out.WriteScientific(digi->GetSourcePosition().x()/mm, 10, 3); }
+    if ( GateSingleDigi::GetSingleASCIIMask(4) ) { out.WriteChar(' '); out.WriteScientific(digi->GetSourcePosition().y()/mm, 10, 3); }
+    if ( GateSingleDigi::GetSingleASCIIMask(5) ) { out.WriteChar(' '); out.WriteScientific(digi->GetSourcePosition().z()/mm, 10, 3); }
+    if ( GateSingleDigi::GetSingleASCIIMask(6) ) { out.WriteChar(' '); WriteVolumeID(out, digi->GetOutputVolumeID(), 5); }
+    if ( GateSingleDigi::GetSingleASCIIMask(7) ) { out.WriteChar(' '); out.WriteScientific(digi->GetTime()/s, 30, 23); }
+    if ( GateSingleDigi::GetSingleASCIIMask(8) ) { out.WriteChar(' '); out.WriteScientific(digi->GetEnergy()/MeV, 10, 3); }
+    if ( GateSingleDigi::GetSingleASCIIMask(9) ) { out.WriteChar(' '); out.WriteScientific(digi->GetGlobalPos().x()/mm, 10, 3); }
+    if ( GateSingleDigi::GetSingleASCIIMask(10) ) { out.WriteChar(' '); out.WriteScientific(digi->GetGlobalPos().y()/mm, 10, 3); }
+    if ( GateSingleDigi::GetSingleASCIIMask(11) ) { out.WriteChar(' '); out.WriteScientific(digi->GetGlobalPos().z()/mm, 10, 3); }
+    if ( GateSingleDigi::GetSingleASCIIMask(12) ) { out.WriteChar(' '); out.WriteInt(digi->GetNPhantomCompton(), 4); }
+    if ( GateSingleDigi::GetSingleASCIIMask(13) ) { out.WriteChar(' '); out.WriteInt(digi->GetNCrystalCompton(), 4); }
+    if ( GateSingleDigi::GetSingleASCIIMask(14) ) { out.WriteChar(' '); out.WriteInt(digi->GetNPhantomRayleigh(), 4); }
+    if ( GateSingleDigi::GetSingleASCIIMask(15) ) { out.WriteChar(' '); out.WriteInt(digi->GetNCrystalRayleigh(), 4); }
+    if ( GateSingleDigi::GetSingleASCIIMask(16) ) { out.WriteChar(' '); out.WriteString(digi->GetComptonVolumeName()); }
+    if ( GateSingleDigi::GetSingleASCIIMask(17) ) { out.WriteChar(' '); out.WriteString(digi->GetRayleighVolumeName()); }
+    out.WriteChar('\n');
+  }
+
+  void WriteCoincidence(GateBufferedFileWriter & out, GateCoincidenceDigi * digi)
+  {
+    for (G4int iP=0; iP<2; iP++) {
+      const GatePulse & pulse = digi->GetPulse(iP);
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(0) ) { out.WriteChar(' '); out.WriteInt(pulse.GetRunID(), 7); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(1) ) { out.WriteChar(' '); out.WriteInt(pulse.GetEventID(), 7); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(2) ) { out.WriteChar(' '); out.WriteInt(pulse.GetSourceID(), 5); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(3) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetSourcePosition().x()/mm, 0, 3); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(4) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetSourcePosition().y()/mm, 0, 3); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(5) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetSourcePosition().z()/mm, 0, 3); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(6) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetTime()/s, 0, 23); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(7) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetEnergy()/MeV, 0, 3); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(8) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetGlobalPos().x()/mm, 0, 3); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(9) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetGlobalPos().y()/mm, 0, 3); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(10) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetGlobalPos().z()/mm, 0, 3); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(11) ) { out.WriteChar(' '); WriteVolumeID(out, pulse.GetOutputVolumeID(), 5); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(12) ) { out.WriteChar(' '); out.WriteInt(pulse.GetNPhantomCompton(), 5); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(13) ) { out.WriteChar(' '); out.WriteInt(pulse.GetNCrystalCompton(), 5); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(14) ) { out.WriteChar(' '); out.WriteInt(pulse.GetNPhantomRayleigh(), 5); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(15) ) { out.WriteChar(' '); out.WriteInt(pulse.GetNCrystalRayleigh(), 5); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(16) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetScannerPos().z()/mm, 0, 3); }
+      if ( GateCoincidenceDigi::GetCoincidenceASCIIMask(17) ) { out.WriteChar(' '); out.WriteScientific(pulse.GetScannerRotAngle()/deg, 0, 3); }
+    }
+    out.WriteChar('\n');
+  }
+
+}
+
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
@@ -100,7 +194,7 @@ void GateToASCII::RecordBeginOfAcquisition()
   if (m_outFileRunsFlag)
     m_outFileRun.open((m_fileName+"Run.dat").c_str(),std::ios::out);
   if (m_outFileHitsFlag)
-    m_outFileHits.open((m_fileName+"Hits.dat").c_str(),std::ios::out);
+    m_outFileHits.Open(m_fileName+"Hits.dat", false);
 
   for (size_t i=0; i<m_outputChannelList.size() ; ++i )
     m_outputChannelList[i]->Open(m_fileName);
@@ -122,7 +216,7 @@ void GateToASCII::RecordEndOfAcquisition()
   if (m_outFileRunsFlag)
     m_outFileRun.close();
   if (m_outFileHitsFlag)
-    m_outFileHits.close();
+    m_outFileHits.Close();
 
   for (size_t i=0; i<m_outputChannelList.size() ; ++i )
        m_outputChannelList[i]->Close();
@@ -141,13 +235,13 @@ void GateToASCII::RecordBeginOfRun(const G4Run * )
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo....
 
-void GateToASCII::RecordEndOfRun(const G4Run * )
+void GateToASCII::RecordEndOfRun(const G4Run * run)
 {
   if (nVerboseLevel > 2)
     G4cout << "GateToASCII::RecordEndOfRun\n";
   if (m_outFileRunsFlag) {
-    G4int nEvent = ((GatePrimaryGeneratorAction*)GateRunManager::GetRunManager()->
-		    GetUserPrimaryGeneratorAction())->GetEventNumber();
+    // (the master has no primary generator in MT: its run holds the merged count)
+    G4int nEvent = run->GetNumberOfEvent();
     if (nVerboseLevel > 0) G4cout
       << "GateToASCII::RecordEndOfRun: Events in the past run: " << nEvent << Gateendl;
     m_outFileRun
@@ -190,7 +284,7 @@ void GateToASCII::RecordEndOfEvent(const G4Event* event)
 	  << "GateToASCII::RecordEndOfEvent : CrystalHitsCollection: processName : <" << processName
 	  << ">    Particls PDG code : " << PDGEncoding << Gateendl;
 	if ((*CHC)[iHit]->GoodForAnalysis()) {
-	  if (m_outFileHitsFlag) m_outFileHits << (*CHC)[iHit];
+	  if (m_outFileHitsFlag) WriteHit(m_outFileHits, (*CHC)[iHit]);
 	}
       }
 
@@ -331,12 +425,7 @@ void GateToASCII::VOutputChannel::Open(const G4String& aFileBaseName)
   }
   G4String fileName = aFileBaseName + m_collectionName + fileCounterSuffix + ".dat";
   if (m_outputFlag) {
-    m_outputFile.open(fileName,std::ios::out);
-	//LF
-    //m_outputFile.seekp (0, ios::beg);
-	 m_outputFile.seekp (0, std::ios::beg);
-	//LF
-    m_outputFileBegin = m_outputFile.tellp();
+    m_outputFile.Open(fileName, false);
   }
   m_fileBaseName = aFileBaseName;
   m_fileCounter++;
@@ -346,19 +435,12 @@ void GateToASCII::VOutputChannel::Open(const G4String& aFileBaseName)
 void GateToASCII::VOutputChannel::Close()
 {
   if (m_outputFlag)
-    m_outputFile.close();
+    m_outputFile.Close();
 }
 
 G4bool GateToASCII::VOutputChannel::ExceedsSize()
 {
-  // from http://www.cplusplus.com/doc/tutorial/tut6-1.html
-  long outputFileEnd;
-  //LF
-  //m_outputFile.seekp (0, ios::end);
-  m_outputFile.seekp (0, std::ios::end);
-  //LF
-  outputFileEnd = m_outputFile.tellp();
-  long size = outputFileEnd - m_outputFileBegin; // in bytes
+  long size = m_outputFile.GetSize(); // in bytes
 //   G4cout << "[GateToASCII::VOutputChannel::ExceedsSize]"
 // 	 << " collectionID: " << m_collectionID
 // 	 << " file limit: " << m_outputFileSizeLimit
@@ -398,7 +480,7 @@ void GateToASCII::SingleOutputChannel::RecordDigitizer()
 	    Open(m_fileBaseName);
 	  }
 	}
-        m_outputFile << (*SDC)[iDigi];
+        WriteSingle(m_outputFile, (*SDC)[iDigi]);
       }
     }
 
@@ -438,7 +520,7 @@ void GateToASCII::CoincidenceOutputChannel::RecordDigitizer()
 	    Open(m_fileBaseName);
 	  }
 	}
-	m_outputFile << (*CDC)[iDigi];
+	WriteCoincidence(m_outputFile, (*CDC)[iDigi]);
       }
     }
   }
@@ -13,6 +13,8 @@
 #ifdef G4ANALYSIS_USE_FILE
 
 #include <limits>
+#include <algorithm>
+#include <cstring>
 #include <fcntl.h>
 #include <unistd.h>
 
@@ -20,6 +22,7 @@
 #include "GateOutputMgr.hh"
 #include "GateVGeometryVoxelStore.hh"
 #include "G4DigiManager.hh"
+#include "G4Run.hh"
 
 // 0x79000000 equivalent to 2,030,043,136 bytes
 #define LIMIT_SIZE 0x79000000
@@ -80,8 +83,7 @@ void GateToBinary::RecordBeginOfAcquisition()
 
 	if( m_outFileHitsFlag )
 	{
-		m_outFileHits.open( ( m_fileName + "Hits.bin" ).c_str(),
-			std::ios::out | std::ios::binary );
+		m_outFileHits.Open( m_fileName + "Hits.bin", true );
 	}
 
 	for( size_t i = 0; i < m_outputChannelVector.size(); ++i )
@@ -110,7 +112,7 @@ void GateToBinary::RecordEndOfAcquisition()
 
 	if( m_outFileHitsFlag )
 	{
-		m_outFileHits.close();
+		m_outFileHits.Close();
 	}
 
 	for( size_t i = 0; i < m_outputChannelVector.size(); ++i )
@@ -127,7 +129,7 @@ void GateToBinary::RecordBeginOfRun( G4Run const* )
 	}
 }
 
-void GateToBinary::RecordEndOfRun( G4Run const* )
+void GateToBinary::RecordEndOfRun( G4Run const* run )
 {
 	if( nVerboseLevel > 2 )
 	{
@@ -136,9 +138,8 @@ void GateToBinary::RecordEndOfRun( G4Run const* )
 
 	if( m_outFileRunsFlag )
 	{
-		G4int nEvent =
-			( ( (GatePrimaryGeneratorAction*)GateRunManager::GetRunManager()->
-			GetUserPrimaryGeneratorAction())->GetEventNumber() );
+		// (the master has no primary generator in MT: its run holds the merged count)
+		G4int nEvent = run->GetNumberOfEvent();
 
 		if( nVerboseLevel > 0 )
 		{
@@ -192,97 +193,56 @@ void GateToBinary::RecordEndOfEvent( G4Event const* event )
 				{
 					if( m_outFileHitsFlag )
 					{
-						G4int runID = (*CHC)[ iHit ]->GetRunID();
-						G4int eventID = (*CHC)[ iHit ]->GetEventID();
-						G4int primaryID = (*CHC)[ iHit ]->GetPrimaryID();
-						G4int sourceID = (*CHC)[ iHit ]->GetSourceID();
-
-						// Element is the number of level
-						size_t const element = 6;
-						G4int volumeID[ element ] = { 0, 0, 0, 0, 0, 0 };
+						GateCrystalHit const* hit = (*CHC)[ iHit ];
+						size_t const nbLevels = ( hit->GetOutputVolumeID() ).size();
+
+						// The record is made of a fixed size head, the volume ID
+						// (one G4int per level) and a fixed size tail, each one
+						// copied at once in the output batch
+						static_assert( sizeof( HitRecordHead ) == 4 * sizeof( G4int ) &&
+							sizeof( HitRecordTail ) == 6 * sizeof( G4double ) +
+							6 * sizeof( G4int ) + 3 * kStringFieldWidth,
+							"hit records must not contain padding" );
+						HitRecordHead head;
+						head.runID = hit->GetRunID();
+						head.eventID = hit->GetEventID();
+						head.primaryID = hit->GetPrimaryID();
+						head.sourceID = hit->GetSourceID();
+
+						HitRecordTail tail;
+						tail.time = hit->GetTime()/s;
+						tail.eDep = hit->GetEdep()/MeV;
+						tail.stepLength = hit->GetStepLength()/mm;
+						tail.posX = ( hit->GetGlobalPos() ).x()/mm;
+						tail.posY = ( hit->GetGlobalPos() ).y()/mm;
+						tail.posZ = ( hit->GetGlobalPos() ).z()/mm;
+						tail.PDGEncoding = PDGEncoding;
+						tail.trackID = hit->GetTrackID();
+						tail.parentID = hit->GetParentID();
+						tail.photonID = hit->GetPhotonID();
+						tail.phCompton = hit->GetNPhantomCompton();
+						tail.phRayleigh = hit->GetNPhantomRayleigh();
+
+						// Previous versions of GATE unintentionally wrote the
+						// structure of G4String (which is std::string) to disk
+						// rather than the string itself.  This was 8 bytes on
+						// most platforms, and referenced as 8 bytes in the
+						// documentaiton.  For this reason we limit the strings
+						// to 8 bytes, or 7 characters with a null terminator.
+						CopyFixedWidthZeroPaddedString( processName, tail.processName );
+						CopyFixedWidthZeroPaddedString( hit->GetComptonVolumeName(),
+							tail.comptonVolumeName );
+						CopyFixedWidthZeroPaddedString( hit->GetRayleighVolumeName(),
+							tail.rayleighVolumeName );
 
-						// For each level of volume
-						for( size_t lvl = 0;
-							lvl < ( (*CHC)[ iHit ]->GetOutputVolumeID() ).size(); ++lvl )
+						// Writing data
+						m_outFileHits.WriteValue( head );
+						if( nbLevels > 0 )
 						{
-							*( volumeID + lvl ) =
-								(*CHC)[ iHit ]->GetOutputVolumeID()[ lvl ];
+							m_outFileHits.Write( reinterpret_cast< char const* >(
+								&( hit->GetOutputVolumeID() )[ 0 ] ), nbLevels * sizeof( G4int ) );
 						}
-
-						G4double timeID = (*CHC)[ iHit ]->GetTime()/s;
-						G4double eDepID = (*CHC)[ iHit ]->GetEdep()/MeV;
-						G4double stepLengthID = (*CHC)[ iHit ]->GetStepLength()/mm;
-						G4double posX = ( (*CHC)[ iHit ]->GetGlobalPos() ).x()/mm;
-						G4double posY = ( (*CHC)[ iHit ]->GetGlobalPos() ).y()/mm;
-						G4double posZ = ( (*CHC)[ iHit ]->GetGlobalPos() ).z()/mm;
-
-						G4int trackID = (*CHC)[ iHit ]->GetTrackID();
-						G4int parentID = (*CHC)[ iHit ]->GetParentID();
-						G4int photonID = (*CHC)[ iHit ]->GetPhotonID();
-						G4int phCompton = (*CHC)[ iHit ]->GetNPhantomCompton();
-						G4int phRayleigh = (*CHC)[ iHit ]->GetNPhantomRayleigh();
-
-						G4String compVolName = (*CHC)[ iHit ]->GetComptonVolumeName();
-						G4String rayVolName = (*CHC)[ iHit ]->GetRayleighVolumeName();
-
-						// Writing data
-						m_outFileHits.write( reinterpret_cast< char* >( &runID ),
-							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &eventID ),
-							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &primaryID ),
-							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &sourceID ),
-							sizeof( G4int ) );
-						m_outFileHits.write(
-							reinterpret_cast< char* >( &volumeID[ 0 ] ),
-							( (*CHC)[ iHit ]->GetOutputVolumeID() ).size() * sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &timeID ),
-							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &eDepID ),
-							sizeof( G4double ) );
-						m_outFileHits.write(
-							reinterpret_cast< char* >( &stepLengthID ),
-							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &posX ),
-							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &posY ),
-							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &posZ ),
-							sizeof( G4double ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &PDGEncoding ),
-							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &trackID ),
-							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &parentID ),
-							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &photonID ),
-							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &phCompton ),
-							sizeof( G4int ) );
-						m_outFileHits.write( reinterpret_cast< char* >( &phRayleigh ),
-							sizeof( G4int ) );
-
-                        // Previous versions of GATE unintentionally wrote the
-                        // structure of G4String (which is std::string) to disk
-                        // rather than the string itself.  This was 8 bytes on
-                        // most platforms, and referenced as 8 bytes in the
-                        // documentaiton.  For this reason we limit the strings
-                        // to 8 bytes, or 7 characters with a null terminator.
-                        const size_t strFieldWidth = 8;
-                        const size_t strMaxLen = strFieldWidth - 1;
-                        G4String processNameTrunc = FixedWidthZeroPaddedString(
-                                processName, strMaxLen);
-                        G4String compVolNameTrunc = FixedWidthZeroPaddedString(
-                                compVolName, strMaxLen);
-                        G4String rayVolNameTrunc = FixedWidthZeroPaddedString(
-                                rayVolName, strMaxLen);
-						m_outFileHits.write( processNameTrunc.c_str(),
-                                strFieldWidth);
-						m_outFileHits.write( compVolNameTrunc.c_str(),
-                                strFieldWidth);
-						m_outFileHits.write( rayVolNameTrunc.c_str(),
-                                strFieldWidth);
+						m_outFileHits.WriteValue( tail );
 					}
 				}
 			}
@@ -433,8 +393,7 @@ void GateToBinary::VOutputChannel::OpenFile(
 		+ ".dat";
 	if( m_outputFlag )
 	{
-		m_outputFile.open( fileName.c_str(), std::ios::out |
-			std::ios::binary );
+		m_outputFile.Open( fileName, true );
 	}
 	m_fileBaseName = aFileBaseName;
 	++m_fileCounter;
@@ -445,13 +404,13 @@ void GateToBinary::VOutputChannel::CloseFile()
 {
   if( m_outputFlag )
 	{
-		m_outputFile.close();
+		m_outputFile.Close();
 	}
 }
 
 G4bool GateToBinary::VOutputChannel::ExceedsSize()
 {
-	G4int size = m_outputFile.tellp();
+	long size = m_outputFile.GetSize();
 	//std::cout << "size: " << size << " B\n";
   return size > m_outputFileSizeLimit;
 }
@@ -515,21 +474,21 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 0 ) )
 					{
 						runID = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetRunID();
-						m_outputFile.write( reinterpret_cast< char* >( &runID ),
+						m_outputFile.Write( reinterpret_cast< char* >( &runID ),
 						sizeof( G4int ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 1 ) )
 					{
 						eventID = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetEventID();
-						m_outputFile.write( reinterpret_cast< char* >( &eventID ),
+						m_outputFile.Write( reinterpret_cast< char* >( &eventID ),
 						sizeof( G4int ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 2 ) )
 					{
 						sourceID = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetSourceID();
-						m_outputFile.write( reinterpret_cast< char* >( &sourceID ),
+						m_outputFile.Write( reinterpret_cast< char* >( &sourceID ),
 						sizeof( G4int ) );
 					}
 
@@ -537,7 +496,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						sourcePosX = ( (*CDC)[ iDigi ]->
 							GetPulse( iP ) ).GetSourcePosition().x()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &sourcePosX ),
+						m_outputFile.Write( reinterpret_cast< char* >( &sourcePosX ),
 						sizeof( G4double ) );
 					}
 
@@ -545,7 +504,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						sourcePosY = ( (*CDC)[ iDigi ]->
 							GetPulse( iP ) ).GetSourcePosition().y()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &sourcePosY ),
+						m_outputFile.Write( reinterpret_cast< char* >( &sourcePosY ),
 						sizeof( G4double ) );
 					}
 
@@ -553,42 +512,42 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						sourcePosZ = ( (*CDC)[ iDigi ]->
 							GetPulse( iP ) ).GetSourcePosition().z()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &sourcePosZ ),
+						m_outputFile.Write( reinterpret_cast< char* >( &sourcePosZ ),
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 6 ) )
 					{
 						time = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetTime()/s;
-						m_outputFile.write( reinterpret_cast< char* >( &time ),
+						m_outputFile.Write( reinterpret_cast< char* >( &time ),
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 7 ) )
 					{
 						energy = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetEnergy()/MeV;
-						m_outputFile.write( reinterpret_cast< char* >( &energy ),
+						m_outputFile.Write( reinterpret_cast< char* >( &energy ),
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 8 ) )
 					{
 						posX = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetGlobalPos().x()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &posX ),
+						m_outputFile.Write( reinterpret_cast< char* >( &posX ),
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 9 ) )
 					{
 						posY = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetGlobalPos().y()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &posY ),
+						m_outputFile.Write( reinterpret_cast< char* >( &posY ),
 						sizeof( G4double ) );
 					}
 
 					if ( GateCoincidenceDigi::GetCoincidenceASCIIMask( 10 ) )
 					{
 						posZ = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetGlobalPos().z()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &posZ ),
+						m_outputFile.Write( reinterpret_cast< char* >( &posZ ),
 						sizeof( G4double ) );
 					}
 
@@ -603,7 +562,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 								( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 								GetOutputVolumeID()[ lvl ];
 						}
-						m_outputFile.write(
+						m_outputFile.Write(
 							reinterpret_cast< char* >( &volumeID[ 0 ] ),
 							( ( (*CDC)[ iDigi ]->GetPulse( iP ) ).GetOutputVolumeID() ).size() * sizeof( G4int ) );
 					}
@@ -612,7 +571,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						nPhantCompt = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetNPhantomCompton();
-						m_outputFile.write( reinterpret_cast< char* >( &nPhantCompt ),
+						m_outputFile.Write( reinterpret_cast< char* >( &nPhantCompt ),
 						sizeof( G4int ) );
 					}
 
@@ -620,7 +579,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						nCrysCompt = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetNCrystalCompton();
-						m_outputFile.write( reinterpret_cast< char* >( &nCrysCompt ),
+						m_outputFile.Write( reinterpret_cast< char* >( &nCrysCompt ),
 						sizeof( G4int ) );
 					}
 
@@ -628,7 +587,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						nPhantRay = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetNPhantomRayleigh();
-						m_outputFile.write( reinterpret_cast< char* >( &nPhantRay ),
+						m_outputFile.Write( reinterpret_cast< char* >( &nPhantRay ),
 						sizeof( G4int ) );
 					}
 
@@ -636,7 +595,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						nCrysRay = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetNCrystalRayleigh();
-						m_outputFile.write( reinterpret_cast< char* >( &nCrysRay ),
+						m_outputFile.Write( reinterpret_cast< char* >( &nCrysRay ),
 						sizeof( G4int ) );
 					}
 
@@ -644,7 +603,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						scannerPosZ = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetScannerPos().z()/mm;
-						m_outputFile.write( reinterpret_cast< char* >( &scannerPosZ ),
+						m_outputFile.Write( reinterpret_cast< char* >( &scannerPosZ ),
 						sizeof( G4double ) );
 					}
 
@@ -652,7 +611,7 @@ void GateToBinary::CoincidenceOutputChannel::RecordDigitizer()
 					{
 						scannerRotAng = ( (*CDC)[ iDigi ]->GetPulse( iP ) ).
 							GetScannerRotAngle()/deg;
-						m_outputFile.write( reinterpret_cast< char* >( &scannerRotAng ),
+						m_outputFile.Write( reinterpret_cast< char* >( &scannerRotAng ),
 						sizeof( G4double ) );
 					}
 				}
@@ -717,42 +676,42 @@ void GateToBinary::SingleOutputChannel::RecordDigitizer()
 				if ( GateSingleDigi::GetSingleASCIIMask( 0 ) )
 				{
 					runID = (*SDC)[ iDigi ]->GetRunID();
-					m_outputFile.write( reinterpret_cast< char* >( &runID ),
+					m_outputFile.Write( reinterpret_cast< char* >( &runID ),
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 1 ) )
 				{
 					eventID = (*SDC)[ iDigi ]->GetEventID();
-					m_outputFile.write( reinterpret_cast< char* >( &eventID ),
+					m_outputFile.Write( reinterpret_cast< char* >( &eventID ),
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 2 ) )
 				{
 					sourceID = (*SDC)[ iDigi ]->GetSourceID();
-					m_outputFile.write( reinterpret_cast< char* >( &sourceID ),
+					m_outputFile.Write( reinterpret_cast< char* >( &sourceID ),
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 3 ) )
 				{
 					sourcePosX = (*SDC)[ iDigi ]->GetSourcePosition().x()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &sourcePosX ),
+					m_outputFile.Write( reinterpret_cast< char* >( &sourcePosX ),
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 4 ) )
 				{
 					sourcePosY = (*SDC)[ iDigi ]->GetSourcePosition().y()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &sourcePosY ),
+					m_outputFile.Write( reinterpret_cast< char* >( &sourcePosY ),
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 5 ) )
 				{
 					sourcePosZ = (*SDC)[ iDigi ]->GetSourcePosition().z()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &sourcePosZ ),
+					m_outputFile.Write( reinterpret_cast< char* >( &sourcePosZ ),
 					sizeof( G4double ) );
 				}
 
@@ -766,7 +725,7 @@ void GateToBinary::SingleOutputChannel::RecordDigitizer()
 						*( volumeID + lvl ) = (*SDC)[ iDigi ]->
 							GetOutputVolumeID()[ lvl ];
 					}
-					m_outputFile.write(
+					m_outputFile.Write(
 						reinterpret_cast< char* >( &volumeID[ 0 ] ),
 						( (*SDC)[ iDigi ]->GetOutputVolumeID() ).size() * sizeof( G4int ) );
 				}
@@ -774,63 +733,63 @@ void GateToBinary::SingleOutputChannel::RecordDigitizer()
 				if ( GateSingleDigi::GetSingleASCIIMask( 7 ) )
 				{
 					time = (*SDC)[ iDigi ]->GetTime()/s;
-					m_outputFile.write( reinterpret_cast< char* >( &time ),
+					m_outputFile.Write( reinterpret_cast< char* >( &time ),
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 8 ) )
 				{
 					energy = (*SDC)[ iDigi ]->GetEnergy()/MeV;
-					m_outputFile.write( reinterpret_cast< char* >( &energy ),
+					m_outputFile.Write( reinterpret_cast< char* >( &energy ),
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 9 ) )
 				{
 					posX = (*SDC)[ iDigi ]->GetGlobalPos().x()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &posX ),
+					m_outputFile.Write( reinterpret_cast< char* >( &posX ),
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 10 ) )
 				{
 					posY = (*SDC)[ iDigi ]->GetGlobalPos().y()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &posY ),
+					m_outputFile.Write( reinterpret_cast< char* >( &posY ),
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 11 ) )
 				{
 					posZ = (*SDC)[ iDigi ]->GetGlobalPos().z()/mm;
-					m_outputFile.write( reinterpret_cast< char* >( &posZ ),
+					m_outputFile.Write( reinterpret_cast< char* >( &posZ ),
 					sizeof( G4double ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 12 ) )
 				{
 					nPhantCompt = (*SDC)[ iDigi ]->GetNPhantomCompton();
-					m_outputFile.write( reinterpret_cast< char* >( &nPhantCompt ),
+					m_outputFile.Write( reinterpret_cast< char* >( &nPhantCompt ),
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 13 ) )
 				{
 					nCrysCompt = (*SDC)[ iDigi ]->GetNCrystalCompton();
-					m_outputFile.write( reinterpret_cast< char* >( &nCrysCompt ),
+					m_outputFile.Write( reinterpret_cast< char* >( &nCrysCompt ),
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 14 ) )
 				{
 					nPhantRay = (*SDC)[ iDigi ]->GetNPhantomRayleigh();
-					m_outputFile.write( reinterpret_cast< char* >( &nPhantRay ),
+					m_outputFile.Write( reinterpret_cast< char* >( &nPhantRay ),
 					sizeof( G4int ) );
 				}
 
 				if ( GateSingleDigi::GetSingleASCIIMask( 15 ) )
 				{
 					nCrysRay = (*SDC)[ iDigi ]->GetNCrystalRayleigh();
-					m_outputFile.write( reinterpret_cast< char* >( &nCrysRay ),
+					m_outputFile.Write( reinterpret_cast< char* >( &nCrysRay ),
 					sizeof( G4int ) );
 				}
 
@@ -848,7 +807,7 @@ void GateToBinary::SingleOutputChannel::RecordDigitizer()
 					compVolName = (*SDC)[ iDigi ]->GetComptonVolumeName();
 					G4String compVolNameTrunc = FixedWidthZeroPaddedString(
 							compVolName, strMaxLen);
-					m_outputFile.write( compVolNameTrunc.c_str(),
+					m_outputFile.Write( compVolNameTrunc.c_str(),
 							strFieldWidth);
 				}
 
@@ -857,7 +816,7 @@ void GateToBinary::SingleOutputChannel::RecordDigitizer()
 					rayVolName = (*SDC)[ iDigi ]->GetRayleighVolumeName();
 					G4String rayVolNameTrunc = FixedWidthZeroPaddedString(
 							rayVolName, strMaxLen);
-					m_outputFile.write( rayVolNameTrunc.c_str(),
+					m_outputFile.Write( rayVolNameTrunc.c_str(),
 							strFieldWidth);
 				}
 			}
@@ -882,4 +841,20 @@ G4String GateToBinary::FixedWidthZeroPaddedString(const G4String & full, size_t
     return (trunc);
 }
 
+/*!
+ * \brief Copies a string in a fixed size field of a binary record
+ *
+ * Same as FixedWidthZeroPaddedString: the string is truncated to
+ * kStringFieldWidth-1 characters and the rest of the field is filled with '\0'.
+ *
+ * \param full The full string to be copied
+ * \param field The field of the record
+ */
+void GateToBinary::CopyFixedWidthZeroPaddedString(const G4String & full,
+	char (&field)[ kStringFieldWidth ]) {
+    size_t const length = std::min( full.size(), kStringFieldWidth - 1 );
+    std::memcpy( field, full.data(), length );
+    std::memset( field + length, '\0', kStringFieldWidth - length );
+}
+
 #endif
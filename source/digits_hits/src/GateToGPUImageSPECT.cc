@@ -682,7 +682,7 @@ void GateToGPUImageSPECT::RecordStepWithVolume( const GateVVolume*,
 				m_cpuParticle->E[ id ] = preStep->GetKineticEnergy()/MeV;
 				m_cpuParticle->parentID[ id ] = aStep->GetTrack()->GetParentID();
 				m_cpuParticle->eventID[ id ] =
-				GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+				G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
 				m_cpuParticle->trackID[ id ] = aStep->GetTrack()->GetTrackID();
 				m_cpuParticle->t[ id ] = preStep->GetGlobalTime();
 					m_cpuParticle->px[ id ] = newX;
@@ -697,7 +697,7 @@ void GateToGPUImageSPECT::RecordStepWithVolume( const GateVVolume*,
 					m_gpuParticle->E[ id ] = preStep->GetKineticEnergy()/MeV;
 					m_gpuParticle->parentID[ id ] = aStep->GetTrack()->GetParentID();
 					m_gpuParticle->eventID[ id ] =
-						GateRunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
+						G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
 					m_gpuParticle->trackID[ id ] = aStep->GetTrack()->GetTrackID();
 					m_gpuParticle->t[ id ] = preStep->GetGlobalTime();
 					m_gpuParticle->px[ id ] = newX;
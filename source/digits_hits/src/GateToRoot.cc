@@ -26,6 +26,7 @@
 #ifdef G4ANALYSIS_USE_ROOT
 
 #include <iomanip>
+#include <mutex>
 #include "globals.hh"
 #include "G4Run.hh"
 #include "G4Step.hh"
@@ -53,6 +54,7 @@
 #include "GateOutputMgr.hh"
 #include "GateVVolume.hh"
 #include "GateToRootMessenger.hh"
+#include "GateMessageManager.hh"
 #include "GateVGeometryVoxelStore.hh"
 
 #include "TROOT.h"
@@ -70,6 +72,24 @@
 #include "GateTrajectoryNavigator.hh"
 // v. cuplov - optical photons
 
+namespace {
+  // Per-event data filled by RecordStepWithVolume. Each tracking thread keeps
+  // its own until RecordEndOfEvent, so that the steps are recorded without lock
+  struct GateToRootStepRecord {
+    G4double momentumDirectionx, momentumDirectiony, momentumDirectionz;
+    G4double positronKinEnergy;
+    G4ThreeVector ionDecayPos, positronGenerationPos, positronAnnihilPos;
+    G4double dxg1, dyg1, dzg1, dxg2, dyg2, dzg2;
+  };
+  G4ThreadLocal GateToRootStepRecord * threadStepRecord = 0;
+
+  GateToRootStepRecord & GetThreadStepRecord()
+  {
+    if (!threadStepRecord) threadStepRecord = new GateToRootStepRecord();
+    return *threadStepRecord;
+  }
+}
+
 ComptonRayleighData::ComptonRayleighData()
 {;}
 
@@ -122,6 +142,7 @@ GateToRoot::GateToRoot(const G4String& name, GateOutputMgr* outputMgr,DigiMode d
   m_rootMessenger = new GateToRootMessenger(this);
 
   m_recordFlag = 0; // Design to embrace obsolete functions (histogram, recordVoxels, ...)
+  m_asyncWritingFlag = false;
   latestEventID=0.; // Used by gjs and gjm programs (cluster mode)
   nbPrimaries=0.; // To have the total number of emitted primaries (stored at endOfAcq in an histo)
 
@@ -229,6 +250,7 @@ void GateToRoot::Book()
 
   m_treeHit = new GateHitTree(GateHitConvertor::GetOutputAlias());
   m_treeHit->Init(m_hitBuffer);
+  SetupTree(m_treeHit);
 
   // v. cuplov - optical photons
   OpticalTree = new TTree(G4String("OpticalData").c_str(),"OpticalData");
@@ -264,11 +286,48 @@ void GateToRoot::Book()
   OpticalTree->Branch(G4String("MomentumDirectionx").c_str(),&MomentumDirectionx,"MomentumDirectionx/D");
   OpticalTree->Branch(G4String("MomentumDirectiony").c_str(),&MomentumDirectiony,"MomentumDirectiony/D");
   OpticalTree->Branch(G4String("MomentumDirectionz").c_str(),&MomentumDirectionz,"MomentumDirectionz/D");
+  SetupTree(OpticalTree);
   // v. cuplov - optical photons
 
-  for (size_t i=0; i<m_outputChannelList.size(); ++i)
+  for (size_t i=0; i<m_outputChannelList.size(); ++i) {
     m_outputChannelList[i]->Book();
+    m_outputChannelList[i]->SetTreeWriter(m_asyncWritingFlag ? &m_treeWriter : 0);
+    if (m_outputChannelList[i]->GetTree()) SetupTree(m_outputChannelList[i]->GetTree());
+  }
+
+}
+//--------------------------------------------------------------------------
+
+
+//--------------------------------------------------------------------------
+void GateToRoot::SetAsynchronousWritingFlag(G4bool flag)
+{
+  if (flag && !GateRootAsyncTreeWriter::IsAvailable()) {
+    GateWarning("Asynchronous writing of the ROOT trees needs ROOT 6 or later, "
+                << "the trees are filled by the event loop.\n");
+    flag = false;
+  }
+  m_asyncWritingFlag = flag;
+}
+//--------------------------------------------------------------------------
+
+
+//--------------------------------------------------------------------------
+void GateToRoot::SetupTree(TTree* tree)
+{
+  std::map<G4String,G4int>::const_iterator it = m_treeBasketSize.find(tree->GetName());
+  if (it != m_treeBasketSize.end()) tree->SetBasketSize("*", it->second);
+
+  it = m_treeCompressionLevel.find(tree->GetName());
+  if (it != m_treeCompressionLevel.end()) {
+    TObjArray* branches = tree->GetListOfBranches();
+    for (G4int i=0; i<branches->GetEntriesFast(); ++i)
+      ((TBranch*)branches->At(i))->SetCompressionLevel(it->second);
+  }
 
+  if (m_asyncWritingFlag && !m_treeWriter.AddTree(tree))
+    GateWarning("The tree '" << tree->GetName() << "' cannot be filled asynchronously, "
+                << "it is filled by the event loop.\n");
 }
 //--------------------------------------------------------------------------
 
@@ -281,8 +340,7 @@ void GateToRoot::RecordBeginOfAcquisition()
   if (nVerboseLevel > 2)
     G4cout << "GateToRoot::RecordBeginOfAcquisition\n";
 
-  GateSteppingAction* myAction = ( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) );
-  TrackingMode theMode = myAction->GetMode();
+  TrackingMode theMode = GateSteppingAction::GetMode();
   if (nVerboseLevel > 1) G4cout << " GateToRoot::RecordBeginOfAcquisition()  Tracking Mode " << theMode << Gateendl;
 
   // PY. Descourt 11/12/2008
@@ -457,6 +515,9 @@ void GateToRoot::RecordBeginOfAcquisition()
       m_RecStepTree->Branch(G4String("RaylVol2").c_str(), &theCRData.theRayleighVolumeName2,"RaylVol2/C");
       m_RecStepTree->Branch(G4String("EventID").c_str(), &m_RSEventID,"EventID/I");
       m_RecStepTree->Branch(G4String("RunID").c_str(), &m_RSRunID,"RunID/I");
+
+      SetupTree(tracksTuple);
+      SetupTree(m_RecStepTree);
       ////////////////////////
     }
 
@@ -512,8 +573,11 @@ void GateToRoot::RecordEndOfAcquisition()
 
   /* PY Descourt 08/09/2009 */
 
-  GateSteppingAction* myAction = ( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) );
-  TrackingMode theMode = myAction->GetMode();
+  //! All the entries must be in the trees before writing and closing
+  //! the file
+  m_treeWriter.Stop();
+
+  TrackingMode theMode = GateSteppingAction::GetMode();
   if ( theMode == kTracker )
     {
       G4cout << " ----- ROOT FILE DATA INFORMATIONS ----- \n";
@@ -651,7 +715,7 @@ void GateToRoot::RecordBeginOfEvent(const G4Event* evt )
   strcpy( theCRData.theRayleighVolumeName2, G4String("NULL").c_str()  );
 
 
-  TrackingMode theMode =( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) )->GetMode();
+  TrackingMode theMode =( (GateSteppingAction *)(G4RunManager::GetRunManager()->GetUserSteppingAction() ) )->GetMode();
   if ( (theMode == kDetector) &&   (evt->GetNumberOfPrimaryVertex() > 0) )
     {
 
@@ -680,6 +744,8 @@ void GateToRoot::RecordBeginOfEvent(const G4Event* evt )
 
   /*PY Descourt 08/09/2009 */
 
+  LoadStepRecord();
+
   //  GateMessage("Output", 5, " GateToRoot::RecordBeginOfEvent -- end\n";);
 
 }
@@ -692,8 +758,9 @@ void GateToRoot::RecordEndOfEvent(const G4Event* event)
 
   // GateMessage("Output", 5 , " GateToRoot::RecordEndOfEvent -- begin\n";);
 
+  StoreStepRecord();
 
-  GateSteppingAction* myAction = ( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) );
+  GateSteppingAction* myAction = ( (GateSteppingAction *)(G4RunManager::GetRunManager()->GetUserSteppingAction() ) );
   TrackingMode theMode = myAction->GetMode();
   if ( theMode == kTracker )return;
 
@@ -725,7 +792,7 @@ void GateToRoot::RecordEndOfEvent(const G4Event* event)
 	  G4cout << "GateToRoot::RecordEndOfEvent : m_treeHit->Fill\n";
 
 
-	if (m_rootHitFlag) m_treeHit->Fill();
+	if (m_rootHitFlag) FillTree(m_treeHit);
       }
     }
 
@@ -788,12 +855,16 @@ void GateToRoot::RecordEndOfEvent(const G4Event* event)
       } else {
 	//! better than the simple eventID, but still not enough: it's valid only for
 	//! the single run and not for the application
-	G4int iEvent = ((GatePrimaryGeneratorAction*)GateRunManager::GetRunManager()->
+	G4int iEvent = ((GatePrimaryGeneratorAction*)G4RunManager::GetRunManager()->
 			GetUserPrimaryGeneratorAction())->GetEventNumber();
-	if (m_rootNtupleFlag) ntuple->Fill(iEvent,
-					   eventTime/s,
-					   m_positronKinEnergy/MeV,
-					   posAnnihilDist.mag()/mm);
+	if (m_rootNtupleFlag) {
+	  // The writing thread may write the baskets of the other trees to the same file
+	  std::lock_guard<std::mutex> lock(m_treeWriter.GetFileMutex());
+	  ntuple->Fill(iEvent,
+		       eventTime/s,
+		       m_positronKinEnergy/MeV,
+		       posAnnihilDist.mag()/mm);
+	}
       }
 
     }
@@ -918,7 +989,7 @@ void GateToRoot::RecordOpticalData(const G4Event * event)
   if(nCrystalOpticalWLS >0) NumCrystalWLS++;
   if(nPhantomOpticalWLS >0) NumPhantomWLS++;
 
-  if (m_rootOpticalFlag && trajectoryContainer) {OpticalTree->Fill();}
+  if (m_rootOpticalFlag && trajectoryContainer) {FillTree(OpticalTree);}
 
 }
 
@@ -941,14 +1012,15 @@ void GateToRoot::RecordDigitizer(const G4Event* )
 //--------------------------------------------------------------------------
 void GateToRoot::RecordStepWithVolume(const GateVVolume *, const G4Step* aStep)
 {
+  GateToRootStepRecord & record = GetThreadStepRecord();
 
   // v. cuplov - optical photon momentum direction
   G4ParticleDefinition* partDef = aStep->GetTrack()->GetDefinition();
   if (partDef == G4OpticalPhoton::OpticalPhotonDefinition()) {
     G4ThreeVector momentumDirection = aStep->GetTrack()->GetMomentumDirection();
-    MomentumDirectionx = momentumDirection.x();
-    MomentumDirectiony = momentumDirection.y();
-    MomentumDirectionz = momentumDirection.z();
+    record.momentumDirectionx = momentumDirection.x();
+    record.momentumDirectiony = momentumDirection.y();
+    record.momentumDirectionz = momentumDirection.z();
   }
   // v. cuplov - optical photon momentum direction
 
@@ -972,21 +1044,21 @@ void GateToRoot::RecordStepWithVolume(const GateVVolume *, const G4Step* aStep)
       }
       // to be changed with: s->GetTrack()->GetCurrentStepNumber() == 1 after some check
       if (procName == "") {
-        m_positronKinEnergy = aStep->GetPreStepPoint()->GetKineticEnergy();
-        m_positronGenerationPos = aStep->GetPreStepPoint()->GetPosition();
+        record.positronKinEnergy = aStep->GetPreStepPoint()->GetKineticEnergy();
+        record.positronGenerationPos = aStep->GetPreStepPoint()->GetPosition();
         if (nVerboseLevel > 1) G4cout << "GateToRoot: Process empty."
-                                      << " m_positronKinEnergy " << m_positronKinEnergy << Gateendl;
+                                      << " m_positronKinEnergy " << record.positronKinEnergy << Gateendl;
       }
       procName = aStep->GetPostStepPoint()->GetProcessDefinedStep()->GetProcessName();
       if (procName == "annihil") {
-        m_positronAnnihilPos = aStep->GetPostStepPoint()->GetPosition();
+        record.positronAnnihilPos = aStep->GetPostStepPoint()->GetPosition();
       }
     } else if (partDef != G4GenericIon::GenericIonDefinition()) {
       G4String procName;
       // could be a secondary ion in the radioactive chain
       if (aStep->GetTrack()->GetParentID() == 0) {
         const G4VProcess* process (  aStep->GetPostStepPoint()->GetProcessDefinedStep()  ); // RTA
-        if (process && process->GetProcessName() =="RadioactiveDecay" ) m_ionDecayPos = aStep->GetPostStepPoint()->GetPosition(); // RTA
+        if (process && process->GetProcessName() =="RadioactiveDecay" ) record.ionDecayPos = aStep->GetPostStepPoint()->GetPosition(); // RTA
       }
     }
 
@@ -1008,16 +1080,16 @@ void GateToRoot::RecordStepWithVolume(const GateVVolume *, const G4Step* aStep)
       }
       if (aStep->GetTrack()->GetTrackID() == 2 && procName == "annihil") {
 
-        dxg1 = momentumDirection.x();
-        dyg1 = momentumDirection.y() ;
-        dzg1 = momentumDirection.z() ;
+        record.dxg1 = momentumDirection.x();
+        record.dyg1 = momentumDirection.y() ;
+        record.dzg1 = momentumDirection.z() ;
 
       }
 
       if (aStep->GetTrack()->GetTrackID() == 3 && procName == "annihil") {
-        dxg2 = momentumDirection.x();
-        dyg2 = momentumDirection.y() ;
-        dzg2 = momentumDirection.z() ;
+        record.dxg2 = momentumDirection.x();
+        record.dyg2 = momentumDirection.y() ;
+        record.dzg2 = momentumDirection.z() ;
       }
     }
 
@@ -1030,6 +1102,48 @@ void GateToRoot::RecordStepWithVolume(const GateVVolume *, const G4Step* aStep)
 //--------------------------------------------------------------------------
 
 
+//--------------------------------------------------------------------------
+void GateToRoot::LoadStepRecord()
+{
+  GateToRootStepRecord & record = GetThreadStepRecord();
+  record.momentumDirectionx = MomentumDirectionx;
+  record.momentumDirectiony = MomentumDirectiony;
+  record.momentumDirectionz = MomentumDirectionz;
+  record.positronKinEnergy = m_positronKinEnergy;
+  record.ionDecayPos = m_ionDecayPos;
+  record.positronGenerationPos = m_positronGenerationPos;
+  record.positronAnnihilPos = m_positronAnnihilPos;
+  record.dxg1 = dxg1;
+  record.dyg1 = dyg1;
+  record.dzg1 = dzg1;
+  record.dxg2 = dxg2;
+  record.dyg2 = dyg2;
+  record.dzg2 = dzg2;
+}
+//--------------------------------------------------------------------------
+
+
+//--------------------------------------------------------------------------
+void GateToRoot::StoreStepRecord()
+{
+  const GateToRootStepRecord & record = GetThreadStepRecord();
+  MomentumDirectionx = record.momentumDirectionx;
+  MomentumDirectiony = record.momentumDirectiony;
+  MomentumDirectionz = record.momentumDirectionz;
+  m_positronKinEnergy = record.positronKinEnergy;
+  m_ionDecayPos = record.ionDecayPos;
+  m_positronGenerationPos = record.positronGenerationPos;
+  m_positronAnnihilPos = record.positronAnnihilPos;
+  dxg1 = record.dxg1;
+  dyg1 = record.dyg1;
+  dzg1 = record.dzg1;
+  dxg2 = record.dxg2;
+  dyg2 = record.dyg2;
+  dzg2 = record.dzg2;
+}
+//--------------------------------------------------------------------------
+
+
 //--------------------------------------------------------------------------
 void GateToRoot::Reset()
 {
@@ -1164,7 +1278,7 @@ void GateToRoot::SingleOutputChannel::RecordDigitizer()
       //GateMessage("OutputMgr", 5, " Single collection m_outputFlag = " << m_outputFlag << Gateendl;);
       for (G4int iDigi=0;iDigi<n_digi;iDigi++) {
         m_buffer.Fill( (*SDC)[iDigi] );
-        m_tree->Fill();
+        FillTree(m_tree);
       }
     }
   }
@@ -1198,7 +1312,7 @@ void GateToRoot::CoincidenceOutputChannel::RecordDigitizer()
       G4int n_digi =  CDC->entries();
       for (G4int iDigi=0;iDigi<n_digi;iDigi++) {
         m_buffer.Fill( (*CDC)[iDigi] );
-        m_tree->Fill();
+        FillTree(m_tree);
       }
     }
   }
@@ -1293,7 +1407,7 @@ void GateToRoot::OpenTracksFile()
   G4String previousFN = fTracksFN ;
 
 
-  GateSteppingAction* myAction = ( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) );
+  GateSteppingAction* myAction = ( (GateSteppingAction *)(G4RunManager::GetRunManager()->GetUserSteppingAction() ) );
 
   G4int currentN = myAction->GetcurrentN();
 
@@ -1491,7 +1605,7 @@ void GateToRoot::GetCurrentRecStepData( const G4Event* evt )
 
 GateTrack* GateToRoot::GetCurrentTracksData()
 {
-  GateSteppingAction* myAction = ( (GateSteppingAction *)(GateRunManager::GetRunManager()->GetUserSteppingAction() ) );
+  GateSteppingAction* myAction = ( (GateSteppingAction *)(G4RunManager::GetRunManager()->GetUserSteppingAction() ) );
   if ( m_currentTracksData ==  tracksTuple->GetEntries() ) // check if we are done
     {
       m_EOF = 1;
@@ -1556,7 +1670,7 @@ void GateToRoot::RecordRecStepData( const G4Event* evt )
   //G4cout << " GateToRoot::RecordRecStepData : recording RecStep Data to ROOT file \n";
   m_RSEventID = evt->GetEventID();
   m_RSRunID   = GateRunManager::GetRunManager()->GetCurrentRun()->GetRunID();
-  m_RecStepTree->Fill();
+  FillTree(m_RecStepTree);
   //PrintRecStep();
   //G4cout << " GateToRoot::RecordRecStepData : runID " << m_RSRunID << "  eventID "<< m_RSEventID  << Gateendl;
   //G4cout << " GateToRoot::RecordRecStepData : total " << m_RecStepTree->GetEntries() << Gateendl;
@@ -1661,7 +1775,7 @@ void GateToRoot::RecordTracks(GateSteppingAction* mySteppingAction){
       }
       else m_particleName = (G4String) ( pd->GetParticleName() );
 
-      tracksTuple->Fill();
+      FillTree(tracksTuple);
       delete (*iter);
 
       //G4cout << " GateToRoot::RecordTracks particle name " << m_particleName  << "   parent particle name " << m_parentparticleName<< Gateendl;
@@ -75,6 +75,33 @@ GateToRootMessenger::GateToRootMessenger(GateToRoot* gateToRoot)
   SaveRndmCmd->SetGuidance("Set the flag for change the seed at each Run");
   SaveRndmCmd->SetGuidance("1. true/false");
 
+  cmdName = GetDirectoryName()+"setAsynchronousWriting";
+  AsyncWritingCmd = new G4UIcmdWithABool(cmdName,this);
+  AsyncWritingCmd->SetGuidance("Fill the ROOT trees in a background thread (needs ROOT 6)");
+  AsyncWritingCmd->SetGuidance("1. true/false");
+
+  cmdName = GetDirectoryName()+"setTreeCompressionLevel";
+  TreeCompressionLevelCmd = new G4UIcommand(cmdName,this);
+  TreeCompressionLevelCmd->SetGuidance("Set the compression level of the branches of a tree");
+  TreeCompressionLevelCmd->SetGuidance("1. Tree name (Hits, Singles, Coincidences, OpticalData, ...)");
+  TreeCompressionLevelCmd->SetGuidance("2. Compression level (0: none, 1: fast ... 9: best)");
+  G4UIparameter* treeParam = new G4UIparameter("tree",'s',false);
+  TreeCompressionLevelCmd->SetParameter(treeParam);
+  G4UIparameter* levelParam = new G4UIparameter("level",'i',false);
+  levelParam->SetParameterRange("level>=0 && level<=9");
+  TreeCompressionLevelCmd->SetParameter(levelParam);
+
+  cmdName = GetDirectoryName()+"setTreeBasketSize";
+  TreeBasketSizeCmd = new G4UIcommand(cmdName,this);
+  TreeBasketSizeCmd->SetGuidance("Set the size (bytes) of the baskets of the branches of a tree");
+  TreeBasketSizeCmd->SetGuidance("1. Tree name (Hits, Singles, Coincidences, OpticalData, ...)");
+  TreeBasketSizeCmd->SetGuidance("2. Basket size in bytes");
+  treeParam = new G4UIparameter("tree",'s',false);
+  TreeBasketSizeCmd->SetParameter(treeParam);
+  G4UIparameter* sizeParam = new G4UIparameter("size",'i',false);
+  sizeParam->SetParameterRange("size>0");
+  TreeBasketSizeCmd->SetParameter(sizeParam);
+
   cmdName = GetDirectoryName()+"setCoincidenceMask";
   CoincidenceMaskCmd = new G4UIcommand(cmdName,this);
   CoincidenceMaskCmd->SetGuidance("Set the mask for the coincidence ASCII output");
@@ -115,6 +142,9 @@ GateToRootMessenger::~GateToRootMessenger()
   delete CoincidenceMaskCmd;
   delete SingleMaskCmd;
   delete SaveRndmCmd;
+  delete AsyncWritingCmd;
+  delete TreeCompressionLevelCmd;
+  delete TreeBasketSizeCmd;
   for (size_t i = 0; i<OutputChannelCmdList.size() ; ++i)
     delete OutputChannelCmdList[i];
 }
@@ -139,6 +169,15 @@ void GateToRootMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
     m_gateToRoot->SetRootOpticalFlag(RootOpticalCmd->GetNewBoolValue(newValue));
   } else if (command == RootRecordCmd) {
 	  m_gateToRoot->SetRecordFlag(RootRecordCmd->GetNewBoolValue(newValue));
+	} else if (command == AsyncWritingCmd) {
+    m_gateToRoot->SetAsynchronousWritingFlag(AsyncWritingCmd->GetNewBoolValue(newValue));
+  } else if (command == TreeCompressionLevelCmd || command == TreeBasketSizeCmd) {
+    std::istringstream is(newValue);
+    G4String treeName;
+    G4int value;
+    is >> treeName >> value;
+    if (command == TreeCompressionLevelCmd) m_gateToRoot->SetTreeCompressionLevel(treeName, value);
+    else m_gateToRoot->SetTreeBasketSize(treeName, value);
 	} else if ( IsAnOutputChannelCmd(command) ) {
 
     ExecuteOutputChannelCmd(command,newValue);
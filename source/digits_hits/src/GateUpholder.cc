@@ -63,6 +63,18 @@ void GateUpholder::ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& ou
 
 
 
+void GateUpholder::ProcessPulseBatch(GatePulseBatch& batch)
+{
+  // Null energies are ignored, as in ProcessOnePulse()
+  const size_t n = batch.size();
+  const G4double* energy = n ? &batch.energy[0] : 0;
+  char* keep = n ? &batch.keep[0] : 0;
+  for (size_t i=0 ; i<n ; ++i)
+    keep[i] = (energy[i]!=0) && (energy[i] <= m_uphold);
+}
+
+
+
 void GateUpholder::DescribeMyself(size_t indent)
 {
   G4cout << GateTools::Indent(indent) << "Uphold: " << G4BestUnit(m_uphold,"Energy") << Gateendl;
@@ -22,12 +22,15 @@ See LICENSE.md for further details
 #include "G4SteppingManager.hh"
 
 #include "G4SliceTimer.hh"
+#ifdef GATE_USE_MT
+#include "G4Threading.hh"
+#endif
 
 //class GateRecorderBase;
-GateUserActions* GateUserActions::pUserActions=0;
+G4ThreadLocal GateUserActions* GateUserActions::pUserActions=0;
 
 //-----------------------------------------------------------------------------
-GateUserActions::GateUserActions(GateRunManager* m, GateRecorderBase* r)
+GateUserActions::GateUserActions(G4RunManager* m, GateRecorderBase* r)
   : recorder(r)
 {
   GateMessage("Core", 4,"GateUserActions Constructor start.\n");
@@ -58,9 +61,15 @@ GateUserActions::GateUserActions(GateRunManager* m, GateRecorderBase* r)
   GateSteppingAction* SteppingAction = new GateSteppingAction(this, recorder);
 
   pRunManager->SetUserAction(RunAction);
-  pRunManager->SetUserAction(EventAction);
-  pRunManager->SetUserAction(TrackingAction);
-  pRunManager->SetUserAction(SteppingAction);
+#ifdef GATE_USE_MT
+  // The master thread does not track any event
+  if (G4Threading::IsWorkerThread())
+#endif
+    {
+      pRunManager->SetUserAction(EventAction);
+      pRunManager->SetUserAction(TrackingAction);
+      pRunManager->SetUserAction(SteppingAction);
+    }
 
   //pRunManager->SetUserAction(dynamic_cast<G4UserRunAction *>(this)); //Don't know why this don't work
   //pRunManager->SetUserAction(dynamic_cast<G4UserEventAction *>(this));
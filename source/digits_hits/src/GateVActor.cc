@@ -9,14 +9,22 @@
 
 #include "G4Event.hh"
 
+#include "GateConfiguration.h"
 #include "GateVActor.hh"
 #include "GateActorMessenger.hh"
 #include "GateActorManager.hh"
 #include "GateMiscFunctions.hh"
+#include "GateSnapshotWriter.hh"
 
 #include <sys/time.h>
 #include <stdio.h>
 #include <unistd.h>
+#include <memory>
+
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+namespace { G4Mutex saveEveryMutex = G4MUTEX_INITIALIZER; }
+#endif
 
 //-----------------------------------------------------------------------------
 GateVActor::GateVActor(G4String name, G4int depth)
@@ -37,8 +45,12 @@ GateVActor::GateVActor(G4String name, G4int depth)
   mVolume = 0;
   EnableSaveEveryNEvents(0);
   EnableSaveEveryNSeconds(0);
+  EnableAsyncSave(false);
   mNumOfFilters = 0;
+  pMasterActor = 0;
+  mIsSharedBetweenThreads = false;
   mOverWriteFilesFlag = true;
+  for(int i=0; i<kNumberOfProfiledCallbacks; i++) mProfilerSections[i] = -1;
   pFilterManager = new GateFilterManager(GetObjectName()+"_filter");
   GateDebugMessageDec("Actor",4,"GateVActor() -- end\n");
 }
@@ -55,6 +67,18 @@ GateVActor::~GateVActor()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateVActor::CreateProfilerSections()
+{
+  static const char * names[kNumberOfProfiledCallbacks] = {
+    "BeginOfRunAction", "EndOfRunAction", "BeginOfEventAction", "EndOfEventAction",
+    "PreUserTrackingAction", "PostUserTrackingAction", "UserSteppingAction" };
+  for(int i=0; i<kNumberOfProfiledCallbacks; i++)
+    mProfilerSections[i] = GateProfiler::GetSection("Actor", GetObjectName() + " " + names[i]);
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 // default callback for BeginOfRunAction
 void GateVActor::BeginOfRunAction(const G4Run*)
@@ -81,11 +105,21 @@ void GateVActor::EndOfRunAction(const G4Run*)
 // EndOfNEventAction (if it is enabled)
 void GateVActor::EndOfEventAction(const G4Event*e)
 {
+  if (mSaveEveryNEvents == 0 && mSaveEveryNSeconds == 0) return;
+
+#ifdef GATE_USE_MT
+  // The callbacks of a thread-safe shared actor are not serialized: one
+  // save at a time (the events in progress in the other threads are not
+  // in the saved data)
+  std::unique_ptr<G4AutoLock> lock;
+  if (IsSharedBetweenThreads() && IsThreadSafe()) lock.reset(new G4AutoLock(&saveEveryMutex));
+#endif
+
   int ne = e->GetEventID()+1;
 
   // Save every n events
   if ((ne != 0) && (mSaveEveryNEvents != 0))
-    if (ne % mSaveEveryNEvents == 0)  SaveData();
+    if (ne % mSaveEveryNEvents == 0) SaveIntermediateData();
 
   // Save every n seconds
   if (mSaveEveryNSeconds != 0) { // need to check time
@@ -94,7 +128,7 @@ void GateVActor::EndOfEventAction(const G4Event*e)
     long seconds  = end.tv_sec  - mTimeOfLastSaveEvent.tv_sec;
     if (seconds > mSaveEveryNSeconds) {
       //GateMessage("Core", 0, "Actor " << GetName() << " : " << mSaveEveryNSeconds << " seconds.\n");
-      SaveData();
+      SaveIntermediateData();
       mTimeOfLastSaveEvent = end;
     }
   }
@@ -102,6 +136,28 @@ void GateVActor::EndOfEventAction(const G4Event*e)
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+// In MT, the event IDs are shared by all the threads: the worker copy which
+// ends the n-th event merges its data into the master actor, which saves
+// them. The data not yet merged by the other worker copies are missing from
+// this intermediate save; they are all merged at the end of the run.
+void GateVActor::SaveIntermediateData()
+{
+#ifdef GATE_USE_MT
+  if (IsWorkerActor()) {
+    G4AutoLock lock(GateActorManager::GetMergeActorMutex());
+    pMasterActor->MergeWorkerData(this);
+    ResetData();
+    pMasterActor->SaveIntermediateData();
+    return;
+  }
+#endif
+  if (mIsAsyncSaveEnabled) SaveDataAsync();
+  else SaveData();
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 void GateVActor::SetSaveFilename(G4String  f)
 {
@@ -127,6 +183,9 @@ void GateVActor::AttachToVolume(G4String /*volumeName*/)
 //-----------------------------------------------------------------------------
 void GateVActor::SaveData()
 {
+  // Do not write the same files as a pending asynchronous save
+  if (mIsAsyncSaveEnabled) GateSnapshotWriter::GetInstance()->Wait(this);
+
   if (!this->mOverWriteFilesFlag) {
     mSaveFilename = GetSaveCurrentFilename(mSaveInitialFilename);
   }
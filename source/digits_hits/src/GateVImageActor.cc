@@ -359,6 +359,14 @@ int GateVImageActor::GetIndexFromTrackPosition(const GateVVolume * v , const G4T
 
 //-----------------------------------------------------------------------------
 int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Step * step)
+{
+  return GetIndexFromStepPosition(v, step, mStepHitType);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Step * step, StepHitType hitType)
 {
   if(v==0) return -1;
 
@@ -407,23 +415,23 @@ int GateVImageActor::GetIndexFromStepPosition(const GateVVolume * v, const G4Ste
   //http://geant4-hn.slac.stanford.edu:5090/HyperNews/public/get/eventtrackmanage/263/1/1.html
 
   int index=-1;
-  if (mStepHitType == PreStepHitType) {
+  if (hitType == PreStepHitType) {
     //index = mImage.GetIndexFromPrePosition(prePosition, postPosition);
     G4ThreeVector direction = postPosition - prePosition;
     index = mImage.GetIndexFromPostPositionAndDirection(prePosition, direction);
     //TODO Brent index = mImage.GetIndexFromPostPositionAndDirection(R x prePosition, direction);
   }
-  if (mStepHitType == PostStepHitType) {
+  if (hitType == PostStepHitType) {
     G4ThreeVector direction = postPosition - prePosition;
     index = mImage.GetIndexFromPostPositionAndDirection(postPosition, direction);
   }
-  if (mStepHitType == MiddleStepHitType) {
+  if (hitType == MiddleStepHitType) {
     G4ThreeVector middle = prePosition + postPosition;
     middle/=2.;
     GateDebugMessage("Step", 4, "GateVImageActor -- GetIndexFromStepPosition:\tMiddleStep  = " << middle << Gateendl);
     index = mImage.GetIndexFromPosition(middle);
   }
-  if (mStepHitType == RandomStepHitType) {
+  if (hitType == RandomStepHitType) {
     G4double x = G4UniformRand();
     GateDebugMessage("Step", 4, "GateVImageActor -- GetIndexFromStepPosition:\tx         = " << x << Gateendl);
     G4ThreeVector direction = postPosition-prePosition;
@@ -31,6 +31,13 @@
 
 #include <ctime>
 #include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <functional>
 
 //-----------------------------------------------------------------------------
 GateVoxelizedMass::GateVoxelizedMass()
@@ -41,9 +48,11 @@ GateVoxelizedMass::GateVoxelizedMass()
   mHasFilter            = false;
   mHasExternalMassImage = false;
   mHasSameResolution    = false;
+  mIsAxisAlignedBoxTree = false;
 
-  mMassFile       = "";
-  mMaterialFilter = "";
+  mMassFile           = "";
+  mMaterialFilter     = "";
+  mMassCacheDirectory = "";
 
   mCubicVolume.clear();
   mMass       .clear();
@@ -72,6 +81,19 @@ void GateVoxelizedMass::Initialize(G4String _mVolumeName, const GateVImage* _mIm
 
   GateMessage("Actor", 1, "[GateVoxelizedMass::" << __FUNCTION__ << "] Is parameterised ? " <<  mIsParameterised << Gateendl);
 
+  // Boxes without rotation: the dosel overlaps are computed analytically
+  // instead of with boolean solids
+  mIsAxisAlignedBoxTree = !mIsParameterised &&
+                          mImage->GetTransformMatrix().isIdentity() &&
+                          IsAxisAlignedBoxTree(DAPV);
+
+  GateMessage("Actor", 1, "[GateVoxelizedMass::" << __FUNCTION__ << "] Is made of axis-aligned boxes ? " <<  mIsAxisAlignedBoxTree << Gateendl);
+
+  mBoxTree     .clear();
+  mBoxTreeSizes.clear();
+  if (mIsAxisAlignedBoxTree)
+    BuildBoxTree(DAPV);
+
   if (!mIsParameterised) {
     mCubicVolume.resize(mImage->GetNumberOfValues());
     mMass       .resize(mImage->GetNumberOfValues());
@@ -128,6 +150,9 @@ void GateVoxelizedMass::Initialize(G4String _mVolumeName, const GateVImage* _mIm
 
     if (doselExternalMass.size() == 0)
       GenerateVoxels();
+
+    if (doselExternalMass.size() == 0)
+      GenerateLabelTables();
   }
 
   GateMessage("Actor", 1,  "[GateVoxelizedMass::" << __FUNCTION__ << "] Has same resolution ? " << mHasSameResolution << Gateendl);
@@ -168,6 +193,40 @@ bool GateVoxelizedMass::IsLVParameterized(const G4LogicalVolume* LV)
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+bool GateVoxelizedMass::IsAxisAlignedBoxTree(const G4VPhysicalVolume* PV)
+{
+  const G4LogicalVolume* LV = PV->GetLogicalVolume();
+
+  if (LV->GetSolid()->GetEntityType() != "G4Box" ||
+      PV->IsParameterised() || PV->IsReplicated() ||
+      !PV->GetObjectRotationValue().isIdentity())
+    return false;
+
+  for (int i=0; i<LV->GetNoDaughters(); i++)
+    if (!IsAxisAlignedBoxTree(LV->GetDaughter(i)))
+      return false;
+
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::BuildBoxTree(const G4VPhysicalVolume* PV)
+{
+  const G4LogicalVolume* LV = PV->GetLogicalVolume();
+  const size_t slot(mBoxTree.size());
+
+  mBoxTree     .push_back(std::make_pair(LV->GetSolid()->GetName(),0.));
+  mBoxTreeSizes.push_back(1);
+
+  for (int i=0; i<LV->GetNoDaughters(); i++)
+    BuildBoxTree(LV->GetDaughter(i));
+
+  mBoxTreeSizes[slot] = mBoxTree.size() - slot;
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 double GateVoxelizedMass::GetDoselMass(int index)
 {
@@ -193,18 +252,15 @@ double GateVoxelizedMass::GetDoselMass(int index)
     doselReconstructedMass.resize(mImage->GetNumberOfValues(),-1.);
   }
 
+  // With a cache, all the masses are computed (or read) at once
+  if (mMassCacheDirectory != "" && !mIsVecGenerated)
+    GenerateVectors();
+
   if(doselReconstructedMass[index] < 0.)
   {
     GateMessage("Actor", 11,  "[GateVoxelizedMass::" << __FUNCTION__ << "] I don't have the mass of this voxel (index: " << index << ")" << Gateendl);
 
-    if (mIsParameterised)
-      doselReconstructedData = ParameterizedVolume(index);
-    else
-      doselReconstructedData = VoxelIteration(DAPV,
-                                              0,
-                                              DAPV->GetObjectRotationValue(),
-                                              DAPV->GetObjectTranslation(),
-                                              index);
+    doselReconstructedData = ComputeDosel(index);
 
     doselReconstructedMass[index]        = doselReconstructedData.first;
   }
@@ -260,18 +316,48 @@ void GateVoxelizedMass::GenerateVectors()
   doselReconstructedTotalCubicVolume = 0.;
   doselReconstructedTotalMass        = 0.;
 
+  unsigned long long hash(0);
+  if (mMassCacheDirectory != "") {
+    hash = ComputeGeometryHash();
+    if (ReadMassCache(hash)) {
+      GateMessage("Actor", 0,  "[GateVoxelizedMass::" << __FUNCTION__ << "] Dosel masses read from " << GetMassCacheFileName(hash) << Gateendl);
+      mIsVecGenerated=true;
+      return;
+    }
+  }
+
+  if (mIsParameterised || mIsAxisAlignedBoxTree)
+  {
+    // Dosels are independent: split them between threads, one per hardware core
+    const long int nbOfDosels(mImage->GetNumberOfValues());
+    int nbOfThreads(std::thread::hardware_concurrency());
+    if (nbOfThreads < 1) nbOfThreads = 1;
+    if (nbOfThreads > nbOfDosels) nbOfThreads = (int)std::max(nbOfDosels, 1L);
+
+    GateMessage("Actor", 1, "[GateVoxelizedMass::" << __FUNCTION__ << "] Number of threads: " <<  nbOfThreads << Gateendl);
+
+    std::vector<double> threadMass(nbOfThreads, 0.);
+    std::vector<double> threadCubicVolume(nbOfThreads, 0.);
+    std::vector<std::thread> threads;
+    for (int t=1; t<nbOfThreads; t++)
+      threads.push_back(std::thread(&GateVoxelizedMass::ComputeDoselRange, this,
+                                    nbOfDosels*t/nbOfThreads, nbOfDosels*(t+1)/nbOfThreads,
+                                    std::ref(threadMass[t]), std::ref(threadCubicVolume[t])));
+    ComputeDoselRange(0, nbOfDosels/nbOfThreads, threadMass[0], threadCubicVolume[0]);
+    for (size_t t=0; t<threads.size(); t++)
+      threads[t].join();
+
+    for (int t=0; t<nbOfThreads; t++) {
+      doselReconstructedTotalMass        += threadMass[t];
+      doselReconstructedTotalCubicVolume += threadCubicVolume[t];
+    }
+  }
+  else // boolean solids are registered in the (global) solid store: serial loop
   for(signed long int i=0; i < mImage->GetNumberOfValues(); i++)
   {
     time(&timer3);
 
-    if(mIsParameterised)
-      doselReconstructedData = ParameterizedVolume(i);
-    else
-      doselReconstructedData = VoxelIteration(DAPV,
-                                              0,
-                                              DAPV->GetObjectRotationValue(),
-                                              DAPV->GetObjectTranslation(),
-                                              i);
+    doselReconstructedData = ComputeDosel(i);
 
     doselReconstructedMass[i]        = doselReconstructedData.first;
 
@@ -305,12 +391,61 @@ void GateVoxelizedMass::GenerateVectors()
               << "\tDosels reconstructed total cubic volume : "
               << G4BestUnit(doselReconstructedTotalCubicVolume,"Volume") << G4endl);
 
+  if (mMassCacheDirectory != "")
+    WriteMassCache(hash);
+
   mIsVecGenerated=true;
 
   GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Ended" << Gateendl);
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+std::pair<double,double> GateVoxelizedMass::ComputeDosel(int index)
+{
+  if (mIsParameterised)
+    return ParameterizedVolume(index);
+
+  if (mIsAxisAlignedBoxTree) {
+    const G4ThreeVector halfSize(mImage->GetVoxelSize()/2.);
+    const G4ThreeVector center(mImage->GetVoxelCenterFromIndex(index));
+    // One slot per box, reset at each computation of the dosel
+    mCubicVolume[index] = mBoxTree;
+    mMass       [index] = mBoxTree;
+    int slot(0);
+    std::pair<double,double> dosel(BoxIteration(DAPV, G4ThreeVector(), center-halfSize, center+halfSize, index, slot));
+
+    if (mHasFilter && mVolumeFilter != "") {
+      for (size_t i=0; i<mMass[index].size(); i++)
+        if (mMass[index][i].first == mVolumeFilter)
+          return std::make_pair(mMass[index][i].second, mCubicVolume[index][i].second);
+      return std::make_pair(0.,0.);
+    }
+    return dosel;
+  }
+
+  return VoxelIteration(DAPV,
+                        0,
+                        DAPV->GetObjectRotationValue(),
+                        DAPV->GetObjectTranslation(),
+                        index);
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::ComputeDoselRange(long int first, long int last, double & totalMass, double & totalCubicVolume)
+{
+  totalMass        = 0.;
+  totalCubicVolume = 0.;
+  for (long int i=first; i<last; i++) {
+    const std::pair<double,double> dosel(ComputeDosel(i));
+    doselReconstructedMass[i] = dosel.first;
+    totalMass        += dosel.first;
+    totalCubicVolume += dosel.second;
+  }
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void GateVoxelizedMass::GenerateVoxels()
 {
@@ -381,6 +516,40 @@ void GateVoxelizedMass::GenerateVoxels()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::GenerateLabelTables()
+{
+  // The material database is not accessed from the dosel threads: the density
+  // and the material filter result are tabulated once per label
+  const GateImage* labelImage(imageVolume->GetImage());
+
+  int maxLabel(0);
+  for (signed long int i=0; i < labelImage->GetNumberOfValues(); i++) {
+    const int label((int)labelImage->GetValue(i));
+    if (label < 0)
+      GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: negative label in the image of " << mVolumeName << " (index: " << i << ", label: " << label << ")" << Gateendl);
+    maxLabel = std::max(maxLabel, label);
+  }
+
+  mLabelDensity   .assign(maxLabel+1, 0.);
+  mLabelIsSelected.assign(maxLabel+1, 0);
+
+  for (signed long int i=0; i < labelImage->GetNumberOfValues(); i++) {
+    const int label((int)labelImage->GetValue(i));
+    if (mLabelDensity[label] > 0.) continue;
+
+    const G4String matName(imageVolume->GetMaterialNameFromLabel(label));
+    mLabelDensity[label] = theMaterialDatabase.GetMaterial(matName)->GetDensity();
+
+    if (mLabelDensity[label] <= 0.)
+      GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: density of material " << matName << " (label " << label << ") is less or equal to zero !" << Gateendl);
+
+    mLabelIsSelected[label] = (mMaterialFilter == "" || mMaterialFilter == matName);
+  }
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 G4String GateVoxelizedMass::GetVoxelMatName(int x, int y, int z)
 {
@@ -420,17 +589,15 @@ G4double GateVoxelizedMass::GetVoxelMass(int x, int y, int z)
 
 
 //-----------------------------------------------------------------------------
-void GateVoxelizedMass::GenerateDosels(int index)
+void GateVoxelizedMass::GenerateDosels(int index, double doselMin[3], double doselMax[3])
 {
   GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Started" << Gateendl);
   // INFO : Dimension of the vectors : x = 0, y = 1, z = 2
 
-  doselMin.resize(3,-1.);
   doselMin[0]=(DABox->GetXHalfLength()+mImage->GetVoxelCenterFromIndex(index).getX()-mImage->GetVoxelSize().getX()/2.0)/imageVolume->GetImage()->GetVoxelSize().x();
   doselMin[1]=(DABox->GetYHalfLength()+mImage->GetVoxelCenterFromIndex(index).getY()-mImage->GetVoxelSize().getY()/2.0)/imageVolume->GetImage()->GetVoxelSize().y();
   doselMin[2]=(DABox->GetZHalfLength()+mImage->GetVoxelCenterFromIndex(index).getZ()-mImage->GetVoxelSize().getZ()/2.0)/imageVolume->GetImage()->GetVoxelSize().z();
 
-  doselMax.resize(3,-1.);
   doselMax[0]=(DABox->GetXHalfLength()+mImage->GetVoxelCenterFromIndex(index).getX()+mImage->GetVoxelSize().getX()/2.0)/imageVolume->GetImage()->GetVoxelSize().x();
   doselMax[1]=(DABox->GetYHalfLength()+mImage->GetVoxelCenterFromIndex(index).getY()+mImage->GetVoxelSize().getY()/2.0)/imageVolume->GetImage()->GetVoxelSize().y();
   doselMax[2]=(DABox->GetZHalfLength()+mImage->GetVoxelCenterFromIndex(index).getZ()+mImage->GetVoxelSize().getZ()/2.0)/imageVolume->GetImage()->GetVoxelSize().z();
@@ -444,10 +611,15 @@ std::pair<double,double> GateVoxelizedMass::ParameterizedVolume(int index)
 {
   GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Started" << Gateendl);
 
-  GenerateDosels(index);
+  // Only local variables and read-only tables: called concurrently by GenerateVectors
+  double doselMin[3], doselMax[3];
+  GenerateDosels(index, doselMin, doselMax);
+
+  const GateImage* labelImage(imageVolume->GetImage());
+  const G4double voxelVolume(GetVoxelVolume());
 
   G4double doselReconstructedVolume = 0.;
-  doselReconstructedMass[index]     = 0.;
+  G4double doselMass                = 0.;
 
   for(int x=round(doselMin[0]);x<round(doselMax[0]);x++)
     for(int y=round(doselMin[1]);y<round(doselMax[1]);y++)
@@ -545,38 +717,41 @@ std::pair<double,double> GateVoxelizedMass::ParameterizedVolume(int index)
         for(size_t xVox=0;xVox<coord[0].size();xVox++)
           for(size_t yVox=0;yVox<coord[1].size();yVox++)
             for(size_t zVox=0;zVox<coord[2].size();zVox++)
-              if (mMaterialFilter == "" ||
-                  mMaterialFilter == GetVoxelMatName(coord[0][xVox], coord[1][yVox], coord[2][zVox]))
+            {
+              const int label((int)labelImage->GetValue(coord[0][xVox], coord[1][yVox], coord[2][zVox]));
+
+              if (mLabelIsSelected[label])
               {
                 const double coefVox(coef[0][xVox] * coef[1][yVox] * coef[2][zVox]);
 
-                doselReconstructedVolume      += GetVoxelVolume() * coefVox;
-                doselReconstructedMass[index] += GetVoxelMass(coord[0][xVox], coord[1][yVox], coord[2][zVox]) * coefVox;
+                doselReconstructedVolume += voxelVolume * coefVox;
+                doselMass                += mLabelDensity[label] * voxelVolume * coefVox;
 
                 if(doselReconstructedVolume < 0.)
                   GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR : doselReconstructedVolume is negative !" << Gateendl
                           <<"     More informations :" << Gateendl
                           <<"            doselReconstructedVolume=" << doselReconstructedVolume << Gateendl
-                          <<"            Voxel Volume: " << GetVoxelVolume() << Gateendl
+                          <<"            Voxel Volume: " << voxelVolume << Gateendl
                           <<"            coefVox=" << coefVox <<Gateendl);
 
-                if(doselReconstructedMass[index] < 0.)
+                if(doselMass < 0.)
                   GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR : doselReconstructedMass is negative !" << Gateendl
                           <<"     More informations:" << Gateendl
-                          <<"            doselReconstructedMass[" << index << "]=" << doselReconstructedMass[index] << Gateendl
-                          <<"            Voxel Mass: " << GetVoxelMass(coord[0][xVox], coord[1][yVox], coord[2][zVox]) << Gateendl
+                          <<"            doselReconstructedMass[" << index << "]=" << doselMass << Gateendl
+                          <<"            Voxel Mass: " << mLabelDensity[label] * voxelVolume << Gateendl
                           <<"            coefVox= " << coefVox << Gateendl);
               }
+            }
       }
 
-  if(doselReconstructedMass[index] < 0.)
-    GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: doselReconstructedMass is negative ! (doselReconstructedMass["<<index<<"] = "<<doselReconstructedMass[index]<<")"<<Gateendl);
+  if(doselMass < 0.)
+    GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: doselReconstructedMass is negative ! (doselReconstructedMass["<<index<<"] = "<<doselMass<<")"<<Gateendl);
   if(doselReconstructedVolume < 0.)
     GateError("[GateVoxelizedMass::" << __FUNCTION__ << "] ERROR: doselReconstructedVolume is negative ! (doselReconstructedVolume = "<<doselReconstructedVolume<<")"<<Gateendl);
 
   GateMessage("Actor", 10, "[GateVoxelizedMass::" << __FUNCTION__ << "] Ended" << Gateendl);
 
-  return std::make_pair(doselReconstructedMass[index],doselReconstructedVolume);
+  return std::make_pair(doselMass,doselReconstructedVolume);
 }
 //-----------------------------------------------------------------------------
 
@@ -822,6 +997,204 @@ std::pair<double,double> GateVoxelizedMass::VoxelIteration(const G4VPhysicalVolu
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+std::pair<double,double> GateVoxelizedMass::BoxIteration(const G4VPhysicalVolume* motherPV,
+                                                         G4ThreeVector motherTranslation,
+                                                         const G4ThreeVector & doselMin,
+                                                         const G4ThreeVector & doselMax,
+                                                         int index,
+                                                         int & slot)
+{
+  // Exact counterpart of VoxelIteration for unrotated boxes: the part of the
+  // mother inside the dosel is its overlap minus the overlaps of its daughters
+  // (which Geant4 requires to be inside the mother and not to overlap)
+  const G4LogicalVolume* motherLV(motherPV->GetLogicalVolume());
+  const G4Box*           motherSV((const G4Box*)motherLV->GetSolid());
+
+  const G4ThreeVector halfLength(motherSV->GetXHalfLength(),
+                                 motherSV->GetYHalfLength(),
+                                 motherSV->GetZHalfLength());
+
+  // Slot of the mother (see BuildBoxTree): when the dosel misses it, its
+  // daughters are skipped and their slots stay at zero
+  const int motherSlot(slot++);
+
+  double overlap(1.);
+  for (int dim=0; dim<3; dim++) {
+    const double low (std::max(doselMin[dim], motherTranslation[dim]-halfLength[dim]));
+    const double high(std::min(doselMax[dim], motherTranslation[dim]+halfLength[dim]));
+    if (high <= low) {
+      slot = motherSlot + mBoxTreeSizes[motherSlot];
+      return std::make_pair(0.,0.);
+    }
+    overlap *= high-low;
+  }
+
+  double motherCubicVolume(overlap);
+  double motherProgenyMass(0.);
+
+  for (int i=0; i<motherLV->GetNoDaughters(); i++) {
+    const G4VPhysicalVolume* daughterPV(motherLV->GetDaughter(i));
+    const std::pair<double,double> daughter(BoxIteration(daughterPV,
+                                                         motherTranslation + daughterPV->GetObjectTranslation(),
+                                                         doselMin, doselMax, index, slot));
+    motherProgenyMass += daughter.first;
+    motherCubicVolume -= daughter.second;
+  }
+
+  if (motherCubicVolume < 0.)
+    motherCubicVolume = 0.;
+
+  const double motherMass(motherCubicVolume * motherLV->GetMaterial()->GetDensity());
+  motherProgenyMass += motherMass;
+
+  mCubicVolume[index][motherSlot].second = motherCubicVolume;
+  mMass       [index][motherSlot].second = motherMass;
+
+  return std::make_pair(motherProgenyMass,overlap);
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+unsigned long long GateVoxelizedMass::ComputeGeometryHash()
+{
+  // FNV-1a hash of everything the dosel masses depend on
+  std::ostringstream description;
+  description << std::setprecision(17)
+              << mVolumeName << ' ' << mIsParameterised << ' ' << mIsAxisAlignedBoxTree << ' '
+              << mImage->GetResolution() << ' ' << mImage->GetHalfSize() << ' '
+              << mImage->GetOrigin() << ' ' << mImage->GetTransformMatrix() << ' '
+              << mMaterialFilter << ' ' << mVolumeFilter << '\n';
+
+  unsigned long long hash(14695981039346656037ULL);
+  const std::string str(description.str());
+  for (size_t i=0; i<str.size(); i++) {
+    hash ^= (unsigned char)str[i];
+    hash *= 1099511628211ULL;
+  }
+
+  if (mIsParameterised) {
+    const GateImage* labelImage(imageVolume->GetImage());
+    std::ostringstream labels;
+    labels << std::setprecision(17)
+           << labelImage->GetResolution() << ' ' << labelImage->GetVoxelSize() << '\n';
+    for (size_t l=0; l<mLabelDensity.size(); l++)
+      labels << mLabelDensity[l] << ' ' << (int)mLabelIsSelected[l] << '\n';
+    const std::string labelStr(labels.str());
+    for (size_t i=0; i<labelStr.size(); i++) {
+      hash ^= (unsigned char)labelStr[i];
+      hash *= 1099511628211ULL;
+    }
+    for (signed long int i=0; i < labelImage->GetNumberOfValues(); i++) {
+      const int label((int)labelImage->GetValue(i));
+      for (size_t b=0; b<sizeof(label); b++) {
+        hash ^= (label >> (8*b)) & 0xff;
+        hash *= 1099511628211ULL;
+      }
+    }
+  }
+  else
+    HashVolume(hash, DAPV);
+
+  return hash;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::HashVolume(unsigned long long & hash, const G4VPhysicalVolume* PV)
+{
+  const G4LogicalVolume* LV(PV->GetLogicalVolume());
+
+  std::ostringstream description;
+  description << std::setprecision(17)
+              << PV->GetName() << ' ' << PV->GetObjectTranslation() << ' '
+              << PV->GetObjectRotationValue() << ' '
+              << LV->GetMaterial()->GetName() << ' ' << LV->GetMaterial()->GetDensity() << '\n';
+  LV->GetSolid()->StreamInfo(description);
+
+  const std::string str(description.str());
+  for (size_t i=0; i<str.size(); i++) {
+    hash ^= (unsigned char)str[i];
+    hash *= 1099511628211ULL;
+  }
+
+  for (int i=0; i<LV->GetNoDaughters(); i++)
+    HashVolume(hash, LV->GetDaughter(i));
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+G4String GateVoxelizedMass::GetMassCacheFileName(unsigned long long hash)
+{
+  std::ostringstream name;
+  name << mMassCacheDirectory << "/mass_" << std::hex << std::setw(16) << std::setfill('0') << hash << ".bin";
+  return name.str();
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+bool GateVoxelizedMass::ReadMassCache(unsigned long long hash)
+{
+  std::ifstream is(GetMassCacheFileName(hash).c_str(), std::ios::in | std::ios::binary);
+  if (!is) return false;
+
+  unsigned long long fileHash(0), nbOfDosels(0);
+  is.read((char*)&fileHash,   sizeof(fileHash));
+  is.read((char*)&nbOfDosels, sizeof(nbOfDosels));
+  if (!is || fileHash != hash || nbOfDosels != (unsigned long long)mImage->GetNumberOfValues()) {
+    GateWarning("Dosel mass cache " << GetMassCacheFileName(hash) << " does not match the geometry. Ignored.");
+    return false;
+  }
+
+  std::vector<double> mass(nbOfDosels);
+  double totalMass(0.), totalCubicVolume(0.);
+  is.read((char*)&mass[0],          nbOfDosels*sizeof(double));
+  is.read((char*)&totalMass,        sizeof(double));
+  is.read((char*)&totalCubicVolume, sizeof(double));
+  if (!is) {
+    GateWarning("Dosel mass cache " << GetMassCacheFileName(hash) << " is truncated. Ignored.");
+    return false;
+  }
+
+  doselReconstructedMass             = mass;
+  doselReconstructedTotalMass        = totalMass;
+  doselReconstructedTotalCubicVolume = totalCubicVolume;
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+void GateVoxelizedMass::WriteMassCache(unsigned long long hash)
+{
+  // Written to a temporary file first, so that a concurrent run never reads
+  // a partial cache
+  const G4String fileName(GetMassCacheFileName(hash));
+  std::ostringstream tmpName;
+  tmpName << fileName << ".tmp" << this;
+
+  std::ofstream os(tmpName.str().c_str(), std::ios::out | std::ios::binary);
+  if (!os) {
+    GateWarning("Cannot write the dosel mass cache in " << mMassCacheDirectory);
+    return;
+  }
+
+  const unsigned long long nbOfDosels(doselReconstructedMass.size());
+  os.write((const char*)&hash,       sizeof(hash));
+  os.write((const char*)&nbOfDosels, sizeof(nbOfDosels));
+  os.write((const char*)&doselReconstructedMass[0],          nbOfDosels*sizeof(double));
+  os.write((const char*)&doselReconstructedTotalMass,        sizeof(double));
+  os.write((const char*)&doselReconstructedTotalCubicVolume, sizeof(double));
+  os.close();
+
+  if (!os || std::rename(tmpName.str().c_str(), fileName.c_str()) != 0) {
+    GateWarning("Cannot write the dosel mass cache " << fileName);
+    std::remove(tmpName.str().c_str());
+  }
+  else
+    GateMessage("Actor", 1, "[GateVoxelizedMass::" << __FUNCTION__ << "] Dosel masses stored in " << fileName << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 double GateVoxelizedMass::GetPartialVolumeWithSV(int index,G4String SVName)
 {
@@ -831,7 +1204,7 @@ double GateVoxelizedMass::GetPartialVolumeWithSV(int index,G4String SVName)
   }
 
   if(mCubicVolume[index].empty())
-    GetDoselMass(index);
+    ComputeDosel(index); // the dosel mass itself may come from the cache
 
   for(size_t i=0;i<mCubicVolume[index].size();i++)
     if(mCubicVolume[index][i].first==SVName)
@@ -851,7 +1224,7 @@ double GateVoxelizedMass::GetPartialMassWithSV(int index,G4String SVName)
   }
 
   if(mMass[index].empty())
-    GetDoselMass(index);
+    ComputeDosel(index); // the dosel mass itself may come from the cache
 
   for(size_t i=0;i<mMass[index].size();i++)
     if(mMass[index][i].first==SVName)
@@ -0,0 +1,54 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class  GateAliasTable
+  \brief  Walker alias method: samples an index with a probability
+  \brief  proportional to its weight, in constant time.
+*/
+
+#ifndef GATEALIASTABLE_HH
+#define GATEALIASTABLE_HH
+
+#include "globals.hh"
+#include <vector>
+
+class GateAliasTable
+{
+public:
+  GateAliasTable();
+  ~GateAliasTable() {}
+
+  // Build the table (Vose's algorithm, linear time). Weights must be
+  // positive; the storage is kept when the table is rebuilt with the same
+  // number of weights.
+  void Build(const std::vector<G4double> & weights);
+  void Clear();
+
+  // Sample an index in [0, size) with the given uniform random number in [0,1)
+  inline G4int Sample(G4double u) const {
+    G4double x = u * mSize;
+    G4int i = G4int(x);
+    if (i >= mSize) i = mSize-1;
+    return (x - i < mProbability[i]) ? i : mAlias[i];
+  }
+
+  G4int GetSize() const { return mSize; }
+  G4double GetTotalWeight() const { return mTotalWeight; }
+
+protected:
+  G4int mSize;
+  G4double mTotalWeight;
+  std::vector<G4double> mProbability;
+  std::vector<G4int> mAlias;
+  std::vector<G4int> mSmall;
+  std::vector<G4int> mLarge;
+};
+
+#endif
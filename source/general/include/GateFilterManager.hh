@@ -39,7 +39,9 @@ public:
   virtual G4bool Accept(const G4Step*) const;
   virtual G4bool Accept(const G4Track*) const;
 
-  void AddFilter(GateVFilter* filter){theFilters.push_back(filter);}
+  void AddFilter(GateVFilter* filter);
+  // Resolves the names of all the filters (see GateVFilter::Initialize)
+  void Initialize();
   G4int GetNumberOfFilters(){return theFilters.size();}
   void show();
 
@@ -47,6 +49,14 @@ protected:
   G4String mFilterName;
   std::vector<GateVFilter*> theFilters;
 
+  // Filters split at AddFilter: the result of the track invariant ones is
+  // cached per track (and per thread, the manager of a shared actor is
+  // used by all the workers)
+  std::vector<GateVFilter*> mTrackInvariantFilters;
+  std::vector<GateVFilter*> mStepFilters;
+  G4int mCacheIndex;
+  G4bool AcceptTrackInvariant(const G4Track*) const;
+
 private:
   
 };
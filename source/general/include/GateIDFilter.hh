@@ -33,6 +33,7 @@ public:
   FCT_FOR_AUTO_CREATOR_FILTER(GateIDFilter)
 
   virtual G4bool Accept(const G4Track*);
+  virtual G4bool IsTrackInvariant() const { return true; }
 
   void addID(G4int id);
   void addParentID(G4int id);
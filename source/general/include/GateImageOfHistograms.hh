@@ -31,8 +31,14 @@
   initial 'data' member will result in a seg fault. Use
   GetDataDoublePointer.
 
-  FIXME:
-  - manage a sparse version (not an histo at every pixel)
+  Sparse storage (SetSparseStorage(true) before Allocate, 'double' or
+  'float' only): the histogram of a pixel is only allocated the first
+  time a value is added to it. Histograms are stored in fixed size
+  blocks of kHistogramsPerBlock histograms (no reallocation when the
+  storage grows) and each pixel stores the number of its histogram (-1
+  if empty). Empty pixels are written as zeros, the file format is
+  the same. In this mode, GetDataDoublePointer/GetDataFloatPointer
+  must not be used and Read always gives a dense image.
 
 */
 
@@ -45,6 +51,9 @@ public:
   ~GateImageOfHistograms();
 
   void SetHistoInfo(int n, double min, double max);
+  void SetSparseStorage(bool b) { mSparseStorageFlag = b; }
+  bool IsSparseStorage() const { return mSparseStorageFlag; }
+  long GetNumberOfAllocatedHistograms() const { return mNbOfSparseHistograms; }
   virtual void Allocate();
   void Reset();
   void AddValueFloat(const int & index, TH1D * h, const double scale);
@@ -94,6 +103,27 @@ protected:
   long sizeZ;
   long sizePlane;
 
+  // Sparse storage
+  static const int kHistogramsPerBlock = 1024;
+  bool mSparseStorageFlag;
+  std::vector<int> mHistogramIndex;
+  long mNbOfSparseHistograms;
+  std::vector<std::vector<double> > mSparseDouble;
+  std::vector<std::vector<float> > mSparseFloat;
+  void ClearSparseStorage();
+  template<class PT>
+  PT * GetSparseHistogram(long index, std::vector<std::vector<PT> > & blocks);
+  template<class PT>
+  const PT * FindSparseHistogram(long index, const std::vector<std::vector<PT> > & blocks) const;
+  template<class PT>
+  bool WriteSparseToXYZH(const std::vector<std::vector<PT> > & blocks,
+                         std::ofstream & os) const;
+  template<class PT>
+  void ComputeSparseTotalOfCounts(const std::vector<std::vector<PT> > & blocks,
+                                  std::vector<PT> & output) const;
+  template<class PT>
+  void AccumulateHistogram(PT * output, TH1D * h, const double scale) const;
+
   // Data pixel order
   template<class PT>
   void ConvertPixelOrderToXYZH(std::vector<PT> & input, std::vector<PT> & output);
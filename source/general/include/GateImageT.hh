@@ -56,6 +56,17 @@ public:
 
   /// Allocates the data
   virtual void Allocate();
+  /// Frees the data, the size and geometry of the image are kept (call
+  /// Allocate before accessing the values again)
+  void ReleaseData() { std::vector<PixelType>().swap(data); }
+
+  /// Reserves room for a margin of n voxels that will be added by
+  /// AddMargin, so that the data are allocated once (call before Read)
+  void ReserveMargin(int n) { mReservedMargin = n; }
+
+  /// Surrounds the image with n voxels of value v, in place. The origin
+  /// is not changed.
+  void AddMargin(int n, PixelType v);
 
   // Access to the image values
   /// Returns the value of the image at voxel of index provided
@@ -117,6 +128,7 @@ public:
 protected:
   std::vector<PixelType> data;
   PixelType mOutsideValue;
+  int mReservedMargin;
 
   void ReadAscii(G4String filename);
   void ReadAnalyze(G4String filename);
@@ -129,7 +141,7 @@ protected:
   void WriteBin(std::ofstream & os);
   void WriteAnalyzeHeader(G4String filename);
   void WriteRoot(G4String filename);
-  void WriteMHD(std::string filename);
+  void WriteMHD(std::string filename, const G4String & comment = "");
   void WriteDICOM(std::string filename);
 
 };
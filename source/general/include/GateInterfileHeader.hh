@@ -65,27 +65,29 @@ private:
 //-----------------------------------------------------------------------------
 template <class ReadPixelType, class OutputPixelType>
 void GateInterfileHeader::DoDataRead(std::vector<OutputPixelType> &data) {
-  G4int pixelNumber = m_dim[0]*m_dim[1]*m_numPlanes ;
+  G4int planeSize = m_dim[0]*m_dim[1];
+  G4int pixelNumber = planeSize*m_numPlanes ;
   std::ifstream is;
   OpenFileInput(m_dataFileName, is);
-  std::vector<ReadPixelType> temp(pixelNumber);
 
+  // Read and convert plane by plane, the whole file is never in memory
+  std::vector<ReadPixelType> temp(planeSize);
   data.resize(pixelNumber);
   is.seekg(m_offset, std::ios::beg);
-  is.read((char*)(&(temp[0])), pixelNumber*sizeof(ReadPixelType));
-  if (!is) {
-    G4cerr << Gateendl <<"Error: the number of pixels that were read from the data file (" << is.gcount() << ") \n"
-           << "is inferior to the number computed from its header file (" << pixelNumber << ")!\n";
-    G4Exception( "GateInterfileHeader.cc InterfileTooShort", "InterfileTooShort", FatalException, "Correct problem then try again... Sorry!" );
-  }
-  for(unsigned int i=0; i<temp.size(); i++) {
-    if ( BYTE_ORDER != m_dataByteOrder ) {
+  for(G4int k=0; k<m_numPlanes; k++) {
+    is.read((char*)(&(temp[0])), planeSize*sizeof(ReadPixelType));
+    if (!is) {
+      G4cerr << Gateendl <<"Error: the number of pixels that were read from the data file ("
+             << k*planeSize + is.gcount()/sizeof(ReadPixelType) << ") \n"
+             << "is inferior to the number computed from its header file (" << pixelNumber << ")!\n";
+      G4Exception( "GateInterfileHeader.cc InterfileTooShort", "InterfileTooShort", FatalException, "Correct problem then try again... Sorry!" );
+    }
+    OutputPixelType * p = &(data[k*planeSize]);
+    for(G4int i=0; i<planeSize; i++) {
       ReadPixelType t = temp[i];
-      GateMachine::SwapEndians( t );
-      temp[i] = t;
-      //	  GateMachine::SwapEndians( temp[i] );
+      if ( BYTE_ORDER != m_dataByteOrder ) GateMachine::SwapEndians( t );
+      p[i] = (OutputPixelType)t;
     }
-    data[i] = (OutputPixelType)temp[i];
   }
   is.close();
 }
@@ -15,9 +15,12 @@
 
 // std
 #include <vector>
+#include <fstream>
+#include <typeinfo>
 
 // gate
 #include "GateMessageManager.hh"
+#include "GateMachine.hh"
 
 // itk (for mhd reader)
 //#include "metaObject.h"
@@ -45,7 +48,8 @@ public:
                    bool writeData = false,
                    bool changeExtension = false,
                    bool isARF = false,
-                   int numberOfARFFFDHeads = 1);
+                   int numberOfARFFFDHeads = 1,
+                   const std::string & comment = "");
   template<class PixelType>
   void WriteData(std::string filename, GateImageT<PixelType> * image);
 
@@ -69,6 +73,14 @@ protected:
                       bool changeExtension = false);
   double round_to_digits(double, int);
 
+  // Raw data reading without intermediate copy of the whole image
+  bool GetRawDataLocation(const std::string & headerName, const MetaImage & m,
+                          std::string & rawName, long & offset);
+  template<class FileType, class PixelType>
+  void ReadRawData(const std::string & rawName, long offset, bool swapBytes,
+                   std::vector<PixelType> & data);
+  void ReadRawBytes(const std::string & rawName, long offset, char * dest, size_t length);
+
 };
 
 #include "GateMHDImage.icc"
@@ -16,6 +16,7 @@ See LICENSE.md for further details
 #include "GateVFilter.hh"
 #include "GateActorManager.hh"
 #include "GateMaterialFilterMessenger.hh"
+#include "G4Material.hh"
 
 class  GateMaterialFilter : 
   public GateVFilter
@@ -33,9 +34,19 @@ public:
 
 private:
  std::vector<G4String> theMdef;
+
+ // Accepted materials, indexed by G4Material::GetIndex()
+ G4bool IsAccepted(const G4Material * material);
+ virtual void InitializeFilter();
+ std::vector<bool> mIsMaterialAccepted;
  GateMaterialFilterMessenger * pMatMessenger;
- 
- int nFilteredParticles;
+
+ // Only used to warn when no particle has been selected (set by all the
+ // workers of a shared actor)
+ std::atomic<bool> mHasSelectedParticles;
+ inline void SetSelectedParticles() {
+   if (!mHasSelectedParticles.load(std::memory_order_relaxed)) mHasSelectedParticles.store(true, std::memory_order_relaxed);
+ }
 };
 
 MAKE_AUTO_CREATOR_FILTER(materialFilter,GateMaterialFilter)
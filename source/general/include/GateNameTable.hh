@@ -0,0 +1,51 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class  GateNameTable
+  \brief  Interned strings (volume and process names) used by the hits and
+  \brief  pulses: they store a small integer ID instead of a G4String, so
+  \brief  that copying a hit or a pulse does not copy any string.
+
+  The ID 0 is the empty string; "Transportation" and "NULL" have fixed IDs
+  too. Interning a name takes a lock in MT and should be done once, outside
+  the hit path; reading a name from its ID never locks.
+*/
+
+#ifndef GATENAMETABLE_HH
+#define GATENAMETABLE_HH
+
+#include "globals.hh"
+#include <atomic>
+#include <map>
+
+class GateNameTable
+{
+public:
+  enum { kEmptyID = 0, kTransportationID = 1, kNullID = 2 };
+
+  static G4int GetID(const G4String & name);
+  static const G4String & GetName(G4int id);
+
+private:
+  GateNameTable();
+  static GateNameTable & GetInstance();
+
+  // The names are stored in chunks which are never moved nor freed, so that
+  // they are read without lock while other names are added
+  enum { kChunkBits = 8, kChunkSize = 1 << kChunkBits, kMaxNbOfChunks = 4096 };
+  struct Chunk { G4String names[kChunkSize]; };
+  std::atomic<Chunk*> mChunks[kMaxNbOfChunks];
+  G4int mNbOfNames;
+  std::map<G4String, G4int> mIDs;  // (only used when interning)
+
+  G4int Add(const G4String & name);
+};
+
+#endif
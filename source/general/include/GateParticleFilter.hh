@@ -36,6 +36,7 @@ public:
   FCT_FOR_AUTO_CREATOR_FILTER(GateParticleFilter)
 
   virtual G4bool Accept(const G4Track *);
+  virtual G4bool IsTrackInvariant() const { return true; }
 
   void Add(const G4String &particleName);
   void AddZ(const G4int &particleZ);
@@ -54,9 +55,21 @@ private:
   std::vector<G4int> thePdefPDG;
   std::vector<G4String> theParentPdef;
   std::vector<G4String> theDirectParentPdef;
+
+  // Names of thePdef resolved into particle definitions
+  virtual void InitializeFilter();
+  std::vector<const G4ParticleDefinition*> mAcceptedDefinitions;
+  std::vector<G4String> mUnresolvedNames;
+  bool mAcceptGenericIons;
+
   GateParticleFilterMessenger *pPartMessenger;
 
-  int nFilteredParticles;
+  // Only used to warn when no particle has been selected (set by all the
+  // workers of a shared actor)
+  std::atomic<bool> mHasSelectedParticles;
+  inline void SetSelectedParticles() {
+    if (!mHasSelectedParticles.load(std::memory_order_relaxed)) mHasSelectedParticles.store(true, std::memory_order_relaxed);
+  }
 };
 
 MAKE_AUTO_CREATOR_FILTER(particleFilter, GateParticleFilter)
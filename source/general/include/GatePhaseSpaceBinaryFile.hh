@@ -0,0 +1,162 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \file GatePhaseSpaceBinaryFile.hh
+  \brief Native binary phase space format (extension .gphsp)
+
+  The file starts with a 64 bytes header followed by blocks of a fixed
+  number of particles. Inside a block the values are stored by column:
+  PDG code (int32), then energy, x, y, z, dx, dy, dz, weight and time
+  (float32), each column holding 'blockSize' values. Units are the Geant4
+  internal units (MeV, mm, ns). The last block is padded to the block
+  size, the number of particles in the header tells how many are valid.
+
+  The writer is used by GatePhaseSpaceActor, the reader by
+  GateSourcePhaseSpace. The reader memory-maps the files and decodes the
+  next block on a background thread while the current one is consumed.
+*/
+
+#ifndef GATEPHASESPACEBINARYFILE_HH
+#define GATEPHASESPACEBINARYFILE_HH
+
+#include "globals.hh"
+#include <stdint.h>
+#include <fstream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//-----------------------------------------------------------------------------
+struct GatePhaseSpaceBinaryRecord
+{
+  G4int pdgCode;
+  float energy;
+  float x, y, z;
+  float dx, dy, dz;
+  float weight;
+  float time;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+struct GatePhaseSpaceBinaryHeader
+{
+  char magic[8];        // "GATEPHSP"
+  uint32_t version;
+  uint32_t blockSize;   // number of particles per block
+  uint64_t nParticles;
+  char reserved[40];
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+class GatePhaseSpaceBinaryWriter
+{
+public:
+  GatePhaseSpaceBinaryWriter(G4int blockSize = 4096);
+  ~GatePhaseSpaceBinaryWriter();
+
+  void Open(const G4String & filename);
+  void Write(const GatePhaseSpaceBinaryRecord & record);
+
+  // Write the pending particles and the header: the file is valid after
+  // this call and stays open for the next particles.
+  void Flush();
+  void Close();
+
+  G4long GetNumberOfParticles() const { return mNumberOfParticles; }
+
+protected:
+  void WriteBlock(G4long blockIndex);
+  void WriteHeader();
+
+  std::ofstream mFile;
+  G4String mFilename;
+  G4int mBlockSize;
+  G4int mNumberOfParticlesInBlock;
+  G4long mNumberOfFullBlocks;
+  G4long mNumberOfParticles;
+  std::vector<int32_t> mPDGCodes;
+  std::vector<float> mColumns;
+};
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+class GatePhaseSpaceBinaryReader
+{
+public:
+  GatePhaseSpaceBinaryReader();
+  ~GatePhaseSpaceBinaryReader();
+
+  void AddFile(const G4String & filename);
+  G4long GetNumberOfParticles() const { return mNumberOfParticles; }
+
+  // Only keep the particles with |x|<rmax and |y|<rmax (0 = no selection).
+  // Return the number of selected particles.
+  G4long SetSquareSelection(G4double rmax);
+
+  // Replay the blocks in a random order, reshuffled at each pass
+  void SetShuffleBlocks(bool b) { mShuffleBlocks = b; }
+
+  // (Re)start the replay at the given particle
+  void Start(G4long firstParticle);
+
+  // Next particle, loop over the files when the end is reached
+  const GatePhaseSpaceBinaryRecord & Next();
+
+protected:
+  struct MappedFile {
+    G4String name;
+    char * data;
+    size_t size;
+    G4int blockSize;
+    G4long nParticles;
+  };
+  struct BlockRef {
+    G4int file;
+    G4long index;
+    G4int nParticles;
+  };
+
+  void CloseFiles();
+  void BuildBlockOrder();
+  void RequestNextBlock();
+  void WaitNextBlock();
+  void DecodeBlock(const BlockRef & block, G4int first,
+                   std::vector<GatePhaseSpaceBinaryRecord> & records) const;
+  void RunPrefetch();
+
+  std::vector<MappedFile> mFiles;
+  std::vector<BlockRef> mBlocks;
+  std::vector<size_t> mOrder;
+  size_t mNextOrderIndex;
+  G4long mNumberOfParticles;
+  float mRmax;
+  bool mShuffleBlocks;
+
+  std::vector<GatePhaseSpaceBinaryRecord> mCurrent;
+  std::vector<GatePhaseSpaceBinaryRecord> mNext;
+  size_t mCursor;
+
+  // Prefetch thread: decodes mRequestedBlock into mNext
+  std::thread mThread;
+  std::mutex mMutex;
+  std::condition_variable mCondition;
+  const BlockRef * mRequestedBlock;
+  bool mIsPending;
+  bool mIsStopped;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEPHASESPACEBINARYFILE_HH */
@@ -0,0 +1,121 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class  GateProfiler
+  \brief  Counts the calls and the CPU cycles spent in the instrumented
+  \brief  parts of the event loop (actor callbacks, pulse processors,
+  \brief  output modules, source).
+
+  Profiling is off by default (it is switched on by the ProfilerActor):
+  the instrumented code then only tests a section id. A section is
+  registered once with GetSection and timed with a GateProfilerScope:
+
+    GateProfilerScope scope(section); // no-op when section < 0
+
+  The time is read from the cycle counter (rdtsc on x86, steady clock
+  elsewhere) and converted to seconds at the end. With GATE_USE_MT each
+  thread has its own counters; they are summed by GetEntries, which must
+  be called when the worker threads do not run events.
+  The time of a section includes the time of the sections called
+  inside it (e.g. an output module called by an actor).
+*/
+
+#ifndef GATEPROFILER_HH
+#define GATEPROFILER_HH
+
+#include "globals.hh"
+#include "GateConfiguration.h"
+
+#include <vector>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+class GateProfiler
+{
+public:
+  typedef unsigned long long Ticks;
+
+  struct Entry {
+    G4String category;
+    G4String name;
+    unsigned long long calls;
+    double seconds;
+  };
+
+  /// Switches profiling on, the sections registered from now are timed
+  static void Enable();
+  static bool IsEnabled() { return mIsEnabled; }
+
+  /// Id of the section 'name' of a category (created if needed), or -1
+  /// when profiling is disabled
+  static int GetSection(const G4String & category, const G4String & name);
+
+  static inline Ticks GetTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>
+      (std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  static inline void Add(int section, Ticks ticks) {
+    Counter & c = GetThreadCounters()[section];
+    c.calls++;
+    c.ticks += ticks;
+  }
+
+  /// Sums of the counters of all the threads, one entry per section
+  static std::vector<Entry> GetEntries();
+  /// Sets all the counters to zero
+  static void Reset();
+
+  static const int kMaxNumberOfSections = 1024;
+
+private:
+  struct Counter {
+    unsigned long long calls;
+    Ticks ticks;
+  };
+
+  static inline Counter * GetThreadCounters() {
+    if (!mThreadCounters) mThreadCounters = CreateThreadCounters();
+    return mThreadCounters;
+  }
+  static Counter * CreateThreadCounters();
+  static double GetSecondsPerTick();
+
+  static bool mIsEnabled;
+  static G4ThreadLocal Counter * mThreadCounters;
+};
+
+
+//-----------------------------------------------------------------------------
+/// Times its scope in a section of the GateProfiler (nothing when the
+/// section is negative)
+class GateProfilerScope
+{
+public:
+  explicit GateProfilerScope(int section) : mSection(section), mStart(0) {
+    if (mSection >= 0) mStart = GateProfiler::GetTicks();
+  }
+  ~GateProfilerScope() {
+    if (mSection >= 0) GateProfiler::Add(mSection, GateProfiler::GetTicks() - mStart);
+  }
+
+private:
+  int mSection;
+  GateProfiler::Ticks mStart;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEPROFILER_HH */
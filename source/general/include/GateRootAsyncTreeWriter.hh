@@ -0,0 +1,138 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class GateRootAsyncTreeWriter
+  \brief Fills ROOT trees from a background thread
+
+  The trees of the output modules are filled through the addresses of
+  their branches (the variables of a buffer). With this class, Fill(tree)
+  only copies the current values of these variables into a columnar
+  batch (one column per branch). Full batches are handed to a single
+  writing thread which copies each entry into private branch buffers
+  and calls TTree::Fill, so the serialization, the compression of the
+  baskets and the disk writes are done out of the event loop.
+
+  All the trees of the writer must belong to the same file and, once
+  added, must only be filled with this writer. The trees, their file and
+  their directory must not be used by the caller before Flush (or Stop)
+  has returned. The other trees of the file (those AddTree rejects, or
+  which are not added) are filled by Fill under the file mutex; any other
+  object of the file filled by the caller (e.g. a TNtuple) must be filled
+  under GetFileMutex(), because its baskets are written to the same file
+  as those of the writing thread.
+
+  Only the branches made of simple leaves (leaf list, fixed size
+  arrays, 'C' strings up to kMaxStringLength characters) are handled:
+  AddTree returns false otherwise and the tree must be filled directly.
+*/
+
+#ifndef GATEROOTASYNCTREEWRITER_HH
+#define GATEROOTASYNCTREEWRITER_HH
+
+#include "GateConfiguration.h"
+
+#ifdef G4ANALYSIS_USE_ROOT
+
+#include "globals.hh"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//-----------------------------------------------------------------------------
+class GateRootAsyncTreeWriter
+{
+public:
+  GateRootAsyncTreeWriter();
+  ~GateRootAsyncTreeWriter();
+
+  /// False when the ROOT version cannot fill the trees from another
+  /// thread (ROOT 5): AddTree always fails
+  static bool IsAvailable();
+
+  /// Number of entries of a batch (per tree), before AddTree
+  void SetBatchSize(int n) { mBatchSize = n; }
+
+  /// Redirects the branches of the tree to private buffers. Returns
+  /// false if a branch cannot be handled (the tree is unchanged).
+  bool AddTree(TTree * tree);
+  bool HasTree(TTree * tree) const { return FindTree(tree) >= 0; }
+
+  /// Adds an entry with the current values of the branch variables
+  /// (same as tree->Fill() for the caller)
+  void Fill(TTree * tree);
+
+  /// Serializes the writes to the file of the trees
+  std::mutex & GetFileMutex() { return mFileMutex; }
+
+  /// Waits until all the entries are filled in the trees
+  void Flush();
+
+  /// Flushes, stops the writing thread and gives the branches their
+  /// initial addresses back
+  void Stop();
+
+  static const size_t kMaxStringLength = 63;
+
+protected:
+  static const size_t kMaxPendingBatches = 8;
+
+  struct Column {
+    TBranch * branch;
+    char * source;      // variable of the caller
+    size_t size;        // bytes per entry
+    bool isString;
+    size_t offset;      // offset of the column in a batch (size*batchSize units)
+    size_t bufferOffset; // offset of the private branch buffer
+  };
+
+  struct Batch {
+    int tree;
+    long nbEntries;
+    std::vector<char> data;
+  };
+
+  struct TreeInfo {
+    TTree * tree;
+    std::vector<Column> columns;
+    size_t entrySize;
+    std::vector<char> buffer; // private branch buffers, used by the writing thread
+    Batch current;
+  };
+
+  int FindTree(TTree * tree) const;
+  void SubmitBatch(TreeInfo & info);
+  void WriteBatch(Batch & batch);
+  void Run();
+
+  long mBatchSize;
+  std::vector<TreeInfo*> mTrees;
+  mutable int mLastTree;
+
+  // Shared with the writing thread
+  std::mutex mFileMutex;
+  std::thread mThread;
+  bool mIsRunning;
+  std::mutex mMutex;
+  std::condition_variable mBatchReady;
+  std::condition_variable mBatchWritten;
+  std::deque<Batch> mPendingBatches;
+  std::vector<std::vector<char> > mFreeData;
+  bool mIsWriting;
+  bool mStop;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* G4ANALYSIS_USE_ROOT */
+#endif /* end #define GATEROOTASYNCTREEWRITER_HH */
@@ -19,6 +19,9 @@
   GATE geometry
   - RunInitialisation(): overload of G4RunManager()::RunInitialisation() that resets the geometry
   navigator.
+  - When GATE is compiled with GATE_USE_MT, the GateRunManager derives from G4MTRunManager: the
+  master thread builds the geometry, physics and actors, the events are tracked by worker threads
+  (see GateActionInitialization).
 
   \sa GateSystemComponent, GateBoxCreatorComponent, GateArrayRepeater
 */
@@ -27,13 +30,21 @@
 #ifndef GateRunManager_h
 #define GateRunManager_h 1
 
-#include "G4RunManager.hh"
+#include "GateConfiguration.h"
 #include "GateHounsfieldToMaterialsBuilder.hh"
 
+#ifdef GATE_USE_MT
+#include "G4MTRunManager.hh"
+typedef G4MTRunManager GateBaseRunManager;
+#else
+#include "G4RunManager.hh"
+typedef G4RunManager GateBaseRunManager;
+#endif
+
 class GateRunManagerMessenger;
 class GateDetectorConstruction;
 
-class GateRunManager : public G4RunManager
+class GateRunManager : public GateBaseRunManager
 {
 public:
   //! Constructor
@@ -58,15 +69,30 @@ public:
   //! Overload of G4RunManager()::RunInitialisation() that resets the geometry navigator
   void RunInitialization();
 
-  //! Return the instance of the run manager
+  //! Return the instance of the run manager (the master one in multithreaded mode)
   static GateRunManager* GetRunManager()
+#ifdef GATE_USE_MT
+  {	return dynamic_cast<GateRunManager*>(G4MTRunManager::GetMasterRunManager()); }
+#else
   {	return dynamic_cast<GateRunManager*>(G4RunManager::GetRunManager()); }
+#endif
+
+  //! Number of worker threads (only meaningful with GATE_USE_MT)
+  void SetNumberOfThreads(G4int n);
+  G4int GetNumberOfThreads() const;
 
   bool GetGlobalOutputFlag() { return mGlobalOutputFlag; }
   void EnableGlobalOutput(bool b) { mGlobalOutputFlag = b; }
   void SetUserPhysicList(G4VUserPhysicsList * m) { mUserPhysicList = m; }
   void SetUserPhysicListName(G4String m) { mUserPhysicListName = m; }
 
+protected:
+#ifdef GATE_USE_MT
+  //! Only the /gate/actor/ commands are forwarded to the worker threads, the
+  //! other /gate/ commands act on master objects (geometry, sources, outputs)
+  virtual void PrepareCommandsStack();
+#endif
+
 private :
 
   GateDetectorConstruction* detConstruction;
@@ -13,6 +13,7 @@ See LICENSE.md for further details
 class GateRunManager;
 class G4UIcmdWithoutParameter;
 class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
 
 //-----------------------------------------------------------------------------
 class GateRunManagerMessenger : public G4UImessenger
@@ -28,6 +29,7 @@ class GateRunManagerMessenger : public G4UImessenger
     G4UIcmdWithoutParameter* pRunInitCmd;
     G4UIcmdWithoutParameter* pRunGeomUpdateCmd;
     G4UIcmdWithABool* pRunEnableGlobalOutputCmd;  
+    G4UIcmdWithAnInteger* pRunNumberOfThreadsCmd;
 };
 //-----------------------------------------------------------------------------
 
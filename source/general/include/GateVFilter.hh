@@ -19,10 +19,12 @@ See LICENSE.md for further details
 #define GATEVFILTER_HH
 
 #include "GateNamedObject.hh"
+#include "GateConfiguration.h"
 
 #include "globals.hh"
 #include "G4String.hh"
 #include <vector>
+#include <atomic>
 
 #include "G4Step.hh"
 #include "G4Track.hh"
@@ -37,13 +39,31 @@ public:
   virtual G4bool Accept(const G4Step*);
   virtual G4bool Accept(const G4Track*);
 
- 
+  // True when the result only depends on the track (particle, parents,
+  // creator process, IDs) and not on the current step. The filter manager
+  // then evaluates the filter once per track.
+  virtual G4bool IsTrackInvariant() const { return false; }
+
+  // Resolves the names given by the commands (particles, materials,
+  // volumes). Called by the filter manager when the actor is constructed,
+  // before the workers run events.
+  void Initialize();
+
   virtual void show();
 
- 
+protected:
+  virtual void InitializeFilter() {}
+  // Fallback for the filters used before Initialize (or after a name has
+  // been added): thread safe, Accept is called by all the workers of a
+  // shared actor
+  inline void CheckInitialization() {
+    if (!mIsInitialized.load(std::memory_order_acquire)) InitializeIfNeeded();
+  }
+  void ResetInitialization() { mIsInitialized.store(false); }
 
 private:
-
+  void InitializeIfNeeded();
+  std::atomic<bool> mIsInitialized;
 };
 
 
@@ -41,15 +41,19 @@ public:
 
   virtual void show();
 
-  void Initialize();
+protected:
+  virtual void InitializeFilter();
 
 private:
 
   std::vector<G4String> theTempoListOfVolumeName;
   std::vector<GateVVolume *> theListOfVolume;
   std::vector<G4LogicalVolume*> theListOfLogicalVolume;
-
-  bool IsInitialized;
+  std::vector<bool> mIsLogicalVolumeAccepted;
+  G4bool IsAccepted(const G4LogicalVolume * lv) const {
+    const size_t id = lv->GetInstanceID();
+    return id < mIsLogicalVolumeAccepted.size() && mIsLogicalVolumeAccepted[id];
+  }
 
   GateVolumeFilterMessenger * pVolumeFilterMessenger;
 };
@@ -0,0 +1,68 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateAliasTable.hh"
+
+//-----------------------------------------------------------------------------
+GateAliasTable::GateAliasTable()
+{
+  mSize = 0;
+  mTotalWeight = 0.;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateAliasTable::Clear()
+{
+  mSize = 0;
+  mTotalWeight = 0.;
+  mProbability.clear();
+  mAlias.clear();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateAliasTable::Build(const std::vector<G4double> & weights)
+{
+  mSize = weights.size();
+  mTotalWeight = 0.;
+  for (G4int i=0; i<mSize; i++) mTotalWeight += weights[i];
+  mProbability.resize(mSize);
+  mAlias.resize(mSize);
+  if (mSize == 0 || mTotalWeight <= 0.) { mSize = 0; return; }
+
+  // Scaled probabilities: the mean is 1
+  mSmall.clear();
+  mLarge.clear();
+  G4double scale = mSize / mTotalWeight;
+  for (G4int i=0; i<mSize; i++) {
+    mProbability[i] = weights[i] * scale;
+    mAlias[i] = i;
+    if (mProbability[i] < 1.) mSmall.push_back(i);
+    else mLarge.push_back(i);
+  }
+
+  // Each small column is filled up with a part of a large one
+  while (!mSmall.empty() && !mLarge.empty()) {
+    G4int s = mSmall.back(); mSmall.pop_back();
+    G4int l = mLarge.back();
+    mAlias[s] = l;
+    mProbability[l] -= (1. - mProbability[s]);
+    if (mProbability[l] < 1.) {
+      mLarge.pop_back();
+      mSmall.push_back(l);
+    }
+  }
+
+  // Remaining columns are full (up to rounding errors)
+  for (size_t i=0; i<mLarge.size(); i++) mProbability[mLarge[i]] = 1.;
+  for (size_t i=0; i<mSmall.size(); i++) mProbability[mSmall[i]] = 1.;
+}
+//-----------------------------------------------------------------------------
@@ -9,6 +9,20 @@ See LICENSE.md for further details
 
 #include "GateFilterManager.hh"
 #include "GateMessageManager.hh"
+#include "GateUserActions.hh"
+
+#include <atomic>
+
+namespace {
+  // Last track seen by each filter manager, per thread
+  struct TrackCacheEntry {
+    long int eventNumber;
+    G4int trackID;
+    G4bool accepted;
+  };
+  std::atomic<G4int> gNumberOfFilterManagers(0);
+  G4ThreadLocal std::vector<TrackCacheEntry> * threadTrackCache = 0;
+}
 
 
 //---------------------------------------------------------------------------
@@ -17,6 +31,7 @@ GateFilterManager::GateFilterManager(G4String name)
 {
   theFilters.clear();
   mFilterName = name;
+  mCacheIndex = gNumberOfFilterManagers++;
 }
 //---------------------------------------------------------------------------
 
@@ -40,14 +55,29 @@ GateFilterManager::~GateFilterManager()
 
 
 //---------------------------------------------------------------------------
-G4bool GateFilterManager::Accept(const G4Step* aStep) const
+void GateFilterManager::AddFilter(GateVFilter* filter)
 {
-//  std::vector<GateVFilter*>::iterator sit;
- // for(sit= theFilters.begin(); sit!=theFilters.end(); ++sit)
-      //if(!(*sit)->Accept(aStep)) return false;
+  theFilters.push_back(filter);
+  if (filter->IsTrackInvariant()) mTrackInvariantFilters.push_back(filter);
+  else mStepFilters.push_back(filter);
+}
+//---------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------
+void GateFilterManager::Initialize()
+{
   for(unsigned int i = 0;i<theFilters.size();i++)
-     if(!theFilters[i]->Accept(aStep)) return false;
+    theFilters[i]->Initialize();
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4bool GateFilterManager::Accept(const G4Step* aStep) const
+{
+  if (!AcceptTrackInvariant(aStep->GetTrack())) return false;
+
+  for(unsigned int i = 0;i<mStepFilters.size();i++)
+     if(!mStepFilters[i]->Accept(aStep)) return false;
 
   return true;
 }
@@ -56,17 +86,49 @@ G4bool GateFilterManager::Accept(const G4Step* aStep) const
 //---------------------------------------------------------------------------
 G4bool GateFilterManager::Accept(const G4Track* aTrack) const
 {
-//  std::vector<GateVFilter*>::iterator sit;
- // for(sit= theFilters.begin(); sit!=theFilters.end(); ++sit)
-      //if(!(*sit)->Accept(aStep)) return false;
+  if (!AcceptTrackInvariant(aTrack)) return false;
 
-    for(unsigned int i = 0;i<theFilters.size();i++)
-      if(!theFilters[i]->Accept(aTrack)) return false;
+  for(unsigned int i = 0;i<mStepFilters.size();i++)
+    if(!mStepFilters[i]->Accept(aTrack)) return false;
 
   return true;
 }
 //---------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------
+G4bool GateFilterManager::AcceptTrackInvariant(const G4Track* aTrack) const
+{
+  if (mTrackInvariantFilters.empty()) return true;
+
+  // Track IDs are unique in an event. Secondaries not yet tracked have no
+  // ID (0) and are not cached.
+  GateUserActions * actions = GateUserActions::GetUserActions();
+  const G4int trackID = aTrack->GetTrackID();
+  TrackCacheEntry * entry = 0;
+  if (actions && trackID > 0) {
+    if (!threadTrackCache) threadTrackCache = new std::vector<TrackCacheEntry>;
+    if ((G4int)threadTrackCache->size() <= mCacheIndex) {
+      TrackCacheEntry empty = { -1, 0, false };
+      threadTrackCache->resize(mCacheIndex+1, empty);
+    }
+    entry = &(*threadTrackCache)[mCacheIndex];
+    if (entry->trackID == trackID && entry->eventNumber == actions->GetCurrentEventNumber())
+      return entry->accepted;
+  }
+
+  G4bool accepted = true;
+  for(unsigned int i = 0;i<mTrackInvariantFilters.size() && accepted;i++)
+    accepted = mTrackInvariantFilters[i]->Accept(aTrack);
+
+  if (entry) {
+    entry->eventNumber = actions->GetCurrentEventNumber();
+    entry->trackID = trackID;
+    entry->accepted = accepted;
+  }
+  return accepted;
+}
+//---------------------------------------------------------------------------
+
 
 
 //---------------------------------------------------------------------------
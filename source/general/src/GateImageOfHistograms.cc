@@ -24,6 +24,8 @@ GateImageOfHistograms::GateImageOfHistograms(std::string dataTypeName):GateImage
 {
   SetHistoInfo(0,0,0);
   mDataTypeName = dataTypeName;
+  mSparseStorageFlag = false;
+  mNbOfSparseHistograms = 0;
 }
 //-----------------------------------------------------------------------------
 
@@ -52,6 +54,15 @@ void GateImageOfHistograms::Allocate()
   sizeY = resolution.y();
   sizeZ = resolution.z();
 
+  // Sparse: only the pixel -> histogram table is allocated here
+  if (mSparseStorageFlag) {
+    if (mDataTypeName == "int") {
+      GateError("Sparse storage of ImageOfHistogram is only available for 'double' or 'float' data.");
+    }
+    Reset();
+    return;
+  }
+
   // Allocate full vector
   try {
     if (mDataTypeName == "double")
@@ -71,17 +82,6 @@ void GateImageOfHistograms::Allocate()
               << " and nbOfBins is " << nbOfBins);
   }
 
-  // FIXME : Sparse
-  /*
-    mHistoData.resize(nbOfValues);
-    // Could not allocate this way for 3D image -> too long !!
-    for(int i=0; i<nbOfValues; i++) {
-    // Create TH1D with no names (to save memory)
-    //DD(i);
-    mHistoData[i] = new TH1D("","", nbOfBins, minValue, maxValue);
-    }
-  */
-
   // Set to zero
   Reset();
 }
@@ -115,6 +115,11 @@ void GateImageOfHistograms::UpdateSizesFromResolutionAndHalfSize() {
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::Reset()
 {
+  if (mSparseStorageFlag) {
+    ClearSparseStorage();
+    mHistogramIndex.assign(nbOfValues, -1);
+    return;
+  }
   if (mDataTypeName == "double")
     fill(dataDouble.begin(), dataDouble.end(), 0.0);
   else if (mDataTypeName == "float")
@@ -129,6 +134,8 @@ void GateImageOfHistograms::Reset()
 void GateImageOfHistograms::Deallocate()
 {
   // this thing frees the data memory, while keeping the rest intact. USE WITH CAUTION!
+  ClearSparseStorage();
+  std::vector<int>().swap(mHistogramIndex);
   if (mDataTypeName == "double")
     std::vector<double>().swap(dataDouble);
   else if (mDataTypeName == "float")
@@ -139,6 +146,16 @@ void GateImageOfHistograms::Deallocate()
 //-----------------------------------------------------------------------------
 
 
+//-----------------------------------------------------------------------------
+void GateImageOfHistograms::ClearSparseStorage()
+{
+  std::vector<std::vector<double> >().swap(mSparseDouble);
+  std::vector<std::vector<float> >().swap(mSparseFloat);
+  mNbOfSparseHistograms = 0;
+}
+//-----------------------------------------------------------------------------
+
+
 //-----------------------------------------------------------------------------
 long GateImageOfHistograms::GetIndexFromPixelIndex(int i, int j, int k)
 {
@@ -150,6 +167,10 @@ long GateImageOfHistograms::GetIndexFromPixelIndex(int i, int j, int k)
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::ComputeTotalOfCountsImageDataFloat(std::vector<float> & output)
 {
+  if (mSparseStorageFlag) {
+    ComputeSparseTotalOfCounts(mSparseFloat, output);
+    return;
+  }
   output.resize(nbOfValues);
   std::fill(output.begin(), output.end(), 0.0);
   unsigned long index_image = 0;
@@ -172,6 +193,10 @@ void GateImageOfHistograms::ComputeTotalOfCountsImageDataFloat(std::vector<float
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::ComputeTotalOfCountsImageDataDouble(std::vector<double> & output)
 {
+  if (mSparseStorageFlag) {
+    ComputeSparseTotalOfCounts(mSparseDouble, output);
+    return;
+  }
   output.resize(nbOfValues);
   std::fill(output.begin(), output.end(), 0.0);
   unsigned long index_image = 0;
@@ -194,12 +219,10 @@ void GateImageOfHistograms::ComputeTotalOfCountsImageDataDouble(std::vector<doub
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::AddValueFloat(const int & index, TH1D * h, const double scale=1.0)
 {
-  int index_data = index*nbOfBins;
-  for(unsigned int i=1; i<=nbOfBins; i++) {
-    // +1 because TH1D start at 1, and end at index=size
-    dataFloat[index_data] += h->GetBinContent(i)*scale;
-    index_data++;
-  }
+  if (mSparseStorageFlag)
+    AccumulateHistogram(GetSparseHistogram(index, mSparseFloat), h, scale);
+  else
+    AccumulateHistogram(&dataFloat[(long)index*nbOfBins], h, scale);
 }
 //-----------------------------------------------------------------------------
 
@@ -207,12 +230,10 @@ void GateImageOfHistograms::AddValueFloat(const int & index, TH1D * h, const dou
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::AddValueDouble(const int & index, TH1D * h, const double scale=1.0)
 {
-  int index_data = index*nbOfBins;
-  for(unsigned int i=1; i<=nbOfBins; i++) {
-    // +1 because TH1D start at 1, and end at index=size
-    dataDouble[index_data] += h->GetBinContent(i)*scale;
-    index_data++;
-  }
+  if (mSparseStorageFlag)
+    AccumulateHistogram(GetSparseHistogram(index, mSparseDouble), h, scale);
+  else
+    AccumulateHistogram(&dataDouble[(long)index*nbOfBins], h, scale);
 }
 //-----------------------------------------------------------------------------
 
@@ -220,6 +241,10 @@ void GateImageOfHistograms::AddValueDouble(const int & index, TH1D * h, const do
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::AddValueDouble(const int & index, const int &bin, const double value=1.0)
 {
+  if (mSparseStorageFlag) {
+    GetSparseHistogram(index, mSparseDouble)[bin] += value;
+    return;
+  }
   long index_data = index*nbOfBins+bin;
   dataDouble[index_data] += value;
 }
@@ -228,6 +253,11 @@ void GateImageOfHistograms::AddValueDouble(const int & index, const int &bin, co
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::SetValueDouble(const int & index, const int &bin, const double value=1.0)
 {
+  if (mSparseStorageFlag) {
+    if (value == 0.0 && mHistogramIndex[index] < 0) return;
+    GetSparseHistogram(index, mSparseDouble)[bin] = value;
+    return;
+  }
   long index_data = index*nbOfBins+bin;
   dataDouble[index_data] = value;
 }
@@ -236,6 +266,10 @@ void GateImageOfHistograms::SetValueDouble(const int & index, const int &bin, co
 //-----------------------------------------------------------------------------
 double GateImageOfHistograms::GetValueDouble(const int & index, const int &bin)
 {
+  if (mSparseStorageFlag) {
+    const double * h = FindSparseHistogram(index, mSparseDouble);
+    return (h ? h[bin] : 0.0);
+  }
   long index_data = index*nbOfBins+bin;
   return dataDouble[index_data];
 }
@@ -325,6 +359,11 @@ void GateImageOfHistograms::Read(G4String filename)
 
   }//end metaImage scope. it does not exist anymore.
 
+  // Data read from disk are always dense
+  mSparseStorageFlag = false;
+  ClearSparseStorage();
+  std::vector<int>().swap(mHistogramIndex);
+
   //Set to correct order. This allocates dataFloat.
   ConvertPixelOrderToHXYZ(input, dataFloat);
 
@@ -374,7 +413,10 @@ void GateImageOfHistograms::Write(G4String filename, const G4String & )
   // Always write in float rather than double to preserve memory, but
   // computation could be performed in double to prevent potential
   // rounding error.
-  MetaImage m_MetaImage(4, dimSize, spacing, MET_FLOAT);
+  // In sparse mode, a placeholder prevents MetaImage from allocating
+  // the dense element buffer: only the header is written by it.
+  float noData = 0.0;
+  MetaImage m_MetaImage(4, dimSize, spacing, MET_FLOAT, 1, (mSparseStorageFlag ? &noData : NULL));
   m_MetaImage.AddUserField("HistoMinInMeV", MET_FLOAT_ARRAY, 1, &minValue);
   m_MetaImage.AddUserField("HistoMaxInMeV", MET_FLOAT_ARRAY, 1, &maxValue);
 
@@ -399,6 +441,22 @@ void GateImageOfHistograms::Write(G4String filename, const G4String & )
   matrix[15] = 1.0;
   m_MetaImage.TransformMatrix(matrix);
 
+  // Sparse: only the header is written by MetaImage, the bin planes
+  // are streamed from the stored histograms to the raw file (XYZH
+  // order, the stored data are kept)
+  if (mSparseStorageFlag) {
+    double total = ComputeSum();
+    m_MetaImage.AddUserField("TotalSum", MET_FLOAT_ARRAY, 1, &total);
+    m_MetaImage.Write(headerName.c_str(), rawName.c_str(), false);
+    std::ofstream os(rawName.c_str(), std::ios::out | std::ios::binary);
+    bool ok = os.is_open();
+    if (ok && mDataTypeName == "double") ok = WriteSparseToXYZH(mSparseDouble, os);
+    else if (ok) ok = WriteSparseToXYZH(mSparseFloat, os);
+    os.close();
+    if (!ok || os.fail()) GateError("Cannot write the histograms in " << rawName);
+    return;
+  }
+
   // Before writing convert from double to float
   double total = 0.0;
   if (mDataTypeName == "double") {
@@ -438,6 +496,14 @@ void GateImageOfHistograms::Write(G4String filename, const G4String & )
 //-----------------------------------------------------------------------------
 void GateImageOfHistograms::Scale(double f)
 {
+  if (mSparseStorageFlag) {
+    // Unused histograms at the end of the last block are zero
+    for(unsigned int b=0; b<mSparseDouble.size(); b++)
+      for(unsigned int i=0; i<mSparseDouble[b].size(); i++) mSparseDouble[b][i] *= f;
+    for(unsigned int b=0; b<mSparseFloat.size(); b++)
+      for(unsigned int i=0; i<mSparseFloat[b].size(); i++) mSparseFloat[b][i] *= f;
+    return;
+  }
   if (mDataTypeName == "double") {
     for(unsigned int i=0; i<dataDouble.size(); i++)
       dataDouble[i] = f * dataDouble[i];
@@ -462,7 +528,13 @@ void GateImageOfHistograms::Scale(double f)
 double GateImageOfHistograms::ComputeSum()
 {
   double sum = 0.0;
-  if (mDataTypeName == "double") {
+  if (mSparseStorageFlag) {
+    for(unsigned int b=0; b<mSparseDouble.size(); b++)
+      for(unsigned int i=0; i<mSparseDouble[b].size(); i++) sum += mSparseDouble[b][i];
+    for(unsigned int b=0; b<mSparseFloat.size(); b++)
+      for(unsigned int i=0; i<mSparseFloat[b].size(); i++) sum += mSparseFloat[b][i];
+  }
+  else if (mDataTypeName == "double") {
     for(unsigned int i=0; i<dataDouble.size(); i++)
       sum += dataDouble[i];
   }
@@ -17,6 +17,14 @@
 #include <iomanip>
 #include <sstream>
 #include <iostream>
+#include <cstring>
+#include <algorithm>
+
+// system
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // gate
 #include "GateMHDImage.hh"
@@ -75,6 +83,87 @@ void GateMHDImage::ReadHeader(std::string & filename)
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+bool GateMHDImage::GetRawDataLocation(const std::string & headerName, const MetaImage & m,
+                                      std::string & rawName, long & offset)
+{
+  std::string name = m.ElementDataFileName();
+  // Slices stored in several files are left to MetaIO
+  if (name.compare(0, 4, "LIST") == 0 || name.find('%') != std::string::npos) return false;
+
+  int elementSize;
+  MET_SizeOfType(m.ElementType(), &elementSize);
+  long dataSize = (long)elementSize * (long)size[0] * (long)size[1] * (long)size[2];
+
+  bool isLocal = (name == "LOCAL" || name == "Local" || name == "local");
+  if (isLocal) rawName = headerName;
+  else {
+    // Relative to the header folder
+    rawName = name;
+    size_t sep = headerName.find_last_of('/');
+    if (name[0] != '/' && sep != std::string::npos) rawName = headerName.substr(0, sep+1) + name;
+  }
+
+  struct stat st;
+  if (stat(rawName.c_str(), &st) != 0) {
+    GateError("MHD raw file <" << rawName << "> cannot be read.");
+  }
+
+  // Same rules as MetaIO: explicit header size, or data at the end of
+  // the file (HeaderSize = -1 or data in the header file)
+  if (m.HeaderSize() > 0) offset = m.HeaderSize();
+  else if (m.HeaderSize() == -1 || isLocal) offset = (long)st.st_size - dataSize;
+  else offset = 0;
+
+  if (offset < 0 || offset + dataSize > (long)st.st_size) {
+    GateError("MHD raw file <" << rawName << "> is too short: " << st.st_size
+              << " bytes while " << dataSize << " bytes of data are expected.");
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateMHDImage::ReadRawBytes(const std::string & rawName, long offset, char * dest, size_t length)
+{
+  if (length == 0) return;
+  int fd = open(rawName.c_str(), O_RDONLY);
+  if (fd < 0) {
+    GateError("Error while opening " << rawName << " for reading.");
+  }
+
+  // The mapping must start on a page boundary
+  const long page = sysconf(_SC_PAGESIZE);
+  const long start = (offset/page)*page;
+  const size_t mappedLength = length + (offset-start);
+  void * p = mmap(0, mappedLength, PROT_READ, MAP_PRIVATE, fd, start);
+  close(fd);
+  if (p == MAP_FAILED) {
+    // Some file systems cannot be mapped, read the file instead
+    std::ifstream is(rawName.c_str(), std::ios::in | std::ios::binary);
+    is.seekg(offset, std::ios::beg);
+    is.read(dest, length);
+    if (!is) GateError("Error while reading " << rawName);
+    return;
+  }
+  madvise(p, mappedLength, MADV_SEQUENTIAL);
+
+  // Copy by chunks and release the pages already copied, so that the
+  // file is never entirely resident in addition to the image
+  const size_t chunk = 1024*page;
+  const char * src = (const char*)p + (offset-start);
+  size_t done = 0;
+  while (done < length) {
+    size_t n = std::min(chunk, length-done);
+    memcpy(dest+done, src+done, n);
+    done += n;
+    madvise(p, ((offset-start+done)/page)*page, MADV_DONTNEED);
+  }
+  munmap(p, mappedLength);
+}
+//-----------------------------------------------------------------------------
+
 //-----------------------------------------------------------------------------
 void GateMHDImage::Print()
 {
@@ -22,14 +22,14 @@ GateMaterialFilter::GateMaterialFilter(G4String name)
 {
   theMdef.clear();
   pMatMessenger = new GateMaterialFilterMessenger(this);
-  nFilteredParticles = 0;
+  mHasSelectedParticles = false;
 }
 //---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 GateMaterialFilter::~GateMaterialFilter()
 {
-  if(nFilteredParticles==0) GateWarning("No particle has been selected by filter: " << GetObjectName()); 
+  if(!mHasSelectedParticles) GateWarning("No particle has been selected by filter: " << GetObjectName()); 
   delete pMatMessenger ;
 }
 //---------------------------------------------------------------------------
@@ -37,29 +37,50 @@ GateMaterialFilter::~GateMaterialFilter()
 //---------------------------------------------------------------------------
 G4bool GateMaterialFilter::Accept(const G4Step* aStep) 
 {
-    for ( size_t i = 0; i < theMdef.size(); i++){
-      if ( theMdef[i] == aStep->GetPreStepPoint()->GetMaterial()->GetName() ) {
-        nFilteredParticles++;
-        return true;
-      } 
-    }
-  return false;
+  if (!IsAccepted(aStep->GetPreStepPoint()->GetMaterial())) return false;
+  SetSelectedParticles();
+  return true;
 }
 //---------------------------------------------------------------------------
 
 //---------------------------------------------------------------------------
 G4bool GateMaterialFilter::Accept(const G4Track* aTrack) 
 {
-    for ( size_t i = 0; i < theMdef.size(); i++){ 	
-      if ( theMdef[i] == aTrack->GetMaterial()->GetName() ) {
-        nFilteredParticles++;
-        return true;
-      } 
-    }
+  if (!IsAccepted(aTrack->GetMaterial())) return false;
+  SetSelectedParticles();
+  return true;
+}
+//---------------------------------------------------------------------------
+
+//---------------------------------------------------------------------------
+G4bool GateMaterialFilter::IsAccepted(const G4Material * material)
+{
+  CheckInitialization();
+  const size_t index = material->GetIndex();
+  if (index < mIsMaterialAccepted.size()) return mIsMaterialAccepted[index];
+
+  // material created after the initialization
+  for ( size_t i = 0; i < theMdef.size(); i++){
+    if ( theMdef[i] == material->GetName() ) return true;
+  }
   return false;
 }
 //---------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------
+void GateMaterialFilter::InitializeFilter()
+{
+  // Names are resolved once into a table indexed by the material index
+  const G4MaterialTable * table = G4Material::GetMaterialTable();
+  mIsMaterialAccepted.assign(table->size(), false);
+  for ( size_t k = 0; k < table->size(); k++){
+    for ( size_t i = 0; i < theMdef.size(); i++){
+      if ( theMdef[i] == (*table)[k]->GetName() ) mIsMaterialAccepted[k] = true;
+    }
+  }
+}
+//---------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------
 void GateMaterialFilter::Add(const G4String& materialName)
 {
@@ -67,6 +88,7 @@ void GateMaterialFilter::Add(const G4String& materialName)
     if ( theMdef[i] == materialName ) return;
   }
   theMdef.push_back(materialName);
+  ResetInitialization();
 }
 //---------------------------------------------------------------------------
 
@@ -0,0 +1,77 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateNameTable.hh"
+#include "GateConfiguration.h"
+#include "GateMessageManager.hh"
+
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+namespace { G4Mutex nameTableMutex = G4MUTEX_INITIALIZER; }
+#endif
+
+//-----------------------------------------------------------------------------
+GateNameTable::GateNameTable()
+{
+  for (int i=0; i<kMaxNbOfChunks; i++) mChunks[i].store(0, std::memory_order_relaxed);
+  mNbOfNames = 0;
+  Add("");
+  Add("Transportation");
+  Add("NULL");
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateNameTable & GateNameTable::GetInstance()
+{
+  static GateNameTable table;
+  return table;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4int GateNameTable::Add(const G4String & name)
+{
+  G4int id = mNbOfNames;
+  if (id >= kMaxNbOfChunks*kChunkSize)
+    GateError("GateNameTable: too many different names (" << id << ")");
+  Chunk * chunk = mChunks[id >> kChunkBits].load(std::memory_order_relaxed);
+  if (!chunk) chunk = new Chunk;
+  chunk->names[id & (kChunkSize-1)] = name;
+  mChunks[id >> kChunkBits].store(chunk, std::memory_order_release);
+  mIDs[name] = id;
+  mNbOfNames++;
+  return id;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4int GateNameTable::GetID(const G4String & name)
+{
+  if (name.empty()) return kEmptyID;
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&nameTableMutex);
+#endif
+  GateNameTable & table = GetInstance();
+  std::map<G4String, G4int>::const_iterator it = table.mIDs.find(name);
+  if (it != table.mIDs.end()) return it->second;
+  return table.Add(name);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+const G4String & GateNameTable::GetName(G4int id)
+{
+  const Chunk * chunk = GetInstance().mChunks[id >> kChunkBits].load(std::memory_order_acquire);
+  return chunk->names[id & (kChunkSize-1)];
+}
+//-----------------------------------------------------------------------------
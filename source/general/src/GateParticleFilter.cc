@@ -9,13 +9,16 @@
 #include "GateUserActions.hh"
 #include "GateTrajectory.hh"
 
+#include <algorithm>
+
 //---------------------------------------------------------------------------
 GateParticleFilter::GateParticleFilter(G4String name)
   : GateVFilter(name)
 {
   thePdef.clear();
+  mAcceptGenericIons = false;
   pPartMessenger = new GateParticleFilterMessenger(this);
-  nFilteredParticles = 0;
+  mHasSelectedParticles = false;
 }
 //---------------------------------------------------------------------------
 
@@ -23,7 +26,7 @@ GateParticleFilter::GateParticleFilter(G4String name)
 //---------------------------------------------------------------------------
 GateParticleFilter::~GateParticleFilter()
 {
-  if (nFilteredParticles == 0) GateWarning("No particle has been selected by filter: " << GetObjectName());
+  if (!mHasSelectedParticles) GateWarning("No particle has been selected by filter: " << GetObjectName());
   delete pPartMessenger ;
 }
 //---------------------------------------------------------------------------
@@ -32,103 +35,61 @@ GateParticleFilter::~GateParticleFilter()
 //---------------------------------------------------------------------------
 G4bool GateParticleFilter::Accept(const G4Track *aTrack)
 {
-  std::vector<bool> acceptTemp;
+  CheckInitialization();
+  const G4ParticleDefinition * pdef = aTrack->GetDefinition();
 
   // Test the particle name, keep the particle if the name is in the list
-  acceptTemp.push_back(true);
   if (!thePdef.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdef.size(); i++) {
-      if (thePdef[i] == aTrack->GetDefinition()->GetParticleName() ||
-          (aTrack->GetDefinition()->GetParticleSubType() == "generic" && thePdef[i] == "GenericIon") ) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
+    bool accepted = std::binary_search(mAcceptedDefinitions.begin(), mAcceptedDefinitions.end(), pdef);
+    if (!accepted && mAcceptGenericIons) accepted = (pdef->GetParticleSubType() == "generic");
+    // (ions created during the run are not in the table at initialization)
+    for (size_t i = 0; i < mUnresolvedNames.size() && !accepted; i++) {
+      accepted = (mUnresolvedNames[i] == pdef->GetParticleName());
     }
-  } // end thePdef !empty
-  if (!acceptTemp.back()) return false;
+    if (!accepted) return false;
+    SetSelectedParticles();
+  }
 
   // Test the particle Z, keep the particle if Z is in the list
-  acceptTemp.push_back(true);
   if (!thePdefZ.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefZ.size(); i++) {
-      if (thePdefZ[i] == aTrack->GetDefinition()->GetAtomicNumber()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefZ !empty
-  if (!acceptTemp.back()) return false;
+    if (std::find(thePdefZ.begin(), thePdefZ.end(), pdef->GetAtomicNumber()) == thePdefZ.end()) return false;
+    SetSelectedParticles();
+  }
 
   //// Test the particle A
-  acceptTemp.push_back(true);
   if (!thePdefA.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefA.size(); i++) {
-      if (thePdefA[i] == aTrack->GetDefinition()->GetAtomicMass()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefA !empty
-  if (!acceptTemp.back()) return false;
+    if (std::find(thePdefA.begin(), thePdefA.end(), pdef->GetAtomicMass()) == thePdefA.end()) return false;
+    SetSelectedParticles();
+  }
 
   // Test the particle PDG
-  acceptTemp.push_back(true);
   if (!thePdefPDG.empty()) {
-    acceptTemp.back()=false;
-    for (size_t i = 0; i < thePdefPDG.size(); i++) {
-      if (thePdefPDG[i] == aTrack->GetDefinition()->GetPDGEncoding()) {
-        nFilteredParticles++;
-        acceptTemp.back()=true;
-        break;
-      }
-    }
-  } // end thePdefPFG !empty
-  if (!acceptTemp.back()) return false;
+    if (std::find(thePdefPDG.begin(), thePdefPDG.end(), pdef->GetPDGEncoding()) == thePdefPDG.end()) return false;
+    SetSelectedParticles();
+  }
 
   // Test the parent
-  acceptTemp.push_back(true);
   if (!theParentPdef.empty()) {
-    acceptTemp.back()=false;
+    bool accepted = false;
     GateTrackIDInfo * trackInfo =
       GateUserActions::GetUserActions()->GetTrackIDInfo(aTrack->GetParentID());
-    while (trackInfo) {
-      for (size_t i = 0; i < theParentPdef.size(); i++) {
-        if (theParentPdef[i] == trackInfo->GetParticleName()) {
-          nFilteredParticles++;
-          acceptTemp.back()=true;
-          break;
-        }
-      }
-      if (acceptTemp.back() == true) break;
+    while (trackInfo && !accepted) {
+      accepted = std::find(theParentPdef.begin(), theParentPdef.end(), trackInfo->GetParticleName()) != theParentPdef.end();
       int id = trackInfo->GetParentID();
       trackInfo = GateUserActions::GetUserActions()->GetTrackIDInfo(id);
     }
-  } // end theParentPdef !empty
-  if (!acceptTemp.back()) return false;
+    if (!accepted) return false;
+    SetSelectedParticles();
+  }
 
   // Test the directParent
-  acceptTemp.push_back(true);
   if (!theDirectParentPdef.empty()) {
-    acceptTemp.back()=false;
     GateTrackIDInfo * trackInfo =
       GateUserActions::GetUserActions()->GetTrackIDInfo(aTrack->GetParentID());
-    if (trackInfo) {
-      for (size_t i = 0; i < theDirectParentPdef.size(); i++) {
-        if (theDirectParentPdef[i] == trackInfo->GetParticleName()) {
-          nFilteredParticles++;
-          acceptTemp.back()=true;
-          break;
-        }
-      }
-    }
-  } // end theDirectParentPdef !empty
-  if (!acceptTemp.back()) return false;
+    if (!trackInfo) return false;
+    if (std::find(theDirectParentPdef.begin(), theDirectParentPdef.end(), trackInfo->GetParticleName()) == theDirectParentPdef.end()) return false;
+    SetSelectedParticles();
+  }
 
   // Keep the track !
   return true;
@@ -136,6 +97,25 @@ G4bool GateParticleFilter::Accept(const G4Track *aTrack)
 //---------------------------------------------------------------------------
 
 
+//---------------------------------------------------------------------------
+void GateParticleFilter::InitializeFilter()
+{
+  // Particle names are resolved once into definitions
+  G4ParticleTable * table = G4ParticleTable::GetParticleTable();
+  mAcceptedDefinitions.clear();
+  mUnresolvedNames.clear();
+  mAcceptGenericIons = false;
+  for (size_t i = 0; i < thePdef.size(); i++) {
+    if (thePdef[i] == "GenericIon") mAcceptGenericIons = true;
+    const G4ParticleDefinition * p = table->FindParticle(thePdef[i]);
+    if (p) mAcceptedDefinitions.push_back(p);
+    else mUnresolvedNames.push_back(thePdef[i]);
+  }
+  std::sort(mAcceptedDefinitions.begin(), mAcceptedDefinitions.end());
+}
+//---------------------------------------------------------------------------
+
+
 //---------------------------------------------------------------------------
 void GateParticleFilter::Add(const G4String &particleName)
 {
@@ -143,6 +123,7 @@ void GateParticleFilter::Add(const G4String &particleName)
     if (thePdef[i] == particleName ) return;
   }
   thePdef.push_back(particleName);
+  ResetInitialization();
 }
 //---------------------------------------------------------------------------
 
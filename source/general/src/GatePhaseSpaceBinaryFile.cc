@@ -0,0 +1,382 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GatePhaseSpaceBinaryFile.hh"
+#include "GateMessageManager.hh"
+#include "Randomize.hh"
+
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+  const char kMagic[8] = {'G','A','T','E','P','H','S','P'};
+  const uint32_t kVersion = 1;
+  const G4int kNumberOfFloatColumns = 9; // energy x y z dx dy dz weight time
+
+  size_t BlockBytes(G4int blockSize)
+  {
+    return size_t(blockSize)*(sizeof(int32_t) + kNumberOfFloatColumns*sizeof(float));
+  }
+}
+
+
+//-----------------------------------------------------------------------------
+GatePhaseSpaceBinaryWriter::GatePhaseSpaceBinaryWriter(G4int blockSize)
+  : mBlockSize(blockSize), mNumberOfParticlesInBlock(0),
+    mNumberOfFullBlocks(0), mNumberOfParticles(0)
+{
+  mPDGCodes.resize(mBlockSize, 0);
+  mColumns.resize(kNumberOfFloatColumns*mBlockSize, 0.0f);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GatePhaseSpaceBinaryWriter::~GatePhaseSpaceBinaryWriter()
+{
+  Close();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryWriter::Open(const G4String & filename)
+{
+  mFilename = filename;
+  mFile.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!mFile) GateError("Cannot open the phase space file '" << filename << "' for writing.");
+  mNumberOfParticlesInBlock = 0;
+  mNumberOfFullBlocks = 0;
+  mNumberOfParticles = 0;
+  WriteHeader();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryWriter::Write(const GatePhaseSpaceBinaryRecord & r)
+{
+  const G4int i = mNumberOfParticlesInBlock;
+  float * c = &mColumns[0];
+  mPDGCodes[i] = r.pdgCode;
+  c[0*mBlockSize + i] = r.energy;
+  c[1*mBlockSize + i] = r.x;
+  c[2*mBlockSize + i] = r.y;
+  c[3*mBlockSize + i] = r.z;
+  c[4*mBlockSize + i] = r.dx;
+  c[5*mBlockSize + i] = r.dy;
+  c[6*mBlockSize + i] = r.dz;
+  c[7*mBlockSize + i] = r.weight;
+  c[8*mBlockSize + i] = r.time;
+  mNumberOfParticles++;
+
+  if (++mNumberOfParticlesInBlock == mBlockSize) {
+    WriteBlock(mNumberOfFullBlocks);
+    mNumberOfFullBlocks++;
+    mNumberOfParticlesInBlock = 0;
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryWriter::Flush()
+{
+  if (!mFile.is_open()) return;
+  // The partial block is written at its final place and will be
+  // overwritten once complete
+  if (mNumberOfParticlesInBlock > 0) WriteBlock(mNumberOfFullBlocks);
+  WriteHeader();
+  mFile.flush();
+  if (!mFile) GateError("Error while writing the phase space file '" << mFilename << "'.");
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryWriter::Close()
+{
+  if (!mFile.is_open()) return;
+  Flush();
+  mFile.close();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryWriter::WriteBlock(G4long blockIndex)
+{
+  mFile.seekp(std::streamoff(sizeof(GatePhaseSpaceBinaryHeader) + blockIndex*BlockBytes(mBlockSize)));
+  mFile.write(reinterpret_cast<const char*>(&mPDGCodes[0]), mBlockSize*sizeof(int32_t));
+  mFile.write(reinterpret_cast<const char*>(&mColumns[0]), mColumns.size()*sizeof(float));
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryWriter::WriteHeader()
+{
+  GatePhaseSpaceBinaryHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.blockSize = mBlockSize;
+  header.nParticles = mNumberOfParticles;
+  mFile.seekp(0);
+  mFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GatePhaseSpaceBinaryReader::GatePhaseSpaceBinaryReader()
+  : mNextOrderIndex(0), mNumberOfParticles(0), mRmax(0), mShuffleBlocks(false),
+    mCursor(0), mRequestedBlock(0), mIsPending(false), mIsStopped(false)
+{
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GatePhaseSpaceBinaryReader::~GatePhaseSpaceBinaryReader()
+{
+  if (mThread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mIsStopped = true;
+    }
+    mCondition.notify_all();
+    mThread.join();
+  }
+  CloseFiles();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryReader::AddFile(const G4String & filename)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) GateError("Error file not found: " << filename);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || size_t(st.st_size) < sizeof(GatePhaseSpaceBinaryHeader)) {
+    close(fd);
+    GateError("Error reading phase space file: " << filename);
+  }
+
+  MappedFile f;
+  f.name = filename;
+  f.size = st.st_size;
+  void * data = mmap(0, f.size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd); // the mapping keeps the file open
+  if (data == MAP_FAILED) GateError("Cannot map the phase space file " << filename);
+  f.data = static_cast<char*>(data);
+
+  GatePhaseSpaceBinaryHeader header;
+  memcpy(&header, f.data, sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion || header.blockSize == 0) {
+    munmap(f.data, f.size);
+    GateError("The file " << filename << " is not a GATE binary phase space (or has an unknown version).");
+  }
+  f.blockSize = header.blockSize;
+  f.nParticles = header.nParticles;
+  const G4long nBlocks = (f.nParticles + f.blockSize - 1)/f.blockSize;
+  if (f.size < sizeof(header) + nBlocks*BlockBytes(f.blockSize)) {
+    munmap(f.data, f.size);
+    GateError("The phase space file " << filename << " is truncated.");
+  }
+
+  const G4int fileIndex = mFiles.size();
+  mFiles.push_back(f);
+  for(G4long b=0; b<nBlocks; b++) {
+    BlockRef block;
+    block.file = fileIndex;
+    block.index = b;
+    block.nParticles = std::min<G4long>(f.blockSize, f.nParticles - b*f.blockSize);
+    mBlocks.push_back(block);
+  }
+  mNumberOfParticles += f.nParticles;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryReader::CloseFiles()
+{
+  for(size_t i=0; i<mFiles.size(); i++) munmap(mFiles[i].data, mFiles[i].size);
+  mFiles.clear();
+  mBlocks.clear();
+  mNumberOfParticles = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4long GatePhaseSpaceBinaryReader::SetSquareSelection(G4double rmax)
+{
+  mRmax = rmax;
+  if (mRmax <= 0) return mNumberOfParticles;
+
+  // The selection is applied when decoding, only count here (x and y columns)
+  G4long n = 0;
+  for(size_t b=0; b<mBlocks.size(); b++) {
+    const MappedFile & f = mFiles[mBlocks[b].file];
+    const char * base = f.data + sizeof(GatePhaseSpaceBinaryHeader) + mBlocks[b].index*BlockBytes(f.blockSize);
+    const float * px = reinterpret_cast<const float*>(base + f.blockSize*sizeof(int32_t)) + 1*f.blockSize;
+    const float * py = px + f.blockSize;
+    for(G4int i=0; i<mBlocks[b].nParticles; i++)
+      if (std::abs(px[i]) < mRmax && std::abs(py[i]) < mRmax) n++;
+  }
+  return n;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryReader::Start(G4long firstParticle)
+{
+  if (mNumberOfParticles == 0) GateError("No particle in the binary phase space files.");
+
+  // A block may still be decoded for the previous replay
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (mIsPending) mCondition.wait(lock);
+  }
+  if (!mThread.joinable()) mThread = std::thread(&GatePhaseSpaceBinaryReader::RunPrefetch, this);
+
+  for(size_t i=0; i<mFiles.size(); i++)
+    madvise(mFiles[i].data, mFiles[i].size, mShuffleBlocks ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+  BuildBlockOrder();
+  firstParticle = firstParticle % mNumberOfParticles;
+  size_t i = 0;
+  while (firstParticle >= mBlocks[mOrder[i]].nParticles) {
+    firstParticle -= mBlocks[mOrder[i]].nParticles;
+    i++;
+  }
+  DecodeBlock(mBlocks[mOrder[i]], firstParticle, mCurrent);
+  mCursor = 0;
+  mNextOrderIndex = i+1;
+  RequestNextBlock();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+const GatePhaseSpaceBinaryRecord & GatePhaseSpaceBinaryReader::Next()
+{
+  // (a block may be empty when a selection is used)
+  while (mCursor >= mCurrent.size()) WaitNextBlock();
+  return mCurrent[mCursor++];
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryReader::BuildBlockOrder()
+{
+  mOrder.resize(mBlocks.size());
+  for(size_t i=0; i<mOrder.size(); i++) mOrder[i] = i;
+  if (!mShuffleBlocks) return;
+  // Geant4 engine, so that the replay is reproducible with the seed
+  for(size_t i=mOrder.size()-1; i>0; i--)
+    std::swap(mOrder[i], mOrder[G4RandFlat::shootInt(G4long(i+1))]);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryReader::RequestNextBlock()
+{
+  if (mNextOrderIndex >= mOrder.size()) {
+    // End of the files: new pass (with a new order if shuffled)
+    BuildBlockOrder();
+    mNextOrderIndex = 0;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mMutex);
+    mRequestedBlock = &mBlocks[mOrder[mNextOrderIndex]];
+    mIsPending = true;
+  }
+  mNextOrderIndex++;
+  mCondition.notify_all();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryReader::WaitNextBlock()
+{
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (mIsPending) mCondition.wait(lock);
+    mCurrent.swap(mNext);
+    mCursor = 0;
+  }
+  RequestNextBlock();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryReader::DecodeBlock(const BlockRef & block, G4int first,
+                                             std::vector<GatePhaseSpaceBinaryRecord> & records) const
+{
+  const MappedFile & f = mFiles[block.file];
+  const char * base = f.data + sizeof(GatePhaseSpaceBinaryHeader) + block.index*BlockBytes(f.blockSize);
+  const int32_t * pdg = reinterpret_cast<const int32_t*>(base);
+  const float * c = reinterpret_cast<const float*>(base + f.blockSize*sizeof(int32_t));
+  const G4int n = f.blockSize;
+
+  records.clear();
+  records.reserve(n);
+  GatePhaseSpaceBinaryRecord r;
+  for(G4int i=first; i<block.nParticles; i++) {
+    r.x = c[1*n + i];
+    r.y = c[2*n + i];
+    if (mRmax > 0 && (std::abs(r.x) >= mRmax || std::abs(r.y) >= mRmax)) continue;
+    r.pdgCode = pdg[i];
+    r.energy = c[0*n + i];
+    r.z = c[3*n + i];
+    r.dx = c[4*n + i];
+    r.dy = c[5*n + i];
+    r.dz = c[6*n + i];
+    r.weight = c[7*n + i];
+    r.time = c[8*n + i];
+    records.push_back(r);
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhaseSpaceBinaryReader::RunPrefetch()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (true) {
+    while (!mRequestedBlock && !mIsStopped) mCondition.wait(lock);
+    if (mIsStopped) return;
+
+    const BlockRef * block = mRequestedBlock;
+    mRequestedBlock = 0;
+
+    // Page faults on the mapped file happen here, not in the event loop
+    lock.unlock();
+    DecodeBlock(*block, 0, mNext);
+    lock.lock();
+
+    mIsPending = false;
+    mCondition.notify_all();
+  }
+}
+//-----------------------------------------------------------------------------
@@ -23,11 +23,21 @@ See LICENSE.md for further details
 #include "GateApplicationMgr.hh"
 
 #include "GateSourceMgr.hh"
+#include "GateProfiler.hh"
 //#include "GateOutputMgr.hh"
 //#include "GateHitFileReader.hh"
 
 #include "GateConfiguration.h"
 
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+// The source manager (and the clock) are shared by the worker threads
+namespace {
+  G4Mutex sourceMgrMutex = G4MUTEX_INITIALIZER;
+  G4int lastPreparedRunID = -1;
+}
+#endif
+
 //---------------------------------------------------------------------------
 GatePrimaryGeneratorAction::GatePrimaryGeneratorAction()
 {
@@ -92,17 +102,36 @@ void GatePrimaryGeneratorAction::GenerateSimulationPrimaries(G4Event* event)
   //! compute the right number of events per slice at this time
   G4int eventID = event->GetEventID();
   GateSourceMgr* sourceMgr = GateSourceMgr::GetInstance();
+#ifdef GATE_USE_MT
+  // The events are shared between the workers: the run is prepared by the
+  // first worker which needs it
+  G4AutoLock lock(&sourceMgrMutex);
+  const G4Run* currentRun = GateRunManager::GetRunManager()->GetCurrentRun();
+  if (currentRun->GetRunID() != lastPreparedRunID) {
+    sourceMgr->PrepareNextRun( currentRun );
+    lastPreparedRunID = currentRun->GetRunID();
+  }
+  if (eventID==0) m_nEvents=0;
+#else
   if (eventID==0) {
     const G4Run* currentRun = GateRunManager::GetRunManager()->GetCurrentRun();
     //if( currentRun->GetRunID()==0) sourceMgr->Initialization();
     sourceMgr->PrepareNextRun( currentRun );
     m_nEvents=0;
   }
+#endif
 
-  G4int numVertices = sourceMgr->PrepareNextEvent(event);
+  G4int numVertices = 0;
+  {
+    // (profiling is enabled before the first event, when requested)
+    static const int profilerSection = GateProfiler::GetSection("Source", "PrepareNextEvent");
+    GateProfilerScope scope(profilerSection);
+    numVertices = sourceMgr->PrepareNextEvent(event);
+  }
   //! stop the run if no particle has been generated by the source manager
   if (numVertices == 0) {
-    GateRunManager* runManager = GateRunManager::GetRunManager();
+    // (in multithreaded mode, each worker stops its own part of the run)
+    G4RunManager* runManager = G4RunManager::GetRunManager();
 
     runManager->AbortRun(true);
     if (m_nVerboseLevel>1) G4cout << "GatePrimaryGeneratorAction::GeneratePrimaries: numVertices == 0, run aborted \n";
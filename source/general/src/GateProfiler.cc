@@ -0,0 +1,140 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateProfiler.hh"
+#include "GateMessageManager.hh"
+
+#include <map>
+
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+namespace { G4Mutex profilerMutex = G4MUTEX_INITIALIZER; }
+#endif
+
+namespace {
+  // Registered sections, and the counters of all the threads
+  std::vector<std::pair<G4String, G4String> > sections;
+  std::map<std::pair<G4String, G4String>, int> sectionIDs;
+  std::vector<void*> threadCounters;
+  // Reference times for the conversion of the ticks into seconds
+  GateProfiler::Ticks startTicks = 0;
+  std::chrono::steady_clock::time_point startTime;
+}
+
+bool GateProfiler::mIsEnabled = false;
+G4ThreadLocal GateProfiler::Counter * GateProfiler::mThreadCounters = 0;
+
+//-----------------------------------------------------------------------------
+void GateProfiler::Enable()
+{
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&profilerMutex);
+#endif
+  if (mIsEnabled) return;
+  startTicks = GetTicks();
+  startTime = std::chrono::steady_clock::now();
+  mIsEnabled = true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateProfiler::GetSection(const G4String & category, const G4String & name)
+{
+  if (!mIsEnabled) return -1;
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&profilerMutex);
+#endif
+  std::pair<G4String, G4String> key(category, name);
+  std::map<std::pair<G4String, G4String>, int>::const_iterator it = sectionIDs.find(key);
+  if (it != sectionIDs.end()) return it->second;
+  if ((int)sections.size() >= kMaxNumberOfSections) {
+    GateWarning("GateProfiler: too many sections, '" << category << " " << name << "' is not timed\n");
+    return -1;
+  }
+  int id = sections.size();
+  sections.push_back(key);
+  sectionIDs[key] = id;
+  return id;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateProfiler::Counter * GateProfiler::CreateThreadCounters()
+{
+  Counter * counters = new Counter[kMaxNumberOfSections];
+  for(int i=0; i<kMaxNumberOfSections; i++) {
+    counters[i].calls = 0;
+    counters[i].ticks = 0;
+  }
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&profilerMutex);
+#endif
+  // Kept until the end, the counters of the finished threads are reported
+  threadCounters.push_back(counters);
+  return counters;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+double GateProfiler::GetSecondsPerTick()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  Ticks ticks = GetTicks() - startTicks;
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  return (ticks > 0 ? seconds/ticks : 0.0);
+#else
+  return 1e-9;
+#endif
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+std::vector<GateProfiler::Entry> GateProfiler::GetEntries()
+{
+  const double secondsPerTick = GetSecondsPerTick();
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&profilerMutex);
+#endif
+  std::vector<Entry> entries(sections.size());
+  for(size_t i=0; i<sections.size(); i++) {
+    entries[i].category = sections[i].first;
+    entries[i].name = sections[i].second;
+    unsigned long long calls = 0;
+    Ticks ticks = 0;
+    for(size_t t=0; t<threadCounters.size(); t++) {
+      const Counter & c = static_cast<Counter*>(threadCounters[t])[i];
+      calls += c.calls;
+      ticks += c.ticks;
+    }
+    entries[i].calls = calls;
+    entries[i].seconds = ticks*secondsPerTick;
+  }
+  return entries;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateProfiler::Reset()
+{
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&profilerMutex);
+#endif
+  for(size_t t=0; t<threadCounters.size(); t++) {
+    Counter * counters = static_cast<Counter*>(threadCounters[t]);
+    for(int i=0; i<kMaxNumberOfSections; i++) {
+      counters[i].calls = 0;
+      counters[i].ticks = 0;
+    }
+  }
+}
+//-----------------------------------------------------------------------------
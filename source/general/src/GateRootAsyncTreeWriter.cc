@@ -0,0 +1,290 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateRootAsyncTreeWriter.hh"
+
+#ifdef G4ANALYSIS_USE_ROOT
+
+#include "GateMessageManager.hh"
+#include "RVersion.h"
+#include "TROOT.h"
+#include "TLeaf.h"
+#include "TLeafC.h"
+
+#include <cstring>
+
+//-----------------------------------------------------------------------------
+GateRootAsyncTreeWriter::GateRootAsyncTreeWriter()
+{
+  mBatchSize = 4096;
+  mLastTree = -1;
+  mIsRunning = false;
+  mIsWriting = false;
+  mStop = false;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GateRootAsyncTreeWriter::~GateRootAsyncTreeWriter()
+{
+  Stop();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateRootAsyncTreeWriter::IsAvailable()
+{
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+  return true;
+#else
+  return false;
+#endif
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GateRootAsyncTreeWriter::AddTree(TTree * tree)
+{
+  if (!IsAvailable() || !tree) return false;
+  if (HasTree(tree)) return true;
+
+  // Describe the branches, the tree is not changed if one of them
+  // cannot be copied as a block of bytes
+  TreeInfo * info = new TreeInfo;
+  info->tree = tree;
+  info->entrySize = 0;
+  size_t bufferSize = 0;
+  TObjArray * branches = tree->GetListOfBranches();
+  for(int i=0; i<branches->GetEntriesFast(); i++) {
+    TBranch * branch = (TBranch*)branches->At(i);
+    bool ok = (branch->IsA() == TBranch::Class() &&
+               branch->GetListOfBranches()->GetEntriesFast() == 0 &&
+               branch->GetAddress() != 0);
+    Column c;
+    c.branch = branch;
+    c.source = branch->GetAddress();
+    c.size = 0;
+    c.isString = false;
+    TObjArray * leaves = branch->GetListOfLeaves();
+    for(int j=0; ok && j<leaves->GetEntriesFast(); j++) {
+      TLeaf * leaf = (TLeaf*)leaves->At(j);
+      if (leaf->GetLeafCount()) ok = false; // variable size array
+      else if (leaf->IsA() == TLeafC::Class()) {
+        c.isString = true;
+        c.size = kMaxStringLength+1;
+        ok = (leaves->GetEntriesFast() == 1);
+      }
+      else {
+        size_t end = leaf->GetOffset() + leaf->GetLenType()*leaf->GetLenStatic();
+        if (end > c.size) c.size = end;
+      }
+    }
+    if (!ok || c.size == 0) {
+      GateMessage("Output", 2, "Tree '" << tree->GetName() << "': branch '" << branch->GetName()
+                  << "' cannot be filled asynchronously\n");
+      delete info;
+      return false;
+    }
+    c.offset = info->entrySize*mBatchSize;
+    c.bufferOffset = bufferSize;
+    info->entrySize += c.size;
+    bufferSize += (c.size+7)/8*8; // keep the private buffers aligned
+    info->columns.push_back(c);
+  }
+  if (info->columns.empty()) {
+    delete info;
+    return false;
+  }
+
+  // The writing thread must be idle when the list of trees is changed
+  Flush();
+  if (!mIsRunning) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+    // gDirectory and the other ROOT globals become thread local
+    ROOT::EnableThreadSafety();
+#endif
+    mStop = false;
+    mThread = std::thread(&GateRootAsyncTreeWriter::Run, this);
+    mIsRunning = true;
+  }
+
+  // From now, the tree reads the private buffers, which are only
+  // modified by the writing thread
+  info->buffer.assign(bufferSize, 0);
+  for(size_t i=0; i<info->columns.size(); i++) {
+    Column & c = info->columns[i];
+    c.branch->SetAddress(&info->buffer[c.bufferOffset]);
+  }
+  info->current.tree = mTrees.size();
+  info->current.nbEntries = 0;
+  mTrees.push_back(info);
+  GateMessage("Output", 2, "Tree '" << tree->GetName() << "' filled asynchronously ("
+              << info->columns.size() << " branches, " << info->entrySize << " bytes per entry)\n");
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateRootAsyncTreeWriter::FindTree(TTree * tree) const
+{
+  if (mLastTree >= 0 && mLastTree < (int)mTrees.size() && mTrees[mLastTree]->tree == tree)
+    return mLastTree;
+  for(size_t i=0; i<mTrees.size(); i++)
+    if (mTrees[i]->tree == tree) {
+      mLastTree = i;
+      return i;
+    }
+  return -1;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateRootAsyncTreeWriter::Fill(TTree * tree)
+{
+  int index = FindTree(tree);
+  if (index < 0) {
+    // Not filled by the writing thread, but written to the same file
+    std::lock_guard<std::mutex> lock(mFileMutex);
+    tree->Fill();
+    return;
+  }
+  TreeInfo & info = *mTrees[index];
+  Batch & batch = info.current;
+  if (batch.data.size() < info.entrySize*mBatchSize) batch.data.resize(info.entrySize*mBatchSize);
+
+  // One column per branch, the values of an entry are spread over the
+  // columns
+  char * data = &batch.data[0];
+  const long n = batch.nbEntries;
+  for(size_t i=0; i<info.columns.size(); i++) {
+    const Column & c = info.columns[i];
+    char * dest = data + c.offset + n*c.size;
+    if (c.isString) {
+      strncpy(dest, c.source, kMaxStringLength);
+      dest[kMaxStringLength] = 0;
+    }
+    else memcpy(dest, c.source, c.size);
+  }
+  batch.nbEntries++;
+  if (batch.nbEntries == mBatchSize) SubmitBatch(info);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateRootAsyncTreeWriter::SubmitBatch(TreeInfo & info)
+{
+  if (info.current.nbEntries == 0) return;
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    while (mPendingBatches.size() >= kMaxPendingBatches) mBatchWritten.wait(lock);
+    mPendingBatches.push_back(Batch());
+    Batch & pending = mPendingBatches.back();
+    pending.tree = info.current.tree;
+    pending.nbEntries = info.current.nbEntries;
+    pending.data.swap(info.current.data);
+    // Reuse the memory of a batch already written
+    if (!mFreeData.empty()) {
+      info.current.data.swap(mFreeData.back());
+      mFreeData.pop_back();
+    }
+  }
+  mBatchReady.notify_one();
+  info.current.nbEntries = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateRootAsyncTreeWriter::Flush()
+{
+  if (!mIsRunning) return;
+  for(size_t i=0; i<mTrees.size(); i++) SubmitBatch(*mTrees[i]);
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (!mPendingBatches.empty() || mIsWriting) mBatchWritten.wait(lock);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateRootAsyncTreeWriter::Stop()
+{
+  if (mIsRunning) {
+    Flush();
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mBatchReady.notify_one();
+    mThread.join();
+    mIsRunning = false;
+  }
+  for(size_t i=0; i<mTrees.size(); i++) {
+    TreeInfo * info = mTrees[i];
+    for(size_t j=0; j<info->columns.size(); j++)
+      info->columns[j].branch->SetAddress(info->columns[j].source);
+    delete info;
+  }
+  mTrees.clear();
+  mLastTree = -1;
+  std::vector<std::vector<char> >().swap(mFreeData);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateRootAsyncTreeWriter::WriteBatch(Batch & batch)
+{
+  TreeInfo & info = *mTrees[batch.tree];
+  char * buffer = &info.buffer[0];
+  const char * data = &batch.data[0];
+  std::lock_guard<std::mutex> lock(mFileMutex);
+  for(long n=0; n<batch.nbEntries; n++) {
+    for(size_t i=0; i<info.columns.size(); i++) {
+      const Column & c = info.columns[i];
+      memcpy(buffer + c.bufferOffset, data + c.offset + n*c.size, c.size);
+    }
+    info.tree->Fill();
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateRootAsyncTreeWriter::Run()
+{
+  std::unique_lock<std::mutex> lock(mMutex);
+  while (true) {
+    while (mPendingBatches.empty() && !mStop) mBatchReady.wait(lock);
+    // Stop only when all the batches are filled
+    if (mPendingBatches.empty()) break;
+    Batch batch;
+    batch.tree = mPendingBatches.front().tree;
+    batch.nbEntries = mPendingBatches.front().nbEntries;
+    batch.data.swap(mPendingBatches.front().data);
+    mPendingBatches.pop_front();
+    mIsWriting = true;
+    lock.unlock();
+    WriteBatch(batch);
+    lock.lock();
+    mIsWriting = false;
+    if (mFreeData.size() < kMaxPendingBatches) {
+      mFreeData.push_back(std::vector<char>());
+      mFreeData.back().swap(batch.data);
+    }
+    mBatchWritten.notify_all();
+  }
+}
+//-----------------------------------------------------------------------------
+
+#endif /* G4ANALYSIS_USE_ROOT */
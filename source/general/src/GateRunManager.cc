@@ -11,6 +11,7 @@
 #include "GateDetectorConstruction.hh"
 #include "GateRunManagerMessenger.hh"
 #include "GateHounsfieldToMaterialsBuilder.hh"
+#include "GatePhysicsTableCache.hh"
 
 #include "G4StateManager.hh"
 #include "G4UImanager.hh"
@@ -27,7 +28,7 @@
 #endif
 
 //----------------------------------------------------------------------------------------
-GateRunManager::GateRunManager():G4RunManager()
+GateRunManager::GateRunManager():GateBaseRunManager()
 {
   pMessenger = new GateRunManagerMessenger(this);
   mHounsfieldToMaterialsBuilder = new GateHounsfieldToMaterialsBuilder();
@@ -206,8 +207,11 @@ void GateRunManager::RunInitialization()
   }
 
   // GateMessage("Core", 0, "Initialization of the run \n");
-  // Perform a regular initialisation
-  G4RunManager::RunInitialization();
+  // Perform a regular initialisation, the physics tables are retrieved
+  // from (or stored in) the table cache directory if any
+  GatePhysicsTableCache::GetInstance()->BeginRunInitialization(physicsList);
+  GateBaseRunManager::RunInitialization();
+  GatePhysicsTableCache::GetInstance()->EndRunInitialization(physicsList);
 
   // Initialization of the atom deexcitation processes
   // must be done after all other initialization
@@ -226,3 +230,56 @@ void GateRunManager::RunInitialization()
     ->LocateGlobalPointAndSetup(center,0,false);
 }
 //----------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------
+void GateRunManager::SetNumberOfThreads(G4int n)
+{
+#ifdef GATE_USE_MT
+  if (n < 1) {
+    GateError("The number of threads must be at least 1 (" << n << " given)");
+  }
+  GateMessage("Core", 0, "Number of worker threads set to " << n << Gateendl);
+  GateBaseRunManager::SetNumberOfThreads(n);
+#else
+  if (n != 1) {
+    GateWarning("GATE was compiled without GATE_USE_MT, the simulation will run on a single thread ("
+                << n << " threads requested).");
+  }
+#endif
+}
+//----------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------
+G4int GateRunManager::GetNumberOfThreads() const
+{
+#ifdef GATE_USE_MT
+  return GateBaseRunManager::GetNumberOfThreads();
+#else
+  return 1;
+#endif
+}
+//----------------------------------------------------------------------------------------
+
+
+#ifdef GATE_USE_MT
+//----------------------------------------------------------------------------------------
+// Geant4 replays on each worker all the commands applied on the master. Most
+// of the GATE commands configure singletons that only live on the master
+// (geometry, sources, digitizer, outputs) and must not be executed twice. The
+// actors are the exception: each worker builds its own copy of them, so the
+// /gate/actor/ commands are kept.
+void GateRunManager::PrepareCommandsStack()
+{
+  GateBaseRunManager::PrepareCommandsStack();
+  std::vector<G4String> commands;
+  for(unsigned int i=0; i<uiCmdsForWorkers.size(); i++) {
+    const G4String & cmd = uiCmdsForWorkers[i];
+    if (cmd.find("/gate/") == 0 && cmd.find("/gate/actor/") != 0) continue;
+    commands.push_back(cmd);
+  }
+  uiCmdsForWorkers.swap(commands);
+}
+//----------------------------------------------------------------------------------------
+#endif
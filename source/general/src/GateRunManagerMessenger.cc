@@ -12,6 +12,7 @@ See LICENSE.md for further details
 
 #include "G4UIcmdWithoutParameter.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
 #include "GateDetectorConstruction.hh"
 
 //----------------------------------------------------------------------------------------
@@ -26,6 +27,11 @@ GateRunManagerMessenger::GateRunManagerMessenger(GateRunManager* runManager)
 
   pRunEnableGlobalOutputCmd = new G4UIcmdWithABool("/gate/run/enableGlobalOutput",this);
   pRunEnableGlobalOutputCmd->SetGuidance("Enabled by default. Use 'false' only for applications that do not use 'systems' (PET, SPECT etc), it will be a bit faster.");
+
+  pRunNumberOfThreadsCmd = new G4UIcmdWithAnInteger("/gate/run/setNumberOfThreads",this);
+  pRunNumberOfThreadsCmd->SetGuidance("Set the number of worker threads of the event loop (needs GATE compiled with GATE_USE_MT). Must be set before /gate/run/initialize.");
+  pRunNumberOfThreadsCmd->SetParameterName("n",false);
+  pRunNumberOfThreadsCmd->SetRange("n>0");
 }
 //----------------------------------------------------------------------------------------
 
@@ -35,6 +41,7 @@ GateRunManagerMessenger::~GateRunManagerMessenger()
   delete pRunInitCmd;
   delete pRunGeomUpdateCmd;
   delete pRunEnableGlobalOutputCmd;
+  delete pRunNumberOfThreadsCmd;
 }
 //----------------------------------------------------------------------------------------
 
@@ -50,5 +57,8 @@ void GateRunManagerMessenger::SetNewValue(G4UIcommand* command, G4String newValu
   else if (command == pRunEnableGlobalOutputCmd) {
     pRunManager->EnableGlobalOutput(pRunEnableGlobalOutputCmd->GetNewBoolValue(newValue));
   }
+  else if (command == pRunNumberOfThreadsCmd) {
+    pRunManager->SetNumberOfThreads(pRunNumberOfThreadsCmd->GetNewIntValue(newValue));
+  }
 }
 //----------------------------------------------------------------------------------------
@@ -10,14 +10,42 @@ See LICENSE.md for further details
 #include "GateVFilter.hh"
 #include "GateMessageManager.hh"
 
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+namespace { G4Mutex filterInitializationMutex = G4MUTEX_INITIALIZER; }
+#endif
+
 //-------------------------------------------------------------
 GateVFilter::GateVFilter(G4String name)
-  :GateNamedObject(name)
+  :GateNamedObject(name), mIsInitialized(false)
 {
  
 }
 //-------------------------------------------------------------
 
+//-------------------------------------------------------------
+void GateVFilter::Initialize()
+{
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&filterInitializationMutex);
+#endif
+  InitializeFilter();
+  mIsInitialized.store(true, std::memory_order_release);
+}
+//-------------------------------------------------------------
+
+//-------------------------------------------------------------
+void GateVFilter::InitializeIfNeeded()
+{
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&filterInitializationMutex);
+#endif
+  if (mIsInitialized.load(std::memory_order_relaxed)) return;
+  InitializeFilter();
+  mIsInitialized.store(true, std::memory_order_release);
+}
+//-------------------------------------------------------------
+
 //-------------------------------------------------------------
 G4bool GateVFilter::Accept(const G4Step* aStep) 
 {
@@ -18,7 +18,6 @@ See LICENSE.md for further details
 GateVolumeFilter::GateVolumeFilter(G4String name)
   :GateVFilter(name)
 {
-  IsInitialized=false;
   pVolumeFilterMessenger = new GateVolumeFilterMessenger(this);
 }
 //---------------------------------------------------------------------------
@@ -27,15 +26,12 @@ GateVolumeFilter::GateVolumeFilter(G4String name)
 //---------------------------------------------------------------------------
 G4bool GateVolumeFilter::Accept(const G4Step* aStep) 
 {
-   if(!IsInitialized) Initialize();
+   CheckInitialization();
 
    G4TouchableHistory* theTouchable = (G4TouchableHistory*)(aStep->GetPreStepPoint()->GetTouchable());
    G4LogicalVolume * currentVol = theTouchable->GetVolume(0)->GetLogicalVolume();
 
-   for(unsigned int k =0 ; k<theListOfLogicalVolume.size();k++)
-            if(theListOfLogicalVolume[k]== currentVol ) return true;
-   
-   return false;
+   return IsAccepted(currentVol);
 }
 //---------------------------------------------------------------------------
 
@@ -43,30 +39,31 @@ G4bool GateVolumeFilter::Accept(const G4Step* aStep)
 //---------------------------------------------------------------------------
 G4bool GateVolumeFilter::Accept(const G4Track* t)
 {
-   if(!IsInitialized) Initialize();
+   CheckInitialization();
 
    G4TouchableHistory* theTouchable = (G4TouchableHistory*)(t->GetTouchable());
    G4LogicalVolume * currentVol = theTouchable->GetVolume(0)->GetLogicalVolume();
 
-   for(unsigned int k =0 ; k<theListOfLogicalVolume.size();k++)
-            if(theListOfLogicalVolume[k]== currentVol ) return true;
-   
-   return false;
+   return IsAccepted(currentVol);
 }
 
 //---------------------------------------------------------------------------
 void GateVolumeFilter::addVolume(G4String volName)
 {
   theTempoListOfVolumeName.push_back(volName);
+  ResetInitialization();
 }
 //---------------------------------------------------------------------------
 
 
 //---------------------------------------------------------------------------
-void GateVolumeFilter::Initialize()
+void GateVolumeFilter::InitializeFilter()
 {
-  IsInitialized=true;
-  
+  // the filter is resolved again when the geometry is rebuilt
+  theListOfVolume.clear();
+  theListOfLogicalVolume.clear();
+  mIsLogicalVolumeAccepted.clear();
+
   for(unsigned int k =0 ; k<theTempoListOfVolumeName.size();k++)
   {
     GateVVolume * mGateVolume = GateObjectStore::GetInstance()->FindVolumeCreator(theTempoListOfVolumeName[k]);
@@ -104,6 +101,14 @@ void GateVolumeFilter::Initialize()
   {    
     theListOfLogicalVolume.push_back(theListOfVolume[k]->GetLogicalVolume());   
   }
+
+  // Accepted logical volumes, indexed by their instance ID
+  for(unsigned int k =0 ; k<theListOfLogicalVolume.size();k++)
+  {
+    const size_t id = theListOfLogicalVolume[k]->GetInstanceID();
+    if (id >= mIsLogicalVolumeAccepted.size()) mIsLogicalVolumeAccepted.resize(id+1, false);
+    mIsLogicalVolumeAccepted[id] = true;
+  }
 }
 //---------------------------------------------------------------------------
 
@@ -43,6 +43,10 @@ public:
   virtual ~GateDetectorConstruction();
 
   virtual G4VPhysicalVolume* Construct();
+#ifdef GATE_USE_MT
+  /// Each worker thread gets its own copy of the sensitive detectors and field
+  virtual void ConstructSDandField();
+#endif
   virtual void UpdateGeometry();
   virtual void SetMagField (G4ThreeVector);
   virtual void BuildMagField ();
@@ -87,6 +91,15 @@ public:
   inline virtual G4bool GetAutoUpdateFlag()
   { return flagAutoUpdate; }
 
+  //! When true (default), an update of the placements (moves) only
+  //! rebuilds the optimisation of the mothers of the moved volumes,
+  //! instead of redefining and closing the whole geometry
+  inline void SetIncrementalUpdateFlag(G4bool val)
+  { flagIncrementalUpdate = val; }
+
+  inline G4bool GetIncrementalUpdateFlag() const
+  { return flagIncrementalUpdate; }
+
   inline virtual void SetGeometryStatusFlag(GeometryStatus val)
   { nGeometryStatus = val; }
 
@@ -100,17 +113,32 @@ public:
   /// The Material database
   GateMaterialDatabase mMaterialDatabase;
 
+#ifdef GATE_USE_MT
+  inline GateCrystalSD* GetCrystalSD()
+  { return m_workerCrystalSD ? m_workerCrystalSD : m_crystalSD; }
+
+  inline GatePhantomSD*   GetPhantomSD()
+  { return m_workerPhantomSD ? m_workerPhantomSD : m_phantomSD; }
+#else
   inline GateCrystalSD* GetCrystalSD()
   { return m_crystalSD; }
 
 
   inline GatePhantomSD*   GetPhantomSD()
   { return m_phantomSD; }
+#endif
 
   //private:
 
   virtual void DestroyGeometry();
 
+protected:
+  //! Rebuilds the optimisation of the mothers of the volumes moved by the
+  //! last update. Returns false if the whole geometry must be closed again.
+  G4bool ReoptimiseMovedVolumes();
+
+public:
+
   //void SetIonisationPotential(G4String n, G4double v){mMaterialDatabase.SetMaterialIoniPotential(n,v);}
 
   void SetMaterialIoniPotential(G4String n,G4double v){theListOfIonisationPotential[n]=v;}
@@ -125,9 +153,14 @@ private :
 
   GeometryStatus nGeometryStatus;
   G4bool flagAutoUpdate;
+  G4bool flagIncrementalUpdate;
 
   GateCrystalSD*   m_crystalSD;
   GatePhantomSD*   m_phantomSD;
+#ifdef GATE_USE_MT
+  static G4ThreadLocal GateCrystalSD* m_workerCrystalSD;
+  static G4ThreadLocal GatePhantomSD* m_workerPhantomSD;
+#endif
 
   GateObjectStore* pcreatorStore;
   GateSystemListManager*  psystemStore;
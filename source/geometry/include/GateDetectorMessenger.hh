@@ -40,6 +40,7 @@ class GateDetectorMessenger: public G4UImessenger
     G4UIcmdWith3VectorAndUnit* pMagFieldCmd;
     G4UIcmdWithoutParameter*   pListCreatorsCmd;
     G4UIcmdWithAString*        IoniCmd;
+    G4UIcmdWithABool*          pIncrementalUpdateCmd;
 
     //G4UIcmdWithABool* 	       pEnableAutoUpdateCmd;    
     //G4UIcmdWithABool* 	       pDisableAutoUpdateCmd; 
@@ -0,0 +1,54 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class GateImageDistanceTransform
+  \brief Exact Euclidean distance map of a label image
+
+  The border voxels of the regions are the voxels having a 6-neighbour
+  with a different label and the voxels on the sides of the image. For
+  each voxel, the distance (mm) between its center and the center of the
+  nearest border voxel is computed. The transform is separable: a 1D
+  squared distance transform (lower envelope of parabolas, Felzenszwalb
+  and Huttenlocher) is applied along x, then y, then z, using the voxel
+  spacing of each axis, so anisotropic images are handled exactly. Each
+  pass is split over one thread per hardware core.
+*/
+
+#ifndef GATEIMAGEDISTANCETRANSFORM_HH
+#define GATEIMAGEDISTANCETRANSFORM_HH
+
+#include "GateImage.hh"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+class GateImageDistanceTransform
+{
+public:
+  GateImageDistanceTransform();
+
+  /// Computes the distance map of 'labels' into 'output' (allocated
+  /// here, with the same geometry as 'labels')
+  void Compute(const GateImage & labels, GateImage & output);
+
+protected:
+  void ComputeBorders(const GateImage & labels, float * f, int zmin, int zmax) const;
+  void TransformLines(float * f, int axis, int firstLine, int lastLine) const;
+  void TransformLine(float * f, size_t stride, int n, double spacing,
+                     std::vector<double> & g, std::vector<int> & v,
+                     std::vector<double> & z) const;
+  template<class Function> void RunInParallel(int n, Function f) const;
+
+  int mNumberOfThreads;
+  int mSize[3];
+  double mSpacing[3];
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEIMAGEDISTANCETRANSFORM_HH */
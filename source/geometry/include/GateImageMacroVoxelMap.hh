@@ -0,0 +1,54 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class GateImageMacroVoxelMap
+  \brief Coarse map of the homogeneous blocks of a label image
+
+  The image is divided into blocks of NxNxN voxels (macro-voxels). For
+  each block, the map stores its label when all its voxels have the same
+  label, or -1 otherwise (the labels must be positive, as after
+  GateVImageVolume::RemapLabelsContiguously). It is used by the image navigators to cross a
+  homogeneous block in one step instead of voxel by voxel.
+*/
+
+#ifndef GATEIMAGEMACROVOXELMAP_HH
+#define GATEIMAGEMACROVOXELMAP_HH
+
+#include "GateImage.hh"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+class GateImageMacroVoxelMap
+{
+public:
+  GateImageMacroVoxelMap();
+
+  /// Builds the map of 'image' with blocks of n voxels per side
+  void Build(const GateImage & image, int n);
+
+  int GetBlockSize() const { return mBlockSize; }
+
+  /// Label of the block containing voxel (i,j,k), -1 if not homogeneous
+  inline int GetBlockLabel(int i, int j, int k) const {
+    return mLabels[i/mBlockSize + (j/mBlockSize)*mNumberOfBlocks[0] +
+                   (k/mBlockSize)*mNumberOfBlocks[0]*mNumberOfBlocks[1]];
+  }
+
+  /// Number of homogeneous blocks
+  int GetNumberOfHomogeneousBlocks() const;
+
+protected:
+  int mBlockSize;
+  int mNumberOfBlocks[3];
+  std::vector<int> mLabels;
+};
+//-----------------------------------------------------------------------------
+
+#endif /* end #define GATEIMAGEMACROVOXELMAP_HH */
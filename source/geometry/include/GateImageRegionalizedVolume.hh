@@ -19,6 +19,7 @@ See LICENSE.md for further details
 
 #include "GateVImageVolume.hh"
 #include "GateImageRegionalizedVolumeSolid.hh"
+#include "GateImageMacroVoxelMap.hh"
 
 #define TODO int
 
@@ -139,6 +140,9 @@ public:
   //====================================================================
   /// Sets the name of the distance map file
   void SetDistanceMapFilename(const G4String& name) { mDistanceMapFilename = name; }
+  /// Sets the size (in voxels) of the homogeneous blocks crossed in one
+  /// step by DistanceToOut (0 or 1 = disabled)
+  void SetMacroVoxelSize(G4int n) { mMacroVoxelSize = n; }
   //====================================================================
 
 
@@ -208,6 +212,10 @@ private:
   /// The name of the distance map file
   G4String mDistanceMapFilename;
   //====================================================================
+  /// Map of the homogeneous blocks of the label image
+  GateImageMacroVoxelMap mMacroVoxelMap;
+  G4int mMacroVoxelSize;
+  //====================================================================
 };
 // EO class GateImageRegionalizedVolume
 //====================================================================
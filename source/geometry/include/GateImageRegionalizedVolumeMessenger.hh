@@ -20,6 +20,7 @@ See LICENSE.md for further details
 #include "GateVImageVolumeMessenger.hh"
 #include "globals.hh"
 #include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
 
 class GateImageRegionalizedVolume;
 
@@ -36,6 +37,7 @@ public:
 private:
   GateImageRegionalizedVolume* pVolume;   
   G4UIcmdWithAString* pDistanceMapNameCmd;
+  G4UIcmdWithAnInteger* pMacroVoxelSizeCmd;
 };
 //====================================================================
 
@@ -12,7 +12,9 @@ See LICENSE.md for further details
 #define GateMDBFile_hh
 
 #include "globals.hh"
-#include <fstream>
+#include <vector>
+#include <string>
+#include <unordered_map>
 
 #include "G4Material.hh"
 
@@ -48,18 +50,22 @@ protected:
   void     ReadAllMaterialOptions(const G4String& materialName,const G4String& line,GateMaterialCreator* creator);
   void     ReadMaterialOption(const G4String& materialName,const G4String& field,GateMaterialCreator* creator);
 
-  void     FindSection(const G4String& name);
-  G4bool   LookForText(const G4String& text);
+  void     LoadFile();
   G4String ReadItem(const G4String& sectionName,const G4String& itemName);
   G4int    ReadNonEmptyLine(G4String& lineBuffer);
-  G4int    ReadLine(G4String& lineBuffer);
 
 private:
   // Stores the database which instanciated this (used by creators)
   GateMaterialDatabase* mDatabase;
   G4String fileName;
   G4String filePath;
-  std::ifstream dbStream;
+
+  // The file is read once: non-empty lines (cleaned up) and the index
+  // of the first line of each item, with the key "[section]item"
+  std::vector<G4String> mLines;
+  std::unordered_map<std::string,size_t> mItemIndex;
+  // Next line read by ReadNonEmptyLine (i.e. just below the last item found)
+  size_t mCurrentLine;
 
 public:
   static char theStarterSeparator;
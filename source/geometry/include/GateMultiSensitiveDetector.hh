@@ -61,6 +61,7 @@ protected:
 protected:
   G4VSensitiveDetector * pSensitiveDetector;
   G4MultiFunctionalDetector* pMultiFunctionalDetector;
+  bool mHasSharedActor;
 };
 
 #endif /* end #define GATEMSD_HH */
@@ -25,6 +25,8 @@
 #include "GateImage.hh"
 #include <map>
 #include <vector>
+#include <stdint.h>
+#include <atomic>
 
 #include "G4VSolid.hh"
 #include "G4Box.hh"
@@ -100,9 +102,16 @@ public:
   //-----------------------------------------------------------------------------
   /// Returns the volume's half size
   inline G4ThreeVector GetHalfSize() const { return mHalfSize; }
-  /// Gets the Image
-  inline ImageType* GetImage() { return pImage; }
-  inline const ImageType* GetImage() const { return pImage; }
+  /// Gets the Image (the labels are restored from the compact label
+  /// image if they were released)
+  inline ImageType* GetImage() {
+    if (mIsLabelImageReleased.load(std::memory_order_acquire)) RestoreLabelImage();
+    return pImage;
+  }
+  inline const ImageType* GetImage() const {
+    if (mIsLabelImageReleased.load(std::memory_order_acquire)) RestoreLabelImage();
+    return pImage;
+  }
 
   /// Returns the volume's transform matrix
   inline G4RotationMatrix GetTransformMatrix() const { return mTransformMatrix; }
@@ -113,6 +122,23 @@ public:
   //  inline LabelType GetLabel( int index ) { return (LabelType)pImage->GetValue(index); }
   /// Returns the label at voxel of coordinates i,j,k
   //inline LabelType GetLabel( int i, int j, int k ) { return (LabelType)pImage->GetValue(i,j,k); }
+
+  /// Builds the compact label image (8 bits when there are less than
+  /// 256 labels, 16 bits otherwise). Must be called once the labels are
+  /// final (after LoadImageMaterialsTable).
+  void BuildCompactLabelImage();
+  /// Returns the label at voxel of index, from the compact label image
+  inline LabelType GetCompactLabel(int index) const {
+    return mCompactLabels8.empty() ? mCompactLabels16[index] : mCompactLabels8[index];
+  }
+  /// Returns the label at voxel of coordinates i,j,k, from the compact label image
+  inline LabelType GetCompactLabel(int i, int j, int k) const {
+    return GetCompactLabel(i + j*mCompactLineSize + k*mCompactPlaneSize);
+  }
+  /// Frees the float labels once the compact label image is built. They
+  /// are restored by the first call to GetImage (actors reading the
+  /// labels), so that only the compact copy is kept otherwise.
+  void ReleaseLabelImage();
   //-----------------------------------------------------------------------------
 
   //-----------------------------------------------------------------------------
@@ -197,6 +223,8 @@ protected:
   //-----------------------------------------------------------------------------
   /// Build distance map
   void BuildDistanceTransfo();
+  std::string GetDistanceTransfoDescription() const;
+  bool IsDistanceTransfoUpToDate(const std::string & description) const;
   G4String mDistanceTransfoOutput;
   bool mBuildDistanceTransfo;
   //-----------------------------------------------------------------------------
@@ -221,6 +249,14 @@ protected:
   ImageType* pImage;
   /// LabelToMaterialName
   LabelToMaterialNameType mLabelToMaterialName;
+  /// Compact copy of the label image used by the parametrisations (only
+  /// one of the two vectors is filled)
+  std::vector<uint8_t>  mCompactLabels8;
+  std::vector<uint16_t> mCompactLabels16;
+  int mCompactLineSize;
+  int mCompactPlaneSize;
+  mutable std::atomic<bool> mIsLabelImageReleased;
+  void RestoreLabelImage() const;
   //-----------------------------------------------------------------------------
 
   //-----------------------------------------------------------------------------
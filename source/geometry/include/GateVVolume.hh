@@ -57,6 +57,20 @@ public :
   virtual void DestroyGeometry();
   virtual void  DestroyOwnPhysicalVolumes();
 
+  //! Incremented each time physical volumes are deleted: the tables
+  //! indexed by physical volume pointers must then be cleared
+  static G4int GetGeometryGeneration() { return mGeometryGeneration; }
+
+  //! During an update (Construct(true)), only the placements which have
+  //! changed are rewritten and stored in the list of moved volumes, so
+  //! that only the optimisation of their mothers is rebuilt.
+  //! AreAllMovesTracked is false if an override of
+  //! ConstructOwnPhysicalVolume did not report its moved placements
+  //! (see SetOwnPlacementsTracked).
+  static void ClearMovedPhysicalVolumes();
+  static const std::vector<G4VPhysicalVolume*>& GetMovedPhysicalVolumes() { return mMovedPhysicalVolumes; }
+  static G4bool AreAllMovesTracked() { return mAllMovesTracked; }
+
   //! Pure virtual method (to be implemented in sub-classes)
   //! Must return an value for the half-size of a volume along an axis (X=0, Y=1, Z=2)
   virtual G4double GetHalfDimension(size_t axis)=0;
@@ -86,6 +100,17 @@ protected :
   inline virtual void PushPhysicalVolume(G4VPhysicalVolume* volume)
   { theListOfOwnPhysVolume.push_back(volume);}
 
+  //! For the overrides of ConstructOwnPhysicalVolume, during an update:
+  //! a placement whose transform is unchanged is left untouched, a
+  //! changed one is stored with AddMovedPhysicalVolume. Once all the
+  //! changed placements are stored, SetOwnPlacementsTracked tells it
+  //! (otherwise the whole geometry is closed again).
+  static G4bool IsPlacementUnchanged(const G4VPhysicalVolume* volume,
+                                     const G4RotationMatrix& rotationMatrix,
+                                     const G4ThreeVector& position);
+  static void AddMovedPhysicalVolume(G4VPhysicalVolume* volume) { mMovedPhysicalVolumes.push_back(volume); }
+  static void SetOwnPlacementsTracked() { mOwnPlacementsTracked = true; }
+
   virtual void DestroyOwnSolidAndLogicalVolume()=0;
 
 public :
@@ -296,6 +321,14 @@ private :
   //! Tag added to names to create physical volume names
   static const G4String mThePhysicalVolumeNameTag;
 
+  //! See GetGeometryGeneration
+  static G4int mGeometryGeneration;
+
+  //! See GetMovedPhysicalVolumes
+  static std::vector<G4VPhysicalVolume*> mMovedPhysicalVolumes;
+  static G4bool mAllMovesTracked;
+  static G4bool mOwnPlacementsTracked;
+
   //! Translation vector
   G4ThreeVector m_translation;
 
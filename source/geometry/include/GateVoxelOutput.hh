@@ -45,6 +45,7 @@ public:
   void RecordBeginOfEvent(const G4Event *);
   void RecordEndOfEvent(const G4Event *);
   void RecordStepWithVolume(const GateVVolume * v, const G4Step *);
+  G4bool IsRecordingSteps() const { return false; }
   void RecordVoxels(GateVGeometryVoxelStore *) {};
 
 
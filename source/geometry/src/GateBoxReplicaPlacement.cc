@@ -43,6 +43,9 @@ void GateBoxReplicaPlacement::ConstructOwnPhysicalVolume(G4bool flagUpdateOnly)
   }
   else {
     m_Replica->Update(m_Axis,m_ReplicaNb,m_Delta,0.0) ;
+    // The replica may have changed: its mother is optimised again
+    AddMovedPhysicalVolume(m_Replica);
+    SetOwnPlacementsTracked();
   }
 }
 
@@ -34,7 +34,10 @@ void GateCompressedVoxelParam::ConstructOwnPhysicalVolume(G4bool flagUpdate){
 
 
   // For the update case; there is nothing to do here.
-  if (flagUpdate) return;
+  if (flagUpdate) {
+    SetOwnPlacementsTracked();
+    return;
+  }
     
   // Build the parameterization
   GateVGeometryVoxelReader* itsReader ( itsInserter->GetReader() );
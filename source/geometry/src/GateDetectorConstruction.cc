@@ -27,15 +27,25 @@
 #include "G4FieldManager.hh"
 #include "G4TransportationManager.hh"
 #include "G4Navigator.hh"
+#include "G4GeometryManager.hh"
 #include "G4SDManager.hh"
 #include "G4Material.hh"
 #include "G4Material.hh"
+#include <set>
+#ifdef GATE_USE_MT
+#include "G4LogicalVolumeStore.hh"
+#include "GateMultiSensitiveDetector.hh"
+#endif
 
 #ifdef GATE_USE_OPTICAL
 #include "GateSurfaceList.hh"
 #endif
 
 GateDetectorConstruction* GateDetectorConstruction::pTheGateDetectorConstruction=0;
+#ifdef GATE_USE_MT
+G4ThreadLocal GateCrystalSD* GateDetectorConstruction::m_workerCrystalSD=0;
+G4ThreadLocal GatePhantomSD* GateDetectorConstruction::m_workerPhantomSD=0;
+#endif
 
 //---------------------------------------------------------------------------------
 GateDetectorConstruction::GateDetectorConstruction()
@@ -43,6 +53,7 @@ GateDetectorConstruction::GateDetectorConstruction()
      pworldPhysicalVolume(0),
      nGeometryStatus(geometry_needs_rebuild),
      flagAutoUpdate(false),
+     flagIncrementalUpdate(true),
      m_crystalSD(0),
      m_phantomSD(0),
      pdetectorMessenger(0),
@@ -160,6 +171,45 @@ G4VPhysicalVolume* GateDetectorConstruction::Construct()
 }
 //---------------------------------------------------------------------------------
 
+#ifdef GATE_USE_MT
+//---------------------------------------------------------------------------------
+// Called by each worker thread once the (shared) geometry is built: the
+// volumes which have the crystal or the phantom SD in the master get a copy
+// owned by the thread. The actors add their own SD at the first run.
+void GateDetectorConstruction::ConstructSDandField()
+{
+  GateMessage("Geometry", 3, "Worker sensitive detectors construction starts.\n");
+
+  G4SDManager* SDman = G4SDManager::GetSDMpointer();
+  m_workerCrystalSD = static_cast<GateCrystalSD*>(m_crystalSD->Clone());
+  m_workerPhantomSD = static_cast<GatePhantomSD*>(m_phantomSD->Clone());
+  SDman->AddNewDetector(m_workerCrystalSD);
+  SDman->AddNewDetector(m_workerPhantomSD);
+
+  G4LogicalVolumeStore* store = G4LogicalVolumeStore::GetInstance();
+  for (G4LogicalVolumeStore::iterator it = store->begin(); it != store->end(); ++it) {
+    G4VSensitiveDetector* masterSD = (*it)->GetMasterSensitiveDetector();
+    // The master SD may have been wrapped by the actors
+    GateMultiSensitiveDetector* msd = dynamic_cast<GateMultiSensitiveDetector*>(masterSD);
+    if (msd) masterSD = msd->GetSensitiveDetector();
+    if (masterSD == 0) continue;
+    if (masterSD == m_crystalSD) (*it)->SetSensitiveDetector(m_workerCrystalSD);
+    else if (masterSD == m_phantomSD) (*it)->SetSensitiveDetector(m_workerPhantomSD);
+    else GateWarning("The sensitive detector " << masterSD->GetName() << " of the volume "
+                     << (*it)->GetName() << " is not available in the worker threads.");
+  }
+
+  // The field manager is thread local
+  if (m_magFieldValue.mag()!=0.) {
+    G4UniformMagField* field = new G4UniformMagField(m_magFieldValue);
+    G4FieldManager* fieldMgr = G4TransportationManager::GetTransportationManager()->GetFieldManager();
+    fieldMgr->SetDetectorField(field);
+    fieldMgr->CreateChordFinder(field);
+  }
+}
+//---------------------------------------------------------------------------------
+#endif
+
 //---------------------------------------------------------------------------------
 // Adds a Material Database
 void GateDetectorConstruction::AddFileToMaterialDatabase(const G4String& f)
@@ -221,7 +271,15 @@ void GateDetectorConstruction::UpdateGeometry()
 
   switch (nGeometryStatus){
   case geometry_needs_update:
+    GateVVolume::ClearMovedPhysicalVolumes();
     pworld->Construct(true);
+    // Only the transforms have changed: the world is kept, only the
+    // optimisation of the mothers of the moved volumes is rebuilt
+    if (flagIncrementalUpdate && ReoptimiseMovedVolumes()) {
+      nGeometryStatus = geometry_is_uptodate;
+      GateMessage("Geometry", 3, "UpdateGeometry finished (placements only). \n");
+      return;
+    }
     break;
 
   case geometry_needs_rebuild:
@@ -239,6 +297,35 @@ void GateDetectorConstruction::UpdateGeometry()
 }
 //---------------------------------------------------------------------------------
 
+//---------------------------------------------------------------------------------
+G4bool GateDetectorConstruction::ReoptimiseMovedVolumes()
+{
+  if (!GateVVolume::AreAllMovesTracked()) {
+    GateMessage("Geometry", 3, "Some moved volumes are not tracked, the whole geometry is closed again.\n");
+    return false;
+  }
+
+  // The geometry has not been closed yet: it will be optimised as a
+  // whole at the beginning of the run
+  G4GeometryManager* geometryManager = G4GeometryManager::GetInstance();
+  if (!geometryManager->IsGeometryClosed()) return true;
+
+  // The optimisation of a mother is rebuilt once, from any of its
+  // moved daughters
+  const std::vector<G4VPhysicalVolume*>& movedVolumes = GateVVolume::GetMovedPhysicalVolumes();
+  std::set<G4LogicalVolume*> mothers;
+  for (size_t i=0; i<movedVolumes.size(); ++i) {
+    G4VPhysicalVolume* volume = movedVolumes[i];
+    if (!mothers.insert(volume->GetMotherLogical()).second) continue;
+    geometryManager->OpenGeometry(volume);
+    geometryManager->CloseGeometry(true, false, volume);
+  }
+  GateMessage("Geometry", 4, movedVolumes.size() << " placements updated, "
+              << mothers.size() << " mother volumes optimised again.\n");
+  return true;
+}
+//---------------------------------------------------------------------------------
+
 //---------------------------------------------------------------------------------
 void GateDetectorConstruction::DestroyGeometry()
 {
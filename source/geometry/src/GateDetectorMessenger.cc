@@ -104,6 +104,12 @@ GateDetectorMessenger::GateDetectorMessenger(GateDetectorConstruction* GateDet)
   IoniCmd = new G4UIcmdWithAString(cmd,this);
   IoniCmd->SetGuidance("Set the ionisation potential for a material (two parameters 'material' and 'value and unit')");
 
+  cmd = "/gate/geometry/setIncrementalUpdate";
+  pIncrementalUpdateCmd = new G4UIcmdWithABool(cmd,this);
+  pIncrementalUpdateCmd->SetGuidance("When volumes move between runs, only optimise again the mothers of the moved volumes (default: true)");
+  pIncrementalUpdateCmd->SetGuidance("If false, the whole geometry is closed again at each update");
+  pIncrementalUpdateCmd->SetParameterName("flag",false);
+
 
 
 
@@ -119,6 +125,7 @@ GateDetectorMessenger::~GateDetectorMessenger()
   delete pMagFieldCmd;
   delete pListCreatorsCmd;
   delete IoniCmd;
+  delete pIncrementalUpdateCmd;
 
   delete pGateGeometryDir;
   delete pGateDir;
@@ -138,6 +145,8 @@ void GateDetectorMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
  
   else if( command == pListCreatorsCmd )
     { pDetectorConstruction->GetObjectStore()->ListCreators(); }
+  else if( command == pIncrementalUpdateCmd )
+    { pDetectorConstruction->SetIncrementalUpdateFlag(pIncrementalUpdateCmd->GetNewBoolValue(newValue)); }
   else if( command == IoniCmd )
     {
       G4String matName;
@@ -50,6 +50,7 @@ void GateFictitiousVoxelMapParam::ConstructOwnPhysicalVolume(G4bool flagUpdate)
 
   // For the update case; there is nothing to do here.
   if (flagUpdate) {
+    SetOwnPlacementsTracked();
     if (itsInserter->GetVerbosity()>=1) {
       G4cout << "---- Exiting GateFictitiousVoxelMapParam::ConstructOwnPhysicalVolume ..."
              << Gateendl
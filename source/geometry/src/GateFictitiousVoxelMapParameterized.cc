@@ -332,7 +332,13 @@ void GateFictitiousVoxelMapParameterized::ConstructOwnPhysicalVolume ( G4bool fl
         // Update physical volume
         //----------------------------------------------------------------  
         pOwnPhys = GetPhysicalVolume(copyNumber);
-   
+
+        // Placements which did not change are left untouched
+        if (IsPlacementUnchanged(pOwnPhys, rotationMatrix, position)) {
+          delete newRotationMatrix;
+          continue;
+        }
+
         // Set the translation vector for this physical volume
         pOwnPhys->SetTranslation(position);
      
@@ -341,6 +347,7 @@ void GateFictitiousVoxelMapParameterized::ConstructOwnPhysicalVolume ( G4bool fl
           delete pOwnPhys->GetRotation();
       
         pOwnPhys->SetRotation(newRotationMatrix);
+        AddMovedPhysicalVolume(pOwnPhys);
     
         GateMessage("Geometry", 3,"@  " << GetPhysicalVolumeName() << " has been updated.\n";);
     
@@ -354,6 +361,8 @@ void GateFictitiousVoxelMapParameterized::ConstructOwnPhysicalVolume ( G4bool fl
         PushPhysicalVolume(thePhysicalVolume);
       }
   }//end for
+
+  SetOwnPlacementsTracked();
 }
 
 std::string GateFictitiousVoxelMapParameterized::Double2String ( G4double d ) const
@@ -0,0 +1,181 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateImageDistanceTransform.hh"
+#include "GateMessageManager.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace {
+  const float kInfinity = std::numeric_limits<float>::max();
+}
+
+//-----------------------------------------------------------------------------
+GateImageDistanceTransform::GateImageDistanceTransform()
+{
+  mNumberOfThreads = std::thread::hardware_concurrency();
+  if (mNumberOfThreads < 1) mNumberOfThreads = 1;
+  for(int i=0; i<3; i++) {
+    mSize[i] = 0;
+    mSpacing[i] = 1.0;
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+template<class Function>
+void GateImageDistanceTransform::RunInParallel(int n, Function f) const
+{
+  int nbThreads = std::min(mNumberOfThreads, n);
+  if (nbThreads <= 1) {
+    f(0, n);
+    return;
+  }
+  std::vector<std::thread> threads;
+  for(int t=0; t<nbThreads; t++) {
+    int first = (int)((long)n*t/nbThreads);
+    int last = (int)((long)n*(t+1)/nbThreads);
+    threads.push_back(std::thread(f, first, last));
+  }
+  for(size_t t=0; t<threads.size(); t++) threads[t].join();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageDistanceTransform::Compute(const GateImage & labels, GateImage & output)
+{
+  for(int i=0; i<3; i++) {
+    mSize[i] = (int)lrint(labels.GetResolution()[i]);
+    mSpacing[i] = labels.GetVoxelSize()[i];
+  }
+  output.SetResolutionAndVoxelSize(labels.GetResolution(), labels.GetVoxelSize());
+  output.SetOrigin(labels.GetOrigin());
+  output.Allocate();
+
+  // The squared distances are computed in place in the output image
+  float * f = &(*output.begin());
+  const int nx = mSize[0];
+  const int ny = mSize[1];
+  const int nz = mSize[2];
+
+  GateMessage("Geometry", 4, "Distance map: borders\n");
+  RunInParallel(nz, [&](int a, int b) { ComputeBorders(labels, f, a, b); });
+  GateMessage("Geometry", 4, "Distance map: x pass\n");
+  RunInParallel(ny*nz, [&](int a, int b) { TransformLines(f, 0, a, b); });
+  GateMessage("Geometry", 4, "Distance map: y pass\n");
+  RunInParallel(nx*nz, [&](int a, int b) { TransformLines(f, 1, a, b); });
+  GateMessage("Geometry", 4, "Distance map: z pass\n");
+  RunInParallel(nx*ny, [&](int a, int b) { TransformLines(f, 2, a, b); });
+
+  const long n = output.GetNumberOfValues();
+  RunInParallel(mNumberOfThreads, [&](int a, int b) {
+      for(long i=n*a/mNumberOfThreads; i<n*b/mNumberOfThreads; i++) f[i] = std::sqrt(f[i]);
+    });
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageDistanceTransform::ComputeBorders(const GateImage & labels, float * f,
+                                                int zmin, int zmax) const
+{
+  const int nx = mSize[0];
+  const int ny = mSize[1];
+  const int nz = mSize[2];
+  const size_t lineSize = nx;
+  const size_t planeSize = (size_t)nx*ny;
+  const float * l = &(*labels.begin());
+
+  for(int z=zmin; z<zmax; z++)
+    for(int y=0; y<ny; y++) {
+      size_t index = z*planeSize + y*lineSize;
+      for(int x=0; x<nx; x++, index++) {
+        bool border = (x == 0 || y == 0 || z == 0 || x == nx-1 || y == ny-1 || z == nz-1);
+        if (!border) {
+          const int label = lrint(l[index]);
+          border = (lrint(l[index-1]) != label || lrint(l[index+1]) != label ||
+                    lrint(l[index-lineSize]) != label || lrint(l[index+lineSize]) != label ||
+                    lrint(l[index-planeSize]) != label || lrint(l[index+planeSize]) != label);
+        }
+        f[index] = (border ? 0.0f : kInfinity);
+      }
+    }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageDistanceTransform::TransformLines(float * f, int axis, int firstLine, int lastLine) const
+{
+  const size_t nx = mSize[0];
+  const size_t ny = mSize[1];
+  std::vector<double> g(mSize[axis]);
+  std::vector<int> v(mSize[axis]);
+  std::vector<double> z(mSize[axis]+1);
+
+  for(int line=firstLine; line<lastLine; line++) {
+    size_t start, stride;
+    if (axis == 0) { start = line*nx; stride = 1; }
+    else if (axis == 1) { start = (line%nx) + (line/nx)*nx*ny; stride = nx; }
+    else { start = line; stride = nx*ny; }
+    TransformLine(f+start, stride, mSize[axis], mSpacing[axis], g, v, z);
+  }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+// Squared distance transform of one line, the values of the sampled
+// function are replaced by min_p ((q-p)*spacing)^2 + f(p)
+void GateImageDistanceTransform::TransformLine(float * f, size_t stride, int n, double spacing,
+                                               std::vector<double> & g, std::vector<int> & v,
+                                               std::vector<double> & z) const
+{
+  for(int q=0; q<n; q++) g[q] = f[q*stride];
+
+  // Lower envelope of the parabolas rooted at the finite values
+  int k = -1;
+  for(int q=0; q<n; q++) {
+    if (g[q] >= kInfinity) continue;
+    const double xq = q*spacing;
+    if (k < 0) {
+      k = 0;
+      v[0] = q;
+      z[0] = -std::numeric_limits<double>::max();
+      z[1] = std::numeric_limits<double>::max();
+      continue;
+    }
+    double xv = v[k]*spacing;
+    double s = ((g[q] + xq*xq) - (g[v[k]] + xv*xv)) / (2.0*(xq-xv));
+    // z[0] is -infinity, so k stays >= 0
+    while (s <= z[k]) {
+      k--;
+      xv = v[k]*spacing;
+      s = ((g[q] + xq*xq) - (g[v[k]] + xv*xv)) / (2.0*(xq-xv));
+    }
+    k++;
+    v[k] = q;
+    z[k] = s;
+    z[k+1] = std::numeric_limits<double>::max();
+  }
+  if (k < 0) return; // no border on this line
+
+  k = 0;
+  for(int q=0; q<n; q++) {
+    const double xq = q*spacing;
+    while (z[k+1] < xq) k++;
+    const double d = xq - v[k]*spacing;
+    f[q*stride] = (float)(d*d + g[v[k]]);
+  }
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,51 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GateImageMacroVoxelMap.hh"
+
+//-----------------------------------------------------------------------------
+GateImageMacroVoxelMap::GateImageMacroVoxelMap()
+{
+  mBlockSize = 1;
+  for(int i=0; i<3; i++) mNumberOfBlocks[i] = 0;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GateImageMacroVoxelMap::Build(const GateImage & image, int n)
+{
+  mBlockSize = n;
+  int size[3];
+  for(int i=0; i<3; i++) {
+    size[i] = (int)lrint(image.GetResolution()[i]);
+    mNumberOfBlocks[i] = (size[i] + n - 1)/n;
+  }
+  // -2 : block not visited yet
+  mLabels.assign(mNumberOfBlocks[0]*mNumberOfBlocks[1]*mNumberOfBlocks[2], -2);
+  GateImage::const_iterator it = image.begin();
+  for(int k=0; k<size[2]; k++)
+    for(int j=0; j<size[1]; j++)
+      for(int i=0; i<size[0]; i++, ++it) {
+        int & b = mLabels[i/n + (j/n)*mNumberOfBlocks[0] + (k/n)*mNumberOfBlocks[0]*mNumberOfBlocks[1]];
+        const int label = (int)lrint(*it);
+        if (b == -2) b = label;
+        else if (b != label) b = -1;
+      }
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+int GateImageMacroVoxelMap::GetNumberOfHomogeneousBlocks() const
+{
+  int nb = 0;
+  for(size_t i=0; i<mLabels.size(); i++) if (mLabels[i] >= 0) nb++;
+  return nb;
+}
+//-----------------------------------------------------------------------------
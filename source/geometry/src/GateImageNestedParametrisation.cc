@@ -28,6 +28,7 @@ GateImageNestedParametrisation::GateImageNestedParametrisation(GateImageNestedPa
 
   GateMessage("Volume",5,"Begin GateImageNestedParametrisation()\n");
   pVolume->BuildLabelToG4MaterialVector(mVectorLabel2Material);
+  pVolume->BuildCompactLabelImage();
 
   mAirMaterial = 
     theMaterialDatabase.GetMaterial("Air");
@@ -100,7 +101,7 @@ G4Material* GateImageNestedParametrisation::ComputeMaterial(G4VPhysicalVolume* /
 		   << ix << " " << iy << " " << iz << Gateendl);
   
   // Get label of material at voxel "copyNo"
-  G4int lab = (G4int)pVolume->GetImage()->GetValue(ix, iy, iz);
+  G4int lab = pVolume->GetCompactLabel(ix, iy, iz);
   
   GateDebugMessage("Volume",6,"GateImageNestedParametrisation::ComputeMaterial lab " 
 		   << lab << Gateendl);
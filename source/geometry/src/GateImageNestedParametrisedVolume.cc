@@ -193,6 +193,9 @@ G4LogicalVolume* GateImageNestedParametrisedVolume::ConstructOwnSolidAndLogicalV
 			  (int)lrint(GetImage()->GetResolution().z()), // Number of copies = number of voxels
 			  voxelParam);
 
+  // The parametrisation only reads the compact label image
+  ReleaseLabelImage();
+
   GateMessageInc("Volume",3,"End GateImageNestedParametrisedVolume::ConstructOwnSolidAndLogicalVolume()\n");
   return pBoxLog;
 }
@@ -236,7 +239,7 @@ void GateImageNestedParametrisedVolume::GetPhysVolForAVoxel(const G4int index,
   // Get dimension (no computation, because same size)
   pSolid->ComputeDimensions(mVoxelParametrisation, index, pPhysVol);
   // Compute position// --> slow ?! should be precomputed ?
-  G4ThreeVector v = GetImage()->GetCoordinatesFromIndex(index);
+  G4ThreeVector v = pImage->GetCoordinatesFromIndex(index);
   int ix,iy,iz;
   ix = (int)lrint(v[0]);
   iy = (int)lrint(v[1]);
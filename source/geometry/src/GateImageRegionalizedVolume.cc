@@ -25,6 +25,9 @@
 #include "GatePhantomSD.hh"
 #include "GateDetectorConstruction.hh"
 
+#include <algorithm>
+#include <cmath>
+
 //-----------------------------------------------------------------------------
 /// Constructor with :
 /// the path to the volume to create (for commands)
@@ -43,6 +46,7 @@ GateImageRegionalizedVolume::GateImageRegionalizedVolume(const G4String& name,
   kCarTolerance = G4GeometryTolerance::GetInstance()->GetSurfaceTolerance();
   mDistanceMapFilename = "none";
   pDistanceMap = 0;
+  mMacroVoxelSize = 8;
   GateMessageDec("Volume",5,"GateImageRegionalizedVolume() - end\n");
 }
 //-----------------------------------------------------------------------------
@@ -94,8 +98,12 @@ G4LogicalVolume* GateImageRegionalizedVolume::ConstructOwnSolidAndLogicalVolume(
     GateError("Sorry not possible to user BoundingBoxOnlyMode with RegionalizedVolume. Use NestedParameterised instead");
   }
 
-  // If needed, compute the distance map
-  if (mBuildDistanceTransfo) BuildDistanceTransfo();
+  // If needed, compute the distance map (or reuse it if it is up to
+  // date) and use it when no other map is given
+  if (mBuildDistanceTransfo) {
+    BuildDistanceTransfo();
+    if (mDistanceMapFilename == "none") mDistanceMapFilename = mDistanceTransfoOutput;
+  }
 
   //  EnableSmartVoxelOptimisation(false);
   G4String boxname = GetObjectName() + "_solid";
@@ -106,6 +114,13 @@ G4LogicalVolume* GateImageRegionalizedVolume::ConstructOwnSolidAndLogicalVolume(
   // ---------------------------
   LoadDistanceMap();
 
+  // Homogeneous blocks crossed in one step by DistanceToOut
+  if (mMacroVoxelSize > 1) {
+    mMacroVoxelMap.Build(*GetImage(), mMacroVoxelSize);
+    GateMessage("Volume", 1, "Macro-voxels of " << mMacroVoxelSize << " voxels: "
+                << mMacroVoxelMap.GetNumberOfHomogeneousBlocks() << " homogeneous blocks.\n");
+  }
+
   // Set position if IsoCenter is Set
   UpdatePositionWithIsoCenter();
 
@@ -191,7 +206,7 @@ void GateImageRegionalizedVolume::LoadDistanceMap()
 	      << Gateendl
 	      << "Please use /gate/" << GetObjectName() << "/geometry/buildAndDumpDistanceTransfo dmap.mhd"
 	      << Gateendl
-	      << "to generate the dmap and then, /gate/patient/geometry/distanceMap dmap.mhd to use it."
+	      << "to generate and use the dmap, or /gate/patient/geometry/distanceMap dmap.mhd to use an existing one."
 	      << Gateendl);
     pDistanceMap = new DistanceMapType;
     pDistanceMap->SetResolutionAndHalfSize(GetImage()->GetResolution(), GetImage()->GetHalfSize());
@@ -850,6 +865,15 @@ G4double GateImageRegionalizedVolume::DistanceToOut(const G4ThreeVector& p,
 
   int nbStep = 0; // DEBUG
 
+  // Current voxel coordinates, used to find the macro-voxel
+  const int nx = (int)lrint(GetImage()->GetResolution().x());
+  const int ny = (int)lrint(GetImage()->GetResolution().y());
+  const int nz = (int)lrint(GetImage()->GetResolution().z());
+  int ix = (int)lrint(i.x());
+  int iy = (int)lrint(i.y());
+  int iz = (int)lrint(i.z());
+  const G4ThreeVector & halfSize = GetImage()->GetHalfSize();
+
   //---------------------------------------------------------------
   // Ray tracing
 
@@ -897,6 +921,41 @@ G4double GateImageRegionalizedVolume::DistanceToOut(const G4ThreeVector& p,
     use_dmap = true;
     */
 
+    // Homogeneous macro-voxel of the region: cross it in one step
+    if (mMacroVoxelSize > 1 && mMacroVoxelMap.GetBlockLabel(ix, iy, iz) == label) {
+      const int n = mMacroVoxelSize;
+      const int bx = (ix/n)*n, ex = std::min(bx+n, nx);
+      const int by = (iy/n)*n, ey = std::min(by+n, ny);
+      const int bz = (iz/n)*n, ez = std::min(bz+n, nz);
+      G4double tbx(1e30),tby(1e30),tbz(1e30);
+      if (dx>0) tbx = (ex*vox.x() - halfSize.x() - posx) / v.x();
+      else if (dx<0) tbx = (bx*vox.x() - halfSize.x() - posx) / v.x();
+      if (dy>0) tby = (ey*vox.y() - halfSize.y() - posy) / v.y();
+      else if (dy<0) tby = (by*vox.y() - halfSize.y() - posy) / v.y();
+      if (dz>0) tbz = (ez*vox.z() - halfSize.z() - posz) / v.z();
+      else if (dz<0) tbz = (bz*vox.z() - halfSize.z() - posz) / v.z();
+      G4double t;
+      if (tbx < tby && tbx < tbz) { t = tbx; last_step = 0; }
+      else if (tby < tbz) { t = tby; last_step = 1; }
+      else { t = tbz; last_step = 2; }
+      posx += t * v.x();
+      posy += t * v.y();
+      posz += t * v.z();
+
+      // Next voxel : across the exit face of the block, inside the
+      // block along the other axes
+      if (last_step == 0) ix = (dx>0 ? ex : bx-1);
+      else ix = std::max(bx, std::min(ex-1, (int)floor((posx + halfSize.x())/vox.x())));
+      if (last_step == 1) iy = (dy>0 ? ey : by-1);
+      else iy = std::max(by, std::min(ey-1, (int)floor((posy + halfSize.y())/vox.y())));
+      if (last_step == 2) iz = (dz>0 ? ez : bz-1);
+      else iz = std::max(bz, std::min(ez-1, (int)floor((posz + halfSize.z())/vox.z())));
+      index = ix + iy*GetImage()->GetLineSize() + iz*GetImage()->GetPlaneSize();
+      ppx = (ix + (dx>0 ? 1 : 0))*vox.x() - halfSize.x();
+      ppy = (iy + (dy>0 ? 1 : 0))*vox.y() - halfSize.y();
+      ppz = (iz + (dz>0 ? 1 : 0))*vox.z() - halfSize.z();
+    }
+    else {
     // compute t
     if (dx!=0) tx = (ppx - posx) / v.x();
     if (dy!=0) ty = (ppy - posy) / v.y();
@@ -910,6 +969,7 @@ G4double GateImageRegionalizedVolume::DistanceToOut(const G4ThreeVector& p,
 	posz += tx * v.z();
 	index += dindexx;
 	ppx += dppx;
+	ix += dindexx;
       }
       else {
 	last_step = 2;
@@ -918,6 +978,7 @@ G4double GateImageRegionalizedVolume::DistanceToOut(const G4ThreeVector& p,
 	posz += tz * v.z();
 	index += dindexz;
 	ppz += dppz;
+	iz += (int)dz;
       }
     }
     //
@@ -929,6 +990,7 @@ G4double GateImageRegionalizedVolume::DistanceToOut(const G4ThreeVector& p,
 	posz += ty * v.z();
 	index += dindexy;
 	ppy += dppy;
+	iy += (int)dy;
       }
       else {
 	last_step = 2;
@@ -937,10 +999,15 @@ G4double GateImageRegionalizedVolume::DistanceToOut(const G4ThreeVector& p,
 	posz += tz * v.z();
 	index += dindexz;
 	ppz += dppz;
+	iz += (int)dz;
       }
     }
+    } // macro-voxel
     //	 } // use dmap
 
+    // Out of the image (the position test below may miss it by rounding)
+    if (ix < 0 || ix >= nx || iy < 0 || iy >= ny || iz < 0 || iz >= nz) stop = true;
+
     nbStep++;
     if (nbStep > 1000) {
       //GateError("nbStep > 1000");
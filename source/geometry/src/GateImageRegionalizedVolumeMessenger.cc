@@ -27,6 +27,10 @@ GateImageRegionalizedVolumeMessenger::GateImageRegionalizedVolumeMessenger(GateI
   G4String n = GetDirectoryName() +"geometry/distanceMap";
   pDistanceMapNameCmd = new G4UIcmdWithAString(n,this);
   pDistanceMapNameCmd->SetGuidance("Sets the name of the distance map file");
+
+  n = GetDirectoryName() +"geometry/setMacroVoxelSize";
+  pMacroVoxelSizeCmd = new G4UIcmdWithAnInteger(n,this);
+  pMacroVoxelSizeCmd->SetGuidance("Size (in voxels) of the homogeneous blocks crossed in one step during navigation (default 8, 0 to disable)");
 }
 //====================================================================
 
@@ -36,6 +40,7 @@ GateImageRegionalizedVolumeMessenger::~GateImageRegionalizedVolumeMessenger()
 {
   GateMessage("Volume",5,"~GateImageRegionalizedVolumeMessenger()\n");
   delete  pDistanceMapNameCmd;
+  delete  pMacroVoxelSizeCmd;
 }
 //====================================================================
 
@@ -51,6 +56,9 @@ void GateImageRegionalizedVolumeMessenger::SetNewValue(G4UIcommand* command,
   if (command == pDistanceMapNameCmd) {
     pVolume->SetDistanceMapFilename(newValue);
   }
+  else if (command == pMacroVoxelSizeCmd) {
+    pVolume->SetMacroVoxelSize(pMacroVoxelSizeCmd->GetNewIntValue(newValue));
+  }
   else {
     GateVImageVolumeMessenger::SetNewValue(command,newValue);
   }
@@ -24,16 +24,18 @@
 #include "GateTokenizer.hh"
 #include "GateTools.hh"
 
+#include <fstream>
+#include <set>
+
 char GateMDBFile::theStarterSeparator = ':';
 char GateMDBFile::theFieldSeparator   = ';';
 G4String GateMDBFile::theReadItemErrorMsg = "Item not found";
 
-#define GATE_BUFFERSIZE 256
-
 //-----------------------------------------------------------------------------
 GateMDBFile::GateMDBFile(GateMaterialDatabase* db, const G4String& itsFileName)
   :mDatabase(db), 
-   fileName(itsFileName),filePath("")
+   fileName(itsFileName),filePath(""),
+   mCurrentLine(0)
 {
   GateMessage("Materials", 1, 
 	      "GateMDBFile: I start looking for the material database file <"
@@ -44,17 +46,7 @@ GateMDBFile::GateMDBFile(GateMaterialDatabase* db, const G4String& itsFileName)
 		G4String msg = "Could not find material database file '" + fileName + "'";
     G4Exception( "GateMDBFile::GateMDBFile", "GateMDBFile", FatalException, msg );
 	}
-  dbStream.open(filePath);
-
-  if (dbStream) {
-    GateMessage("Materials", 2, 
-		"OK, I opened the material database <" 
-		<< filePath << ">\n");
-  }
-  else {
-		G4String msg = "Could not open material database file '" + filePath + "'";
-    G4Exception( "GateMDBFile::GateMDBFile", "GateMDBFile", FatalException, msg );
-  }
+  LoadFile();
 }
 //-----------------------------------------------------------------------------
 
@@ -63,7 +55,6 @@ GateMDBFile::GateMDBFile(GateMaterialDatabase* db, const G4String& itsFileName)
 //-----------------------------------------------------------------------------
 GateMDBFile::~GateMDBFile()
 {
-  dbStream.close();
 }
 //-----------------------------------------------------------------------------
 
@@ -402,88 +393,71 @@ void GateMDBFile::ReadMaterialOption(const G4String& materialName,const G4String
 
 
 //-----------------------------------------------------------------------------
-// Go through the whole file until we find a specific section
-// The section name we'll look for is "[name]"
-void GateMDBFile::FindSection(const G4String& name)
+// Reads the whole DB file and indexes the items of each section.
+// The lookups give the same result as a scan of the file: only the
+// first [section] header of a name is used, a section ends at the next
+// line starting with '[', and the first definition of an item wins.
+void GateMDBFile::LoadFile()
 {
-  if (LookForText("[" + name + "]")==false) {
-    /*   G4Exception("\n!!! GateMDBFile["+fileName+"]::FindSection:   \n"
-	 "\tI could not find any section [" + name + "] in the material database file. \n"
-	 "\tYou should check the database file.\n"
-	 "\tComputation aborted!!!\n");
-    */ }
-
-}
-//-----------------------------------------------------------------------------
+  std::ifstream dbStream(filePath.c_str());
+  if (!dbStream) {
+		G4String msg = "Could not open material database file '" + filePath + "'";
+    G4Exception( "GateMDBFile::LoadFile", "GateMDBFile", FatalException, msg );
+    return;
+  }
 
+  std::set<G4String> sections;
+  G4String section;
+  G4bool inSection = false;
+  std::string rawLine;
+  while (std::getline(dbStream,rawLine)) {
+    G4String lineBuf = rawLine;
+
+    // Section header, at the beginning of the line
+    G4bool isHeader = false;
+    if (rawLine.length() && rawLine.at(0)=='[') {
+      std::string::size_type end = rawLine.find(']');
+      if (end != std::string::npos) {
+        section = rawLine.substr(1,end-1);
+        inSection = sections.insert(section).second;
+        isHeader = true;
+      }
+    }
 
-//-----------------------------------------------------------------------------
-// Go through the whole DB file from the start
-// until we find a specific text (at beginning of line)
-// Once the text is found, we're positioned just below the text's line
-G4bool GateMDBFile::LookForText(const G4String& text)
-{
-  G4int len = text.length() ;
-  G4String lineBuf;
-
-  if (dbStream.fail()) {
-    dbStream.close();
-    dbStream.clear();  
-    dbStream.open(fileName);
-    if (!dbStream) {
-      std::cerr << "ERROR Could not reopen " << fileName << Gateendl;
-      exit(0);
+    GateTokenizer::CleanUpString(lineBuf);
+    if (lineBuf=="") continue;
+
+    if (!isHeader) {
+      if (lineBuf.at(0)=='[')
+        inSection = false; // Reached next section
+      else if (inSection) {
+        // The item name is the text before the colon
+        G4String::size_type pos = lineBuf.find(theStarterSeparator);
+        if (pos != G4String::npos)
+          mItemIndex.insert(std::make_pair("[" + section + "]" + lineBuf.substr(0,pos), mLines.size()));
+      }
     }
+    mLines.push_back(lineBuf);
   }
 
-  dbStream.seekg(0,std::ios::beg);  // Rewind!
-  
-
-  while (!dbStream.eof()) {
-    if (ReadLine(lineBuf)) return false; // Error or EOF
-   
-    if ( strncmp(text.c_str(),lineBuf.c_str(),len)==0 )
-      return true;// Line starts with the text we're looking for
-  }
-  return false;
+  GateMessage("Materials", 2, 
+	      "OK, I read the material database <" 
+	      << filePath << "> (" << mItemIndex.size() << " items)\n");
 }
 //-----------------------------------------------------------------------------
 
 
 
 //-----------------------------------------------------------------------------
-// Goes into a specific section of the DB file, then looks
-// for a specific item.
-// If the item is "Item", the routine will look through the
-// sectoin until it finds a line starting with "Item:"
+// Looks for a specific item in a section of the DB file.
+// If the item is "Item", this is the first line of the section
+// starting with "Item:". The next calls to ReadNonEmptyLine read
+// the lines below this one.
 G4String GateMDBFile::ReadItem(const G4String& sectionName,const G4String& itemName)
 {
+  std::unordered_map<std::string,size_t>::const_iterator it = mItemIndex.find("[" + sectionName + "]" + itemName);
 
-  
-  // Go in the relevant section of the DB file
-  FindSection(sectionName);
-  
-  // Prepare the lookup variables and buffer
-  G4bool flagElementFound=false;
-  G4String text = itemName + ":" ;
-  G4int len = text.length() ;
-  G4String lineBuf;
-  
-   
-  do {	// Read lines until we find the item or reach the OEF or the next section
-    if (ReadNonEmptyLine(lineBuf)) 
-      break;   // Reached EOF or read-error
-    if (lineBuf.at(0)=='[') 
-      break; // Reached next section
-    //if ( text.compare(lineBuf,0,len) == 0 ) {
-    if ( strncmp(text.c_str(),lineBuf.c_str(),len) == 0 ) {
-      // We found the item we were looking for  
-      flagElementFound = true;
-      break;
-    }
-  } while (1);
-
-  if (!flagElementFound) {  // We reached the EOF or the next section
+  if (it == mItemIndex.end()) {  // Not in the section
     // GateMessage("Materials", 3, "GateMDBFile<" << fileName
     // 		<< ">::ReadItem: I could NOT find the item '"
     // 		<< itemName << "' in section ["
@@ -497,7 +471,8 @@ G4String GateMDBFile::ReadItem(const G4String& sectionName,const G4String& itemN
 	      << sectionName << "] of the material database. \n\n");
 
   // We found the item: we return the text after the colon
-  return lineBuf.substr(len);
+  mCurrentLine = it->second + 1;
+  return mLines[it->second].substr(itemName.length()+1);
 }
 //-----------------------------------------------------------------------------
 
@@ -508,32 +483,9 @@ G4String GateMDBFile::ReadItem(const G4String& sectionName,const G4String& itemN
 // Returns 0 if everything went OK, 1 if there was any failure (including EOF) 
 G4int GateMDBFile::ReadNonEmptyLine(G4String& lineBuffer)
 {
-  do {
-    if (ReadLine(lineBuffer))  
-      return 1;
-    GateTokenizer::CleanUpString(lineBuffer);
-  } while (lineBuffer=="");
-
-  return 0;
-}
-//-----------------------------------------------------------------------------
-
-
-
-//-----------------------------------------------------------------------------
-// Reads the next line from the DB file, and stores it
-// in the string
-// Returns 0 if everything went OK, 1 if there was any failure (including EOF) 
-G4int GateMDBFile::ReadLine(G4String& lineBuffer)
-{
-  static char buffer[GATE_BUFFERSIZE];
-
-  dbStream.getline(buffer,GATE_BUFFERSIZE);
-  if (dbStream.eof())  
+  if (mCurrentLine >= mLines.size())
     return 1;
-  lineBuffer = G4String(buffer);
+  lineBuffer = mLines[mCurrentLine++];
   return 0;
 }
 //-----------------------------------------------------------------------------
-
-
@@ -15,6 +15,11 @@
 #define GATESDM_CC
 
 #include "GateMultiSensitiveDetector.hh"
+#include "GateConfiguration.h"
+
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+#endif
 
 //-----------------------------------------------------------------------------
 GateMultiSensitiveDetector::GateMultiSensitiveDetector(G4String name)
@@ -22,6 +27,7 @@ GateMultiSensitiveDetector::GateMultiSensitiveDetector(G4String name)
 {
   pSensitiveDetector = 0;
   pMultiFunctionalDetector = 0;
+  mHasSharedActor = false;
 }
 //-----------------------------------------------------------------------------
 
@@ -80,6 +86,14 @@ void GateMultiSensitiveDetector::PrintAll()
 G4bool GateMultiSensitiveDetector::ProcessHits(G4Step* aStep, G4TouchableHistory*)
 {
   if(pSensitiveDetector) pSensitiveDetector->Hit(aStep);
+#ifdef GATE_USE_MT
+  // Actors shared by the worker threads are called by one thread at a time
+  if(pMultiFunctionalDetector && mHasSharedActor) {
+    G4AutoLock lock(GateActorManager::GetSharedActorMutex());
+    pMultiFunctionalDetector->Hit(aStep);
+    return true;
+  }
+#endif
   if(pMultiFunctionalDetector) pMultiFunctionalDetector->Hit(aStep);
   return true;
 }
@@ -101,6 +115,7 @@ void GateMultiSensitiveDetector::SetActor(GateVActor * actor)
   if(actor->GetNumberOfFilters()!=0)
     actor->SetFilter(actor->GetFilterManager());
   pMultiFunctionalDetector ->RegisterPrimitive(actor);
+  if(actor->IsSharedBetweenThreads() && !actor->IsThreadSafe()) mHasSharedActor = true;
 }
 //-----------------------------------------------------------------------------
 
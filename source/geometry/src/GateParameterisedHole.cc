@@ -139,4 +139,5 @@ void GateParameterisedHole::ConstructOwnPhysicalVolume(G4bool flagUpdateOnly)
     // Store it into the physical volume vector
     PushPhysicalVolume(physicalVolume);
   }
+  else SetOwnPlacementsTracked();
 }
@@ -46,6 +46,7 @@ void GateRegularParam::ConstructOwnPhysicalVolume(G4bool flagUpdate)
 
   // For the update case; there is nothing to do here.
   if (flagUpdate) {
+    SetOwnPlacementsTracked();
     if (itsInserter->GetVerbosity()>=1) {
       G4cout << "---- Exiting GateRegularParam::ConstructOwnPhysicalVolumes ..."
              << Gateendl
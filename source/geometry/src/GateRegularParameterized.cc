@@ -301,6 +301,12 @@ void GateRegularParameterized::ConstructOwnPhysicalVolume(G4bool flagUpdateOnly)
     //----------------------------------------------------------------
     pOwnPhys = GetPhysicalVolume(copyNumber);
 
+    // Placements which did not change are left untouched
+    if (IsPlacementUnchanged(pOwnPhys, rotationMatrix, position)) {
+      delete newRotationMatrix;
+      continue;
+    }
+
     // Set the translation vector for this physical volume
     pOwnPhys->SetTranslation(position);
 
@@ -309,6 +315,7 @@ void GateRegularParameterized::ConstructOwnPhysicalVolume(G4bool flagUpdateOnly)
       delete pOwnPhys->GetRotation();
 
     pOwnPhys->SetRotation(newRotationMatrix);
+    AddMovedPhysicalVolume(pOwnPhys);
 
     GateMessage("Geometry", 3,"@  " << GetPhysicalVolumeName() << " has been updated.\n";);
 
@@ -323,5 +330,7 @@ void GateRegularParameterized::ConstructOwnPhysicalVolume(G4bool flagUpdateOnly)
   }
 
   }//end for
+
+  SetOwnPlacementsTracked();
 }
 //----------------------------------------------------------------------------------------
@@ -14,18 +14,24 @@
 
 #include <pthread.h>
 #include <set>
+#include <sstream>
+#include <iomanip>
 
 #include "GateVImageVolume.hh"
 #include "GateMiscFunctions.hh"
 #include "GateMessageManager.hh"
 #include "GateDetectorConstruction.hh"
-#include "GateDMapVol.h"
-#include "GateDMaplongvol.h"
-#include "GateDMapdt.h"
+#include "GateImageDistanceTransform.hh"
 #include "GateHounsfieldMaterialTable.hh"
+#include "metaImage.h"
 #include <G4TransportationManager.hh>
 #include "globals.hh"
 
+#ifdef GATE_USE_MT
+#include "G4AutoLock.hh"
+namespace { G4Mutex labelImageMutex = G4MUTEX_INITIALIZER; }
+#endif
+
 typedef unsigned int uint;
 
 //--------------------------------------------------------------------
@@ -39,6 +45,9 @@ GateVImageVolume::GateVImageVolume( const G4String& name,G4bool acceptsChildren,
   GateMessageInc("Volume",5,"Begin GateVImageVolume("<<name<<")\n");
   mImageFilename="";
   pImage=0;
+  mCompactLineSize = 0;
+  mCompactPlaneSize = 0;
+  mIsLabelImageReleased = false;
   mHalfSize = G4ThreeVector(0,0,0);
   mIsoCenterIsSetByUser = false;
   mIsoCenterRotationFlag = false;
@@ -199,6 +208,8 @@ void GateVImageVolume::LoadImage(bool add1VoxelMargin)
   GateMessageInc("Volume",4,"Begin GateVImageVolume::LoadImage("<<mImageFilename<<")\n");
 
   ImageType* tmp = new ImageType;
+  // The margin is added in place, without copying the image
+  if (add1VoxelMargin) tmp->ReserveMargin(1);
 
   if (mImageFilename == "test1" ) {
     // Creates a 32x32x32 image of size 20x20x20 cm3
@@ -243,32 +254,12 @@ void GateVImageVolume::LoadImage(bool add1VoxelMargin)
 
   if (pImage) delete pImage;
 
+  pImage = tmp;
+  mIsLabelImageReleased = false;
+  pImage->SetOutsideValue( pImage->GetMinValue() - 1 );
   if (add1VoxelMargin) {
-    // The image is copied with a margin of 1 voxel in all directions
-    pImage = new ImageType;
-
-    G4ThreeVector res (tmp->GetResolution().x() + 2,
-                       tmp->GetResolution().y() + 2,
-                       tmp->GetResolution().z() + 2);
-    pImage->SetResolutionAndVoxelSize(res,tmp->GetVoxelSize());
-    pImage->SetOrigin(tmp->GetOrigin());
-    pImage->SetTransformMatrix(tmp->GetTransformMatrix());
-    pImage->Allocate();
-    //pImage->Fill(-1);
-    pImage->SetOutsideValue( tmp->GetMinValue() - 1 );
-    pImage->Fill(pImage->GetOutsideValue() );
-
-    int i,j,k;
-    for (k=0;k<res.z()-2;k++)
-      for (j=0;j<res.y()-2;j++)
-        for (i=0;i<res.x()-2;i++)
-          pImage->SetValue(i+1,j+1,k+1,tmp->GetValue(i,j,k));
-
-    delete tmp;
-  }
-  else {
-    pImage = tmp;
-    pImage->SetOutsideValue( pImage->GetMinValue() - 1 );
+    // Margin of 1 voxel in all directions, the origin is unchanged
+    pImage->AddMargin(1, pImage->GetOutsideValue());
   }
 
   // Set volume origin from the image origin
@@ -724,6 +715,62 @@ void GateVImageVolume::BuildLabelToG4MaterialVector( std::vector<G4Material*>& M
 }
 //--------------------------------------------------------------------
 
+//--------------------------------------------------------------------
+/// Builds the compact (8 or 16 bits) copy of the label image
+void GateVImageVolume::BuildCompactLabelImage()
+{
+  GateMessage("Volume",4,"Begin GateVImageVolume::BuildCompactLabelImage\n");
+  const int nbOfLabels = mLabelToMaterialName.size();
+  if (nbOfLabels > 65536) {
+    GateError("Image volume " << GetObjectName() << " has " << nbOfLabels
+              << " labels, the maximum is 65536.");
+  }
+  RestoreLabelImage();
+  mCompactLineSize = pImage->GetLineSize();
+  mCompactPlaneSize = pImage->GetPlaneSize();
+  mCompactLabels8.clear();
+  mCompactLabels16.clear();
+  ImageType::const_iterator i;
+  if (nbOfLabels <= 256) {
+    mCompactLabels8.reserve(pImage->GetNumberOfValues());
+    for (i=pImage->begin(); i!=pImage->end(); ++i) mCompactLabels8.push_back((uint8_t)(LabelType)(*i));
+  }
+  else {
+    mCompactLabels16.reserve(pImage->GetNumberOfValues());
+    for (i=pImage->begin(); i!=pImage->end(); ++i) mCompactLabels16.push_back((uint16_t)(LabelType)(*i));
+  }
+  GateMessage("Volume",4,"End GateVImageVolume::BuildCompactLabelImage: " << nbOfLabels << " labels, "
+              << (nbOfLabels <= 256 ? 8 : 16) << " bits per voxel\n");
+}
+//--------------------------------------------------------------------
+
+//--------------------------------------------------------------------
+void GateVImageVolume::ReleaseLabelImage()
+{
+  if (!pImage || (mCompactLabels8.empty() && mCompactLabels16.empty())) return;
+  pImage->ReleaseData();
+  mIsLabelImageReleased.store(true, std::memory_order_release);
+  GateMessage("Volume",4,"GateVImageVolume::ReleaseLabelImage: float labels of "
+              << GetObjectName() << " released\n");
+}
+//--------------------------------------------------------------------
+
+//--------------------------------------------------------------------
+void GateVImageVolume::RestoreLabelImage() const
+{
+#ifdef GATE_USE_MT
+  G4AutoLock lock(&labelImageMutex);
+#endif
+  if (!mIsLabelImageReleased.load(std::memory_order_acquire)) return;
+  pImage->Allocate();
+  const int n = pImage->GetNumberOfValues();
+  for (int i=0; i<n; i++) pImage->SetValue(i, GetCompactLabel(i));
+  mIsLabelImageReleased.store(false, std::memory_order_release);
+  GateMessage("Volume",4,"GateVImageVolume::RestoreLabelImage: float labels of "
+              << GetObjectName() << " restored\n");
+}
+//--------------------------------------------------------------------
+
 //--------------------------------------------------------------------
 /// Remaps the labels form 0 to NbLabels-1. If marginAdded is true
 /// then assigns the new label 0 to the label -1 which was created for
@@ -825,86 +872,72 @@ void GateVImageVolume::SetBuildDistanceTransfoFilename(G4String filename)
 //--------------------------------------------------------------------
 
 //--------------------------------------------------------------------
-void GateVImageVolume::BuildDistanceTransfo()
+/// Description written in the header of the distance map: version of
+/// the map (units) and FNV-1a hash of the label image. The map only
+/// depends on the labels, so the image, the HU or range tables (and
+/// their tolerance) and the material database are checked through them.
+std::string GateVImageVolume::GetDistanceTransfoDescription() const
 {
-  GateMessage("Geometry", 1, "Building distante map image (dmap) for the image '"
-              << mImageFilename << "' (it could be long for large image)."
-              << Gateendl);
-
-  // TEMPORARY : need isotrop !
-  if ((pImage->GetVoxelSize().x() !=
-       pImage->GetVoxelSize().y()) &&
-      (pImage->GetVoxelSize().x() !=
-       pImage->GetVoxelSize().z())) {
-    GateError("Error : image spacing should be isotropic for building dmap");
-    exit(0);
-  }
-
-  // Convert (copy) image into Vol structure
-  const G4ThreeVector & size = pImage->GetResolution();
-  GateMessage("Geometry", 1, "Image size is " << size << ".\n");
-  Vol v((int)lrint(size.x()),
-        (int)lrint(size.y()),
-        (int)lrint(size.z()), 0);
-  v.setVolumeCenter( v.sizeX()/2, v.sizeY()/2, v.sizeZ()/2 );
-  voxel * p = v.getDataPointer();
-  GateImage::const_iterator iter = pImage->begin();
-  while (iter != pImage->end()) {
-    /*
-      if ((*iter < 0) || (*iter > 255)) //FIXME
-      {
-      GateError("Error image value not uchar =" << *iter << Gateendl);
-      }
-    */
-    *p = static_cast<voxel>(lrint(*iter));
-    ++p;
-    ++iter;
+  unsigned long long hash(14695981039346656037ULL);
+  std::vector<double> geometry;
+  for(int i=0; i<3; i++) {
+    geometry.push_back(pImage->GetResolution()[i]);
+    geometry.push_back(pImage->GetVoxelSize()[i]);
   }
-
-  //   GateDebugMessage("Geometry", 0, "im val = " << pImage->GetValue(22, 54, 34) << Gateendl);
-  //   GateDebugMessage("Geometry", 0, "vo val = " << (float)v.get(22, 54, 34) << Gateendl);
-
-  if (!v.isOK()) {
-    fprintf( stderr, "Error construction vol ?");
-    exit(0);
+  const unsigned char * bytes = (const unsigned char *)&geometry[0];
+  for(size_t i=0; i<geometry.size()*sizeof(double); i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
   }
-
-  // Creating the longvol tmpOutput structure
-  Longvol tmpOutput(v.sizeX(),v.sizeY(),v.sizeZ(),0);
-  if (!tmpOutput.isOK()) {
-    fprintf( stderr, "Couldn't init the longvol structure !\n" );
-    exit(0);
+  bytes = (const unsigned char *)&(pImage->begin()[0]);
+  const size_t n = pImage->GetNumberOfValues()*sizeof(*pImage->begin());
+  for(size_t i=0; i<n; i++) {
+    hash ^= bytes[i];
+    hash *= 1099511628211ULL;
   }
+  std::ostringstream os;
+  os << "GateDistanceMap 2 mm labels " << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return os.str();
+}
+//--------------------------------------------------------------------
 
-  // Each volume center is (0,0,0)x(sizeX,sizeY,sizeZ)
-  tmpOutput.setVolumeCenter( tmpOutput.sizeX()/2, tmpOutput.sizeY()/2, tmpOutput.sizeZ()/2 );
+//--------------------------------------------------------------------
+/// The distance map is up to date if it is a mhd image whose header
+/// has the description of the current labels (maps written by older
+/// versions, in other units, have none)
+bool GateVImageVolume::IsDistanceTransfoUpToDate(const std::string & description) const
+{
+  if (getExtension(mDistanceTransfoOutput) != "mhd") return false;
+  std::ifstream is(mDistanceTransfoOutput.c_str());
+  if (!is) return false;
+  is.close();
+  MetaImage header;
+  if (!header.Read(mDistanceTransfoOutput.c_str(), false)) return false;
+  return description == header.Comment();
+}
+//--------------------------------------------------------------------
 
-  GateMessage("Geometry", 4, "Input Vol size: "<<
-              tmpOutput.sizeX()<<"x"<<tmpOutput.sizeY()<<"x"<< tmpOutput.sizeZ()<< Gateendl);
+//--------------------------------------------------------------------
+void GateVImageVolume::BuildDistanceTransfo()
+{
+  const std::string description = GetDistanceTransfoDescription();
+  if (IsDistanceTransfoUpToDate(description)) {
+    GateMessage("Geometry", 1, "Distance map '" << mDistanceTransfoOutput
+                << "' was built from the same labels, it is not computed again." << Gateendl);
+    return;
+  }
 
-  // Go ?
-  GateMessage("Geometry", 4, "Start distance map computation ...\n");
-  bool b = computeSEDT(v, tmpOutput, true, false, 1);
-  GateMessage("Geometry", 4, "End ! b = " << b << Gateendl);
+  GateMessage("Geometry", 1, "Building distance map image (dmap) for the image '"
+              << mImageFilename << "'." << Gateendl);
+  GateMessage("Geometry", 1, "Image size is " << pImage->GetResolution()
+              << ", spacing is " << pImage->GetVoxelSize() << ".\n");
 
-  // Convert (copy) image from Vol structure into GateImage
-  GateDebugMessage("Geometry", 4, "Convert and output\n");
   GateImage output;
-  output.SetResolutionAndHalfSize(pImage->GetResolution(), pImage->GetHalfSize());
-  output.SetOrigin(pImage->GetOrigin());
-  output.Allocate();
-  double spacingFactor = pImage->GetVoxelSize().x();
-  GateImage::iterator it = output.begin();
-  lvoxel * pp = tmpOutput.getDataPointer();
-  while (it < output.end()) {
-    *it = (float)sqrt(*pp * spacingFactor);
-    ++pp;
-    ++it;
-  }
+  GateImageDistanceTransform transform;
+  transform.Compute(*pImage, output);
 
   // Dump final result ...
-  output.Write(mDistanceTransfoOutput);
+  output.Write(mDistanceTransfoOutput, description);
   GateMessage("Geometry", 1, "Distance map write to disk in the file '" << mDistanceTransfoOutput << "'.\n");
-  GateMessage("Geometry", 1, "You can now use it in the simulation. Use the macro 'distanceMap'. The macro 'buildAndDumpDistanceTransfo' is no more needed.\n");
 }
 //--------------------------------------------------------------------
@@ -79,6 +79,7 @@ GateVImageVolumeMessenger::GateVImageVolumeMessenger(GateVImageVolume* volume)
   pBuildDistanceTransfoCmd = 0;
   pBuildDistanceTransfoCmd = new G4UIcmdWithAString(n,this);
   pBuildDistanceTransfoCmd->SetGuidance("Build and dump the distance transfo into the given filename.");
+  pBuildDistanceTransfoCmd->SetGuidance("The file (mhd) is reused if it was built from the same label image.");
 
   n = dir +"/buildAndDumpLabeledImage";
   pBuildLabeledImageCmd = 0;
@@ -53,6 +53,12 @@ const G4String GateVVolume::mTheSolidNameTag  	     = "_solid";
 const G4String GateVVolume::mTheLogicalVolumeNameTag   = "_log";
 //! Tag added to names to create physical volume names
 const G4String GateVVolume::mThePhysicalVolumeNameTag  = "_phys";
+// Incremented each time physical volumes are deleted
+G4int GateVVolume::mGeometryGeneration = 0;
+// Placements changed by the last update
+std::vector<G4VPhysicalVolume*> GateVVolume::mMovedPhysicalVolumes;
+G4bool GateVVolume::mAllMovesTracked = true;
+G4bool GateVVolume::mOwnPlacementsTracked = false;
 
 //---------------------------------------------------------------------------------------
 //Constucteur
@@ -163,6 +169,16 @@ void GateVVolume::SetOrigin(const G4ThreeVector & i)
 //--------------------------------------------------------------------
 
 
+//----------------------------------------------------------------------------------------
+// Forget the placements moved by the previous update
+void GateVVolume::ClearMovedPhysicalVolumes()
+{
+  mMovedPhysicalVolumes.clear();
+  mAllMovesTracked = true;
+}
+//----------------------------------------------------------------------------------------
+
+
 //----------------------------------------------------------------------------------------
 // Construct the world volume
 G4VPhysicalVolume* GateVVolume::Construct(G4bool flagUpdateOnly)
@@ -226,7 +242,13 @@ void GateVVolume::ConstructGeometry(G4LogicalVolume* mother_log, G4bool flagUpda
   // Construct all children
   pChildList->ConstructChildGeometry(pOwnLog, flagUpdateOnly);
 
+  mOwnPlacementsTracked = false;
   ConstructOwnPhysicalVolume(flagUpdateOnly);
+  // The override did not report which of its placements changed
+  if (flagUpdateOnly && !mOwnPlacementsTracked) {
+    GateMessage("Geometry", 4, GetObjectName() << " does not report its moved placements.\n");
+    mAllMovesTracked = false;
+  }
 
   GateMessage("Geometry", 7, " GateVVolume::ConstructGeometry -- end ; flagUpdateOnly = " << flagUpdateOnly << Gateendl;);
 
@@ -327,6 +349,13 @@ void GateVVolume::ConstructOwnPhysicalVolume(G4bool flagUpdateOnly)
       //----------------------------------------------------------------
       pOwnPhys = GetPhysicalVolume(copyNumber);
 
+      // Placements which did not change are left untouched, so that the
+      // optimisation of their mother is still valid
+      if (IsPlacementUnchanged(pOwnPhys, rotationMatrix, position)) {
+        delete newRotationMatrix;
+        continue;
+      }
+
       // Set the translation vector for this physical volume
       pOwnPhys->SetTranslation(position);
 
@@ -335,6 +364,7 @@ void GateVVolume::ConstructOwnPhysicalVolume(G4bool flagUpdateOnly)
         delete pOwnPhys->GetRotation();
 
       pOwnPhys->SetRotation(newRotationMatrix);
+      AddMovedPhysicalVolume(pOwnPhys);
 
       GateMessage("Geometry", 6, GetPhysicalVolumeName() << "[" << copyNumber << "] has been updated.\n";);
 
@@ -360,6 +390,20 @@ void GateVVolume::ConstructOwnPhysicalVolume(G4bool flagUpdateOnly)
 
   }//end for
 
+  SetOwnPlacementsTracked();
+
+}
+//----------------------------------------------------------------------------------------
+
+
+//----------------------------------------------------------------------------------------
+G4bool GateVVolume::IsPlacementUnchanged(const G4VPhysicalVolume* volume,
+                                         const G4RotationMatrix& rotationMatrix,
+                                         const G4ThreeVector& position)
+{
+  const G4RotationMatrix* oldRotationMatrix = volume->GetRotation();
+  G4bool sameRotation = oldRotationMatrix ? (*oldRotationMatrix == rotationMatrix) : rotationMatrix.isIdentity();
+  return sameRotation && volume->GetTranslation() == position;
 }
 //----------------------------------------------------------------------------------------
 
@@ -483,6 +527,7 @@ void GateVVolume::DestroyGeometry()
 
       // Destroy the physical volume
       delete lastVolume;
+      mGeometryGeneration++;
 
       // Remove the volume from the physical-volume vector
       theListOfOwnPhysVolume.erase(theListOfOwnPhysVolume.end()-1);
@@ -520,6 +565,7 @@ void GateVVolume::DestroyOwnPhysicalVolumes()
 
       // Destroy the physical volume
       delete lastVolume;
+      mGeometryGeneration++;
 
       // Remove the volume from the physical-volume vector
       theListOfOwnPhysVolume.erase(theListOfOwnPhysVolume.end()-1);
@@ -34,7 +34,10 @@ void GateVoxelBoxParam::ConstructOwnPhysicalVolume(G4bool flagUpdate){
   // G4cout << "GateVoxelBoxParam::ConstructOwnPhysicalVolumes - Entered, name "<< mName <<", flag "<< std::boolalpha << flagUpdate <<  Gateendl<<std::flush;
   
   // For the update case; there is nothing to do here.
-  if (flagUpdate) return;
+  if (flagUpdate) {
+    SetOwnPlacementsTracked();
+    return;
+  }
     
   DestroyGeometry();  
   
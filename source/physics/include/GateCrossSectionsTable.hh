@@ -56,6 +56,7 @@ class GateCrossSectionsTable: public G4PhysicsTable
 		G4double GetEnergyLimitForGivenMaxCrossSection(G4double crossSection) const;
 		void StoreTable ( std::ofstream& out, bool ascii ) const;
 		void RetrieveTable ( std::ifstream& in, bool ascii );
+		bool RetrieveProductionMaterialTable ( std::ifstream& in ); // binary table built for the current production cuts table
 
 		inline G4double GetCrossSection ( const G4Material*, G4double energy ) const;
 		inline G4double GetCrossSection ( const G4Material*, G4double energy, G4double density ) const;
@@ -92,6 +92,8 @@ public:
   void SetOptSplineFlag(G4bool val);
   RegionCutMapType & GetMapOfRegionCuts() { return mapOfRegionCuts; }
   G4double GetLowEdgeEnergy();
+  // Options the physics tables depend on (key of the GatePhysicsTableCache)
+  void DescribeTableOptions(std::ostream & os) const;
 
   std::vector<G4String> mListOfStepLimiter;
   std::vector<G4String> mListOfG4UserSpecialCut;
@@ -77,6 +77,7 @@ protected:
   G4UIcmdWithADoubleAndUnit * pMuHandlerSetAtomicShellEMin;
   G4UIcmdWithADoubleAndUnit * pMuHandlerSetAtomicShellTolerance;
   G4UIcmdWithADouble * pMuHandlerSetPrecision;
+  G4UIcmdWithAnInteger * pMuHandlerSetLookupBinsPerOctave;
 
   G4UIcommand * pAddAtomDeexcitation;
   G4UIcmdWithAString * pAddPhysicsList;
@@ -84,6 +85,7 @@ protected:
   G4UIcmdWithABool * pConstructProcessMixed;
 
   G4UIcmdWithADoubleAndUnit * pEnergyRangeMinLimitCmd;
+  G4UIcmdWithAString * pSetTableCacheDirectory;
 
 private:
   int nInit;
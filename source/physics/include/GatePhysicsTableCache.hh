@@ -0,0 +1,93 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+
+/*!
+  \class  GatePhysicsTableCache
+  \brief  Persistent cache of the physics tables, shared by the runs of
+  \brief  all the jobs using the same cache directory.
+
+  The tables are keyed by the FNV-1a hash of a description of what they
+  depend on (GetPhysicsDescription): Geant4 version, processes of each
+  particle, EM options, production cuts of the regions and composition
+  of the materials. Three kinds of tables are cached:
+
+  - the Geant4 tables (production cuts, EM dE/dx, range and lambda
+    tables), stored with G4VUserPhysicsList::StorePhysicsTable in the
+    directory g4tables_<hash> and retrieved by Geant4 at the next run
+    initialisation. Geant4 checks itself that the materials and the
+    cuts of the couples match, and builds the tables otherwise;
+  - the mu/mu_en tables simulated by the GateMaterialMuHandler;
+  - the cross-section tables of the fictitious tracking
+    (GateTotalDiscreteProcess).
+
+  Caching is off until a directory is set with
+  /gate/physics/setPhysicsTableCacheDirectory.
+*/
+
+#ifndef GATEPHYSICSTABLECACHE_HH
+#define GATEPHYSICSTABLECACHE_HH
+
+#include "globals.hh"
+#include <string>
+
+class G4VUserPhysicsList;
+
+class GatePhysicsTableCache
+{
+public:
+  static GatePhysicsTableCache * GetInstance() {
+    if (singleton == 0) singleton = new GatePhysicsTableCache;
+    return singleton;
+  }
+
+  void SetDirectory(G4String dir) { mDirectory = dir; }
+  G4String GetDirectory() const { return mDirectory; }
+  bool IsEnabled() const { return mDirectory != ""; }
+  /// New entries are stored by the master thread only: the worker threads
+  /// build the same tables
+  bool IsStoringEnabled() const;
+
+  /// Geant4 version, processes, EM options, cuts of the regions and
+  /// materials
+  std::string GetPhysicsDescription() const;
+  /// Materials and cuts of the couples of the production cuts table
+  /// (in the order of the couple indices)
+  std::string GetCouplesDescription() const;
+  /// FNV-1a hash of a description
+  static unsigned long long Hash(const std::string & description);
+  /// <directory>/<prefix>_<hash><suffix>
+  G4String GetFileName(const G4String & prefix, unsigned long long hash, const G4String & suffix = "") const;
+
+  /// Temporary name for a file written before being renamed to name, so
+  /// that a concurrent job never reads a partial cache (unique per process
+  /// and thread)
+  G4String GetTemporaryName(const G4String & name) const;
+  /// Renames tmpName to name (or removes tmpName on failure)
+  bool Commit(const G4String & tmpName, const G4String & name) const;
+
+  /// Geant4 tables: asks the physics list to retrieve them before the
+  /// run initialisation and stores them after it when they were built
+  void BeginRunInitialization(G4VUserPhysicsList * physicsList);
+  void EndRunInitialization(G4VUserPhysicsList * physicsList);
+
+private:
+  GatePhysicsTableCache();
+
+  bool IsTableDirectoryValid(const G4String & dir, const std::string & description) const;
+  void RemoveDirectory(const G4String & dir) const;
+
+  G4String mDirectory;
+  std::string mTableDescription;
+  G4String mTableDirectory;
+  bool mAreTablesRetrieved;
+
+  static GatePhysicsTableCache * singleton;
+};
+
+#endif /* end #define GATEPHYSICSTABLECACHE_HH */
@@ -63,6 +63,10 @@ class GatePulseProcessorChain : public GateModuleListManager
       GateVSystem *m_system;            //!< System to which the chain is attached
       G4String				   m_outputName;
       G4String                             m_inputName;
+
+      //! Profiling (see GateProfiler): one section per processor, created at the first event
+      void CreateProfilerSections();
+      std::vector<int>                     m_profilerSections;
 };
 
 #endif
@@ -30,9 +30,11 @@ See LICENSE.md for further details
 #include "G4ParticleMomentum.hh"
 #include <iomanip>
 #include <vector>
+#include <map>
 
 #include "GateVSource.hh"
 #include "GateSourcePhaseSpaceMessenger.hh"
+#include "GatePhaseSpaceBinaryFile.hh"
 
 //#include "GateRunManager.hh"
 
@@ -50,6 +52,7 @@ public:
   void Initialize();
   void GenerateROOTVertex( G4Event* );
   void GenerateIAEAVertex( G4Event* );
+  void GenerateBinaryVertex( G4Event* );
 
   G4int OpenIAEAFile(G4String file);
 
@@ -81,6 +84,8 @@ public:
 
   void SetStartingParticleId(long id) { mStartingParticleId = id; }
 
+  void SetUseRandomBlockOrder(bool b) { mUseRandomBlockOrder = b; }
+
 protected:
 
   TChain *T;
@@ -112,6 +117,7 @@ protected:
   float weight;
   //  char volumeName;
   char particleName[64];
+  char mLastParticleName[64];
   G4String mParticleTypeNameGivenByUser;
   float mParticleTime ;//m_source->GetTime();
   G4double mMomentum;
@@ -132,6 +138,11 @@ protected:
   iaea_record_type *pIAEARecordType;
   iaea_header_type *pIAEAheader;
 
+  GatePhaseSpaceBinaryReader * pBinaryReader;
+  bool mUseRandomBlockOrder;
+  std::map<G4int, G4ParticleDefinition*> mParticleDefinitionsByPDG;
+  G4ParticleDefinition * GetParticleDefinitionByPDG(G4int pdg);
+
   G4ParticleDefinition* pParticleDefinition;
   G4PrimaryParticle* pParticle;
   G4PrimaryVertex* pVertex;
@@ -50,6 +50,7 @@ private:
   G4UIcmdWithABool*          setUseNbParticleAsIntensityCmd;
   G4UIcmdWithADoubleAndUnit* setRmaxCmd;
   G4UIcmdWithAnInteger*      setStartIdCmd;
+  G4UIcmdWithABool*          setRandomBlockOrderCmd;
 };
 //----------------------------------------------------------------------------------------
 
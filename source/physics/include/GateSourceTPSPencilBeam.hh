@@ -27,6 +27,7 @@
 #include "GateSourcePencilBeam.hh"
 
 #include "CLHEP/Random/RandGeneral.h"
+#include "CLHEP/Random/RandBinomial.h"
 #include "CLHEP/RandomObjects/RandMultiGauss.h"
 #include "CLHEP/Random/RandGauss.h"
 #include "CLHEP/Matrix/Vector.h"
@@ -103,6 +104,8 @@ public:
 protected:
 
   void ConfigurePencilBeam();
+  void ComputeSpotOptics();
+  void AllocateSortedSpotPrimaries(CLHEP::HepRandomEngine * engine, long int ntotal);
   GateSourceTPSPencilBeamMessenger * pMessenger;
 
   bool mIsInitialized;
@@ -156,8 +159,15 @@ protected:
   std::vector<int> mSpotLayer; //in which layer is this spot?
   std::vector<double> mSpotEnergy;
   std::vector<double> mSpotWeight; // (proportional to) the expected number (for each bin in a multinomial distribution)
-  std::vector<int> mNbIonsToGenerate; // the actual number (for each bin in a multinomial distribution)
+  std::vector<long int> mNbIonsToGenerate; // the actual number (for each bin in a multinomial distribution)
   std::vector<G4ThreeVector> mSpotPosition, mSpotRotation;
+  //beam optics of each spot (clinical beam polynomials evaluated once at initialization)
+  struct SpotOptics {
+    double energy, sigmaEnergy;
+    double sigmaX, sigmaY, sigmaTheta, sigmaPhi;
+    double ellipseXThetaArea, ellipseYPhiArea;
+  };
+  std::vector<SpotOptics> mSpotOptics;
 };
 //------------------------------------------------------------------------------------------------------
 // vim: ai sw=2 ts=2 et
@@ -57,6 +57,10 @@ class GateTotalDiscreteProcess : public G4VDiscreteProcess
 		void CreateTotalMaxCrossSectionTable(const std::vector<G4Material*>&);
 
 		void BuildCrossSectionsTables();
+		// cross-section tables stored in the GatePhysicsTableCache directory
+		unsigned long long GetCrossSectionsCacheHash() const;
+		bool RetrieveCrossSectionsTables ( unsigned long long hash );
+		void StoreCrossSectionsTables ( unsigned long long hash ) const;
 
 		G4int m_nNumProcesses, m_nMaxNumProcesses;
 		bool m_nInitialized;
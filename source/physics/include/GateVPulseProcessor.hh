@@ -16,6 +16,7 @@ See LICENSE.md for further details
 #include "G4ThreeVector.hh"
 
 #include "GatePulse.hh"
+#include "GatePulseBatch.hh"
 #include "GateClockDependent.hh"
 
 class GatePulseProcessorChain;
@@ -48,6 +49,10 @@ class GatePulseProcessorChain;
       - The other option is to overload the method ProcessPulseList() (if the pulse-processing 
       	sequential mechanism provided by ProcessPulseList() is not appropriate. 
 	In that case, one should provide some dummy implementation (such as {;}) for ProcessOnePulse()
+      - A processor that only transforms or discards pulses independently of each other may also
+        overload ProcessPulseBatch() and return true from IsBatchProcessor(). ProcessPulseList()
+        then hands it the whole pulse-list as columns (GatePulseBatch), which can be processed with
+        plain loops. ProcessOnePulse() is still used when verbose print-outs are requested.
       	
       \sa GatePulseProcessorChainMessenger, GatePulse, GatePulseList
 */      
@@ -79,6 +84,13 @@ class GateVPulseProcessor : public GateClockDependent
     //! This function is called by ProcessPulseList() for each of the input pulses
     //! The result of the pulse-processing must be incorporated into the output pulse-list
     virtual void ProcessOnePulse(const GatePulse* inputPulse,GatePulseList& outputPulseList)=0;
+
+    //! Returns true if the processor implements ProcessPulseBatch()
+    virtual G4bool IsBatchProcessor() const { return false; }
+
+    //! Optional function for processing a whole pulse-list at once, stored as columns
+    //! Pulses to be discarded must have their 'keep' flag cleared
+    virtual void ProcessPulseBatch(GatePulseBatch& ) {}
     //@}
 
    
@@ -100,6 +112,7 @@ class GateVPulseProcessor : public GateClockDependent
      
   protected:
     GatePulseProcessorChain* m_chain;
+    GatePulseBatch m_batch;     //!< Columns reused by ProcessPulseList() for batch processors
 };
 
 
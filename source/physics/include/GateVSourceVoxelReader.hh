@@ -14,6 +14,7 @@
 #include <map>
 #include "globals.hh"
 #include "G4ThreeVector.hh"
+#include "GateAliasTable.hh"
 
 class GateVSource;
 class GateVSourceVoxelTranslator;
@@ -86,9 +87,11 @@ protected:
   G4String                       m_name;
   G4String                       m_fileName;
   GateVSource*                   m_source;
-  typedef std::map<G4double,G4int >  GateSourceIntegratedActivityMap;
   GateSourceActivityMap           m_sourceVoxelActivities;
-  GateSourceIntegratedActivityMap m_sourceVoxelIntegratedActivities;
+  // Voxels with a non-null activity, sampled with an alias table
+  std::vector<G4int>              m_sourceActiveVoxels;
+  std::vector<G4double>           m_sourceActiveVoxelActivities;
+  GateAliasTable                  m_sourceVoxelAliasTable;
   void PrepareIntegratedActivityMap();
   G4ThreeVector                  m_voxelSize;
   G4int							 m_voxelNx;
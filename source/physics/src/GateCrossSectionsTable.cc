@@ -338,7 +338,9 @@ void GateCrossSectionsTable::StoreTable ( std::ofstream& out, bool ascii ) const
 	}
 	else
 	{
-		out.write ( reinterpret_cast<const char*> ( &pParticleDefinition->GetParticleName() ), PARTICLE_NAME_LENGTH );
+		std::string name ( PARTICLE_NAME_LENGTH,'\0' );
+		pParticleDefinition->GetParticleName().copy ( &name[0],PARTICLE_NAME_LENGTH-1 );
+		out.write ( name.data(), PARTICLE_NAME_LENGTH );
 		out.write ( reinterpret_cast<const char*> ( &m_nMinEnergy ),sizeof ( m_nMinEnergy ) );
 		out.write ( reinterpret_cast<const char*> ( &m_nMaxEnergy ),sizeof ( m_nMaxEnergy ) );
 		out.write ( reinterpret_cast<const char*> ( &m_nPhysicsVectorBinNumber ),sizeof ( m_nPhysicsVectorBinNumber ) );
@@ -374,9 +376,9 @@ void GateCrossSectionsTable::RetrieveTable ( std::ifstream& in, bool ascii )
 	}
 	else
 	{
-		std::string name ( PARTICLE_NAME_LENGTH,'\0' );
-
-		in.read ( reinterpret_cast<char*> ( &name ), PARTICLE_NAME_LENGTH );
+		std::vector<char> buffer ( PARTICLE_NAME_LENGTH+1,'\0' );
+		in.read ( &buffer[0], PARTICLE_NAME_LENGTH );
+		std::string name ( &buffer[0] );
 		if ( name!=pParticleDefinition->GetParticleName() )
 		{
 			G4cout << "Try to Retrieve CrossSectionsTable for non-gamma! Particle panic!\n";
@@ -405,6 +407,31 @@ void GateCrossSectionsTable::RetrieveTable ( std::ifstream& in, bool ascii )
 
 }
 
+bool GateCrossSectionsTable::RetrieveProductionMaterialTable ( std::ifstream& in )
+{
+	const G4double minEnergy=m_nMinEnergy;
+	const G4double maxEnergy=m_nMaxEnergy;
+	const G4int binNumber=m_nPhysicsVectorBinNumber;
+	const G4ProductionCutsTable* table=G4ProductionCutsTable::GetProductionCutsTable ();
+	RetrieveTable ( in,false );
+	if ( in.fail() || length() !=table->GetTableSize () || m_nMinEnergy!=minEnergy || m_nMaxEnergy!=maxEnergy || m_nPhysicsVectorBinNumber!=binNumber )
+	{
+		clearAndDestroy();
+		m_oInvDensity.clear();
+		m_nMinEnergy=minEnergy;
+		m_nMaxEnergy=maxEnergy;
+		m_nPhysicsVectorBinNumber=binNumber;
+		return false;
+	}
+
+	// same material order as SetAndBuildProductionMaterialTable
+	pMaterialTableToProductionCutsTable->Update();
+	m_oMaterialVec.clear();
+	for ( size_t m=0; m<table->GetTableSize (); m++ )
+		m_oMaterialVec.push_back ( table->GetMaterialCutsCouple ( m )->GetMaterial() );
+	return CheckInternalProductionMaterialTable();
+}
+
 G4double GateCrossSectionsTable::GetEnergyLimitForGivenMaxCrossSection ( G4double crossSection ) const
 {
 	G4int i=0;
@@ -1273,6 +1273,15 @@ G4double GatePhysicsList::GetLowEdgeEnergy()
 }
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+void GatePhysicsList::DescribeTableOptions(std::ostream & os) const
+{
+  os << "EmOptions " << mDEDXBinning << ' ' << mLambdaBinning << ' '
+     << mEmin << ' ' << mEmax << ' ' << mSplineFlag << ' '
+     << mLowEnergyRangeLimit << '\n';
+}
+//-----------------------------------------------------------------------------
+
 //#endif
 //-----------------------------------------------------------------------------
 
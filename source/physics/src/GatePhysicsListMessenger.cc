@@ -12,6 +12,7 @@
 #include "GatePhysicsList.hh"
 #include "GatePhysicsListMessenger.hh"
 #include "GateMiscFunctions.hh"
+#include "GatePhysicsTableCache.hh"
 
 //----------------------------------------------------------------------------------------
 GatePhysicsListMessenger::GatePhysicsListMessenger(GatePhysicsList * pl)
@@ -56,11 +57,13 @@ GatePhysicsListMessenger::~GatePhysicsListMessenger()
   delete pMuHandlerSetENumber;
   delete pMuHandlerSetAtomicShellEMin;
   delete pMuHandlerSetPrecision;
+  delete pMuHandlerSetLookupBinsPerOctave;
 
   delete pAddAtomDeexcitation;
   delete pAddPhysicsList;
   delete pAddPhysicsListMixed;
   delete pAddProcessMixed;
+  delete pSetTableCacheDirectory;
 
 }
 //----------------------------------------------------------------------------------------
@@ -220,6 +223,11 @@ void GatePhysicsListMessenger::BuildCommands(G4String base)
   guidance = "Set precision to be reached in %";
   pMuHandlerSetPrecision->SetGuidance(guidance);
 
+  bb = base+"/MuHandler/setLookupBinsPerOctave";
+  pMuHandlerSetLookupBinsPerOctave = new G4UIcmdWithAnInteger(bb,this);
+  guidance = "Set the number of bins per octave of the resampled mu/muen lookup tables (0 to use the original tables)";
+  pMuHandlerSetLookupBinsPerOctave->SetGuidance(guidance);
+
   bb = base+"/addAtomDeexcitation";
   pAddAtomDeexcitation = new G4UIcommand(bb,this);
   guidance = "Add atom deexcitation into the energy loss table manager";
@@ -258,6 +266,13 @@ void GatePhysicsListMessenger::BuildCommands(G4String base)
   guid += "]";
   pEnergyRangeMinLimitCmd->SetGuidance(guid);
 
+  // Persistent cache of the physics tables
+  bb = base+"/setPhysicsTableCacheDirectory";
+  pSetTableCacheDirectory = new G4UIcmdWithAString(bb,this);
+  guidance = "Set the directory where the physics tables (Geant4 tables, simulated mu/muen tables, fictitious cross sections) are stored and retrieved by the next jobs with the same physics, cuts and materials";
+  pSetTableCacheDirectory->SetGuidance(guidance);
+  pSetTableCacheDirectory->SetParameterName("Directory",false);
+
 }
 //----------------------------------------------------------------------------------------
 
@@ -407,6 +422,11 @@ void GatePhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String param)
     nMuHandler->SetPrecision(val);
     GateMessage("Physic", 1, "(MuHandler Options) Precision set to "<<val<<". Precision defaut Value: 0.01\n");
   }
+  if(command == pMuHandlerSetLookupBinsPerOctave){
+    int nbVal = pMuHandlerSetLookupBinsPerOctave->GetNewIntValue(param);
+    nMuHandler->SetLookupBinsPerOctave(nbVal);
+    GateMessage("Physic", 1, "(MuHandler Options) Lookup bins per octave set to "<<nbVal<<". Defaut Value: 64\n");
+  }
 
   if (command == pAddAtomDeexcitation) {
     pPhylist->AddAtomDeexcitation();
@@ -432,6 +452,11 @@ void GatePhysicsListMessenger::SetNewValue(G4UIcommand* command, G4String param)
     GateMessage("Physic", 1, "Min Energy range set to "<<G4BestUnit(val,"Energy") << Gateendl);
   }
 
+  if (command == pSetTableCacheDirectory) {
+    GatePhysicsTableCache::GetInstance()->SetDirectory(param);
+    GateMessage("Physic", 1, "Physics table cache directory set to " << param << Gateendl);
+  }
+
 }
 //----------------------------------------------------------------------------------------
 
@@ -0,0 +1,270 @@
+/*----------------------
+  Copyright (C): OpenGATE Collaboration
+
+  This software is distributed under the terms
+  of the GNU Lesser General  Public Licence (LGPL)
+  See LICENSE.md for further details
+  ----------------------*/
+
+#include "GatePhysicsTableCache.hh"
+#include "GatePhysicsList.hh"
+#include "GateMessageManager.hh"
+
+#include "G4Version.hh"
+#include "G4VUserPhysicsList.hh"
+#include "G4ParticleTable.hh"
+#include "G4ProcessManager.hh"
+#include "G4ProcessVector.hh"
+#include "G4Material.hh"
+#include "G4IonisParamMat.hh"
+#include "G4Region.hh"
+#include "G4RegionStore.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4MaterialCutsCouple.hh"
+#include "G4Threading.hh"
+
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <dirent.h>
+#include <unistd.h>
+
+//-----------------------------------------------------------------------------
+GatePhysicsTableCache * GatePhysicsTableCache::singleton = 0;
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+GatePhysicsTableCache::GatePhysicsTableCache()
+{
+  mDirectory = "";
+  mTableDirectory = "";
+  mAreTablesRetrieved = false;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GatePhysicsTableCache::IsStoringEnabled() const
+{
+  return IsEnabled() && G4Threading::IsMasterThread();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+std::string GatePhysicsTableCache::GetPhysicsDescription() const
+{
+  std::ostringstream os;
+  os << std::setprecision(17);
+
+  // Geant4 version and EM data sets
+  const char * data = std::getenv("G4LEDATA");
+  os << "Geant4 " << G4VERSION_NUMBER << " " << (data ? data : "") << '\n';
+
+  // Processes of each particle
+  G4ParticleTable::G4PTblDicIterator * it = G4ParticleTable::GetParticleTable()->GetIterator();
+  it->reset();
+  while ((*it)()) {
+    G4ParticleDefinition * particle = it->value();
+    G4ProcessManager * manager = particle->GetProcessManager();
+    if (!manager) continue;
+    G4ProcessVector * processes = manager->GetProcessList();
+    os << particle->GetParticleName() << ':';
+    for (int i=0; i<manager->GetProcessListLength(); i++)
+      os << ' ' << (*processes)[i]->GetProcessName()
+         << '/' << (*processes)[i]->GetProcessType()
+         << '/' << (*processes)[i]->GetProcessSubType()
+         << '/' << manager->GetProcessActivation(i);
+    os << '\n';
+  }
+
+  // EM options and energy range of the production cuts
+  GatePhysicsList::GetInstance()->DescribeTableOptions(os);
+  os << "CutsEnergyRange " << G4ProductionCutsTable::GetProductionCutsTable()->GetLowEdgeEnergy()
+     << ' ' << G4ProductionCutsTable::GetProductionCutsTable()->GetHighEdgeEnergy() << '\n';
+
+  // Production cuts of the regions
+  G4RegionStore * regions = G4RegionStore::GetInstance();
+  for (size_t i=0; i<regions->size(); i++) {
+    const G4Region * region = (*regions)[i];
+    os << "Region " << region->GetName();
+    const G4ProductionCuts * cuts = region->GetProductionCuts();
+    if (cuts)
+      os << ' ' << cuts->GetProductionCut("gamma") << ' ' << cuts->GetProductionCut("e-")
+         << ' ' << cuts->GetProductionCut("e+") << ' ' << cuts->GetProductionCut("proton");
+    os << '\n';
+  }
+
+  // Composition of the materials
+  const G4MaterialTable * materials = G4Material::GetMaterialTable();
+  for (size_t i=0; i<materials->size(); i++) {
+    const G4Material * material = (*materials)[i];
+    os << "Material " << material->GetName() << ' ' << material->GetDensity()
+       << ' ' << material->GetState() << ' ' << material->GetTemperature()
+       << ' ' << material->GetPressure()
+       << ' ' << material->GetIonisation()->GetMeanExcitationEnergy();
+    const G4double * fractions = material->GetFractionVector();
+    for (size_t e=0; e<material->GetNumberOfElements(); e++) {
+      const G4Element * element = material->GetElement(e);
+      os << ' ' << element->GetName() << '/' << element->GetZ()
+         << '/' << element->GetN() << '/' << element->GetA() << '/' << fractions[e];
+    }
+    os << '\n';
+  }
+
+  return os.str();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+std::string GatePhysicsTableCache::GetCouplesDescription() const
+{
+  std::ostringstream os;
+  os << std::setprecision(17);
+  const G4ProductionCutsTable * table = G4ProductionCutsTable::GetProductionCutsTable();
+  for (size_t i=0; i<table->GetTableSize(); i++) {
+    const G4MaterialCutsCouple * couple = table->GetMaterialCutsCouple(i);
+    const G4ProductionCuts * cuts = couple->GetProductionCuts();
+    os << "Couple " << couple->GetIndex() << ' ' << couple->GetMaterial()->GetName()
+       << ' ' << cuts->GetProductionCut("gamma") << ' ' << cuts->GetProductionCut("e-")
+       << ' ' << cuts->GetProductionCut("e+") << ' ' << cuts->GetProductionCut("proton") << '\n';
+  }
+  return os.str();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+unsigned long long GatePhysicsTableCache::Hash(const std::string & description)
+{
+  unsigned long long hash(14695981039346656037ULL);
+  for (size_t i=0; i<description.size(); i++) {
+    hash ^= (unsigned char)description[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4String GatePhysicsTableCache::GetFileName(const G4String & prefix, unsigned long long hash,
+                                            const G4String & suffix) const
+{
+  std::ostringstream name;
+  name << mDirectory << "/" << prefix << "_" << std::hex << std::setw(16) << std::setfill('0') << hash << suffix;
+  return name.str();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+G4String GatePhysicsTableCache::GetTemporaryName(const G4String & name) const
+{
+  std::ostringstream tmpName;
+  tmpName << name << ".tmp" << getpid() << "_" << G4Threading::G4GetThreadId();
+  return tmpName.str();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GatePhysicsTableCache::Commit(const G4String & tmpName, const G4String & name) const
+{
+  if (std::rename(tmpName.c_str(), name.c_str()) != 0) {
+    std::remove(tmpName.c_str());
+    return false;
+  }
+  return true;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhysicsTableCache::BeginRunInitialization(G4VUserPhysicsList * physicsList)
+{
+  mAreTablesRetrieved = false;
+  mTableDirectory = "";
+  if (!IsEnabled() || !physicsList) return;
+
+  mTableDescription = GetPhysicsDescription();
+  mTableDirectory = GetFileName("g4tables", Hash(mTableDescription));
+  if (IsTableDirectoryValid(mTableDirectory, mTableDescription)) {
+    GateMessage("Physic", 1, "Retrieving the physics tables from " << mTableDirectory << Gateendl);
+    physicsList->SetPhysicsTableRetrieved(mTableDirectory);
+    mAreTablesRetrieved = true;
+  }
+  else physicsList->ResetPhysicsTableRetrieved();
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhysicsTableCache::EndRunInitialization(G4VUserPhysicsList * physicsList)
+{
+  if (mTableDirectory == "" || !physicsList) return;
+  const G4String dir = mTableDirectory;
+  mTableDirectory = "";
+
+  // The tables rebuilt at a next initialisation (new geometry) must not
+  // be read from this directory
+  if (mAreTablesRetrieved) {
+    physicsList->ResetPhysicsTableRetrieved();
+    return;
+  }
+  // Already stored by a concurrent job
+  if (!IsStoringEnabled() || IsTableDirectoryValid(dir, mTableDescription)) return;
+
+  // The description is written last: a directory without it is incomplete
+  const G4String tmpDir = GetTemporaryName(dir);
+  bool ok = (mkdir(tmpDir.c_str(), 0755) == 0 && physicsList->StorePhysicsTable(tmpDir));
+  if (ok) {
+    std::ofstream os((tmpDir + "/description.txt").c_str());
+    os << mTableDescription;
+    os.close();
+    ok = !os.fail() && std::rename(tmpDir.c_str(), dir.c_str()) == 0;
+  }
+  if (!ok) {
+    GateWarning("Cannot store the physics tables in " << dir);
+    RemoveDirectory(tmpDir);
+    return;
+  }
+  GateMessage("Physic", 1, "Physics tables stored in " << dir << Gateendl);
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+bool GatePhysicsTableCache::IsTableDirectoryValid(const G4String & dir, const std::string & description) const
+{
+  std::ifstream is((dir + "/description.txt").c_str());
+  if (!is) return false;
+  std::ostringstream content;
+  content << is.rdbuf();
+  return content.str() == description;
+}
+//-----------------------------------------------------------------------------
+
+
+//-----------------------------------------------------------------------------
+void GatePhysicsTableCache::RemoveDirectory(const G4String & dir) const
+{
+  DIR * d = opendir(dir.c_str());
+  if (!d) return;
+  struct dirent * entry;
+  while ((entry = readdir(d)) != 0) {
+    const std::string name(entry->d_name);
+    if (name == "." || name == "..") continue;
+    std::remove((dir + "/" + name).c_str());
+  }
+  closedir(d);
+  rmdir(dir.c_str());
+}
+//-----------------------------------------------------------------------------
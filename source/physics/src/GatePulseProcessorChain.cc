@@ -17,6 +17,7 @@ See LICENSE.md for further details
 #include "GateTools.hh"
 #include "GateHitConvertor.hh"
 #include "GateSingleDigiMaker.hh"
+#include "GateProfiler.hh"
 
 
 
@@ -89,10 +90,17 @@ GatePulseList* GatePulseProcessorChain::ProcessPulseList()
   if (pulseList->empty())
     return 0;
 
+  const bool profiling = GateProfiler::IsEnabled();
+  if (profiling && m_profilerSections.size() != GetProcessorNumber())
+    CreateProfilerSections();
+
   // Sequentially launch all pulse processors
   for (size_t processorID = 0 ; processorID < GetProcessorNumber(); processorID++) 
     if (GetProcessor(processorID)->IsEnabled()) {
-      pulseList = GetProcessor(processorID)->ProcessPulseList(pulseList);
+      {
+        GateProfilerScope scope(profiling ? m_profilerSections[processorID] : -1);
+        pulseList = GetProcessor(processorID)->ProcessPulseList(pulseList);
+      }
       if (pulseList) GateDigitizer::GetInstance()->StorePulseList(pulseList);
       else break;
     }
@@ -102,3 +110,13 @@ GatePulseList* GatePulseProcessorChain::ProcessPulseList()
 }
 
 
+
+
+void GatePulseProcessorChain::CreateProfilerSections()
+{
+  m_profilerSections.clear();
+  for (size_t i=0; i<GetProcessorNumber(); i++)
+    m_profilerSections.push_back(GateProfiler::GetSection("Digitizer", GetProcessor(i)->GetObjectName()));
+}
+
+
@@ -19,6 +19,7 @@
 #include "G4Positron.hh"
 #include "G4Neutron.hh"
 #include "G4Proton.hh"
+#include "G4IonTable.hh"
 #include "GateVVolume.hh"
 #include "G4RotationMatrix.hh"
 #include "G4ThreeVector.hh"
@@ -64,6 +65,8 @@ GateSourcePhaseSpace::GateSourcePhaseSpace(G4String name ):GateVSource( name )
   pIAEARecordType = 0;
   pIAEAheader = 0;
 
+  pBinaryReader = 0;
+  mUseRandomBlockOrder = false;
 
   pParticleDefinition = 0;
   pParticle = 0;
@@ -79,6 +82,7 @@ GateSourcePhaseSpace::GateSourcePhaseSpace(G4String name ):GateVSource( name )
   t= -1.;
   weight = 1.;
   strcpy(particleName, "");
+  strcpy(mLastParticleName, "");
 
   mTotalSimuTime = 0.;
   mAlreadyLoad = false;
@@ -101,6 +105,7 @@ GateSourcePhaseSpace::~GateSourcePhaseSpace()
   free(pIAEARecordType);
   pIAEAheader = 0;
   pIAEARecordType = 0;
+  delete pBinaryReader;
 }
 // ----------------------------------------------------------------------------------
 
@@ -176,6 +181,18 @@ void GateSourcePhaseSpace::Initialize()
     if (mRmax>0) mTotalNumberOfParticles = pListOfSelectedEvents.size();
   }
 
+  if (mFileType == "binaryFile"){
+    pBinaryReader = new GatePhaseSpaceBinaryReader;
+    for(unsigned int i=0;i<listOfPhaseSpaceFile.size();i++) {
+      GateMessage("Beam", 1, "Phase Space Source. Read file " << listOfPhaseSpaceFile[i] << Gateendl);
+      pBinaryReader->AddFile(listOfPhaseSpaceFile[i]);
+    }
+    pBinaryReader->SetShuffleBlocks(mUseRandomBlockOrder);
+    mTotalNumberOfParticles = pBinaryReader->SetSquareSelection(mRmax);
+    mNumberOfParticlesInFile = mTotalNumberOfParticles;
+    if (mTotalNumberOfParticles == 0) GateError("No particle selected in the phase space files.");
+  }
+
   mInitialized  = true;
 
   if (mUseNbOfParticleAsIntensity)
@@ -193,14 +210,18 @@ void GateSourcePhaseSpace::GenerateROOTVertex( G4Event* /*aEvent*/ )
   if (pListOfSelectedEvents.size()) T->GetEntry(pListOfSelectedEvents[mCurrentParticleNumberInFile]);
   else T->GetEntry(mCurrentParticleNumberInFile);
 
-  G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
-  pParticleDefinition = particleTable->FindParticle(particleName);
+  // The particle table lookup is done only when the name changes
+  if (pParticleDefinition==0 || strcmp(particleName, mLastParticleName) != 0) {
+    G4ParticleTable* particleTable = G4ParticleTable::GetParticleTable();
+    pParticleDefinition = particleTable->FindParticle(particleName);
 
-  if (pParticleDefinition==0) {
-    if (mParticleTypeNameGivenByUser != "none") {
-      pParticleDefinition = particleTable->FindParticle(mParticleTypeNameGivenByUser);
+    if (pParticleDefinition==0) {
+      if (mParticleTypeNameGivenByUser != "none") {
+        pParticleDefinition = particleTable->FindParticle(mParticleTypeNameGivenByUser);
+      }
+      if (pParticleDefinition==0) GateError("No particle type defined in phase space file.");
     }
-    if (pParticleDefinition==0) GateError("No particle type defined in phase space file.");
+    strcpy(mLastParticleName, particleName);
   }
 
   mParticlePosition = G4ThreeVector(x*mm,y*mm,z*mm);
@@ -276,6 +297,57 @@ void GateSourcePhaseSpace::GenerateIAEAVertex( G4Event* /*aEvent*/ )
 // ----------------------------------------------------------------------------------
 
 
+// ----------------------------------------------------------------------------------
+void GateSourcePhaseSpace::GenerateBinaryVertex( G4Event* /*aEvent*/ )
+{
+  const GatePhaseSpaceBinaryRecord & r = pBinaryReader->Next();
+
+  pParticleDefinition = GetParticleDefinitionByPDG(r.pdgCode);
+
+  mParticlePosition = G4ThreeVector(r.x*mm,r.y*mm,r.z*mm);
+
+  double mass =  pParticleDefinition->GetPDGMass();
+  double dtot = std::sqrt(r.dx*r.dx + r.dy*r.dy + r.dz*r.dz);
+
+  if (r.energy<=0) GateError("Energy <= 0 in phase space file!");
+  mMomentum = std::sqrt(r.energy*r.energy+2*r.energy*mass);
+
+  if (dtot==0) GateError("No momentum defined in phase space file!");
+
+  px = mMomentum*r.dx/dtot ;
+  py = mMomentum*r.dy/dtot ;
+  pz = mMomentum*r.dz/dtot ;
+
+  mParticleMomentum = G4ThreeVector(px,py,pz);
+
+  weight = r.weight;
+  if (r.time>0) mParticleTime = r.time;
+}
+// ----------------------------------------------------------------------------------
+
+
+// ----------------------------------------------------------------------------------
+G4ParticleDefinition * GateSourcePhaseSpace::GetParticleDefinitionByPDG(G4int pdg)
+{
+  std::map<G4int, G4ParticleDefinition*>::const_iterator it = mParticleDefinitionsByPDG.find(pdg);
+  if (it != mParticleDefinitionsByPDG.end()) return it->second;
+
+  G4ParticleDefinition * p = 0;
+  if (pdg != 0) {
+    p = G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+    // Ions are created on demand, they are not in the table yet
+    if (p==0 && pdg > 1000000000) p = G4IonTable::GetIonTable()->GetIon(pdg);
+  }
+  if (p==0 && mParticleTypeNameGivenByUser != "none")
+    p = G4ParticleTable::GetParticleTable()->FindParticle(mParticleTypeNameGivenByUser);
+  if (p==0) GateError("Unknown particle (PDG code " << pdg << ") in phase space file.");
+
+  mParticleDefinitionsByPDG[pdg] = p;
+  return p;
+}
+// ----------------------------------------------------------------------------------
+
+
 // ----------------------------------------------------------------------------------
 G4int GateSourcePhaseSpace::GeneratePrimaries( G4Event* event )
 {
@@ -304,6 +376,8 @@ G4int GateSourcePhaseSpace::GeneratePrimaries( G4Event* event )
     }
     mLoop = int(mRequestedNumberOfParticlesPerRun/mTotalNumberOfParticles)  ;
 
+    if (mFileType == "binaryFile") pBinaryReader->Start(mStartingParticleId);
+
     mAngle = twopi/(mLoop);
   }//Calculate the number of time each particle in phase space will be used
 
@@ -316,6 +390,11 @@ G4int GateSourcePhaseSpace::GeneratePrimaries( G4Event* event )
       GenerateROOTVertex( event );
       mCurrentParticleNumberInFile++;
     }
+    if (mFileType == "binaryFile") {
+      // the reader loops over the files by itself
+      GenerateBinaryVertex( event );
+      mCurrentParticleNumberInFile++;
+    }
     if (mFileType == "IAEAFile"){
       if (mCurrentParticleNumberInFile>=mNumberOfParticlesInFile || mCurrentParticleNumberInFile == -1){
         mCurrentParticleNumberInFile=0;
@@ -422,14 +501,16 @@ void GateSourcePhaseSpace::AddFile(G4String file)
   if (listOfPhaseSpaceFile.size()==0){
     if (extension == "root") mFileType = "rootFile";
     else if (extension == "IAEAphsp" || extension == "IAEAheader" ) mFileType = "IAEAFile";
+    else if (extension == "gphsp") mFileType = "binaryFile";
     else GateError( "Unknow phase space file extension. Knowns extensions are : "
-                    << Gateendl << ".IAEAphsp (or IAEAheader), .root\n");
+                    << Gateendl << ".IAEAphsp (or IAEAheader), .root, .gphsp\n");
     listOfPhaseSpaceFile.push_back(file);
     return;
   }
 
   if (extension == "root" && mFileType == "rootFile") listOfPhaseSpaceFile.push_back(file);
   else if ((extension == "IAEAphsp" || extension == "IAEAheader") && mFileType == "IAEAFile") listOfPhaseSpaceFile.push_back(file);
+  else if (extension == "gphsp" && mFileType == "binaryFile") listOfPhaseSpaceFile.push_back(file);
   else GateError( "Cannot add phase space files with different extension");
 
 }
@@ -65,6 +65,10 @@ GateSourcePhaseSpaceMessenger::GateSourcePhaseSpaceMessenger(GateSourcePhaseSpac
   setStartIdCmd = new G4UIcmdWithAnInteger(cmdName,this);
   setStartIdCmd->SetGuidance("set the id of the particle to start with");
 
+  cmdName = GetDirectoryName()+"useRandomBlockOrder";
+  setRandomBlockOrderCmd = new G4UIcmdWithABool(cmdName,this);
+  setRandomBlockOrderCmd->SetGuidance("Read the blocks of a binary (.gphsp) phase space in a random order, reshuffled at each pass");
+
 }
 //----------------------------------------------------------------------------------------
 
@@ -80,6 +84,7 @@ GateSourcePhaseSpaceMessenger::~GateSourcePhaseSpaceMessenger()
   delete setUseNbParticleAsIntensityCmd;
   delete setRmaxCmd;
   delete setStartIdCmd;
+  delete setRandomBlockOrderCmd;
 }
 //----------------------------------------------------------------------------------------
 
@@ -97,6 +102,8 @@ void GateSourcePhaseSpaceMessenger::SetNewValue(G4UIcommand* command, G4String n
     pSource->SetUseNbOfParticleAsIntensity(setUseNbParticleAsIntensityCmd->GetNewBoolValue(newValue));
   if (command == setRmaxCmd) pSource->SetRmax(setRmaxCmd->GetNewDoubleValue(newValue));
   if (command == setStartIdCmd) pSource->SetStartingParticleId(setStartIdCmd->GetNewIntValue(newValue));
+  if (command == setRandomBlockOrderCmd)
+    pSource->SetUseRandomBlockOrder(setRandomBlockOrderCmd->GetNewBoolValue(newValue));
 }
 //----------------------------------------------------------------------------------------
 
@@ -259,13 +259,9 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
       }
     }
     mDistriGeneral = new RandGeneral(engine, mPDF, mTotalNumberOfSpots, 0);
+    ComputeSpotOptics();
     if (mSortedSpotGenerationFlag){
-      mNbIonsToGenerate.resize(mTotalNumberOfSpots,0);
-      long int ntotal = GateApplicationMgr::GetInstance()->GetTotalNumberOfPrimaries();
-      for (long int i = 0; i<ntotal; i++){
-        int bin = mTotalNumberOfSpots * mDistriGeneral->fire();
-        ++mNbIonsToGenerate[bin];
-      }
+      AllocateSortedSpotPrimaries(engine, GateApplicationMgr::GetInstance()->GetTotalNumberOfPrimaries());
       for (int i = 0; i < mTotalNumberOfSpots; i++) {
         GateMessage("Beam", 3, "[TPSPencilBeam] bin " << std::setw(5) << i << ": spotweight=" << std::setw(8) << mPDF[i] << ", Ngen=" << mNbIonsToGenerate[i] << Gateendl );
       }
@@ -320,9 +316,56 @@ void GateSourceTPSPencilBeam::GenerateVertex( G4Event *aEvent ) {
 }
 //---------GENERATION - END-----------------------
 
+//------------------------------------------------------------------------------------------------------
+// Number of primaries of each spot for the sorted generation: exact
+// multinomial sampling by conditional binomial splitting, the number of
+// primaries of spot i is drawn among those not given to spots 0..i-1,
+// with the probability of spot i relative to the remaining weight.
+void GateSourceTPSPencilBeam::AllocateSortedSpotPrimaries(CLHEP::HepRandomEngine * engine, long int ntotal) {
+  mNbIonsToGenerate.assign(mTotalNumberOfSpots,0);
+  double remainingWeight = 0.;
+  for (int i = 0; i < mTotalNumberOfSpots; i++) remainingWeight += mPDF[i];
+  long int remaining = ntotal;
+  for (int i = 0; i < mTotalNumberOfSpots && remaining > 0; i++) {
+    double p = (remainingWeight > 0.) ? mPDF[i]/remainingWeight : 0.;
+    if ((i == mTotalNumberOfSpots-1) || (p >= 1.)) {
+      mNbIonsToGenerate[i] = remaining;
+    } else if (p > 0.) {
+      mNbIonsToGenerate[i] = std::min(remaining, (long int)CLHEP::RandBinomial::shoot(engine, remaining, p));
+    }
+    remaining -= mNbIonsToGenerate[i];
+    remainingWeight -= mPDF[i];
+  }
+}
+//------------------------------------------------------------------------------------------------------
+void GateSourceTPSPencilBeam::ComputeSpotOptics() {
+  mSpotOptics.resize(mTotalNumberOfSpots);
+  for (int i = 0; i < mTotalNumberOfSpots; i++) {
+    double energy = mSpotEnergy[i];
+    // spots of the same layer share the same energy
+    if (i > 0 && energy == mSpotEnergy[i-1]) {
+      mSpotOptics[i] = mSpotOptics[i-1];
+      continue;
+    }
+    SpotOptics & optics = mSpotOptics[i];
+    optics.energy = GetEnergy(energy);
+    if ( mSigmaEnergyInMeVFlag ){
+      optics.sigmaEnergy = GetSigmaEnergy(energy);
+    } else {
+      optics.sigmaEnergy = GetSigmaEnergy(energy)*optics.energy/100.;
+    }
+    optics.sigmaX = GetSigmaX(energy);
+    optics.sigmaY = GetSigmaY(energy);
+    optics.sigmaTheta = GetSigmaTheta(energy);
+    optics.sigmaPhi = GetSigmaPhi(energy);
+    optics.ellipseXThetaArea = GetEllipseXThetaArea(energy);
+    optics.ellipseYPhiArea = GetEllipseYPhiArea(energy);
+  }
+}
 //------------------------------------------------------------------------------------------------------
 void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
   double energy = mSpotEnergy[mCurrentSpot];
+  const SpotOptics & optics = mSpotOptics[mCurrentSpot];
     //Particle Type
     mPencilBeam->SetParticleType(mParticleType);
   if (mIsGenericIon==true){
@@ -330,15 +373,8 @@ void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
     mPencilBeam->SetIonParameter(mParticleParameters);
   }
   //Energy
-  mPencilBeam->SetEnergy(GetEnergy(energy));
-  if ( mSigmaEnergyInMeVFlag ){
-    mPencilBeam->SetEnergy(GetEnergy(energy));
-    mPencilBeam->SetSigmaEnergy(GetSigmaEnergy(energy));
-  } else {
-    double source_energy = GetEnergy(energy);
-    mPencilBeam->SetEnergy(source_energy);
-    mPencilBeam->SetSigmaEnergy(GetSigmaEnergy(energy)*source_energy/100.);
-  }
+  mPencilBeam->SetEnergy(optics.energy);
+  mPencilBeam->SetSigmaEnergy(optics.sigmaEnergy);
   //Weight
   if (mFlatGenerationFlag) {
     mPencilBeam->SetWeight(mSpotWeight[mCurrentSpot]);
@@ -347,13 +383,13 @@ void GateSourceTPSPencilBeam::ConfigurePencilBeam() {
   }
   //Position
   mPencilBeam->SetPosition(mSpotPosition[mCurrentSpot]);
-  mPencilBeam->SetSigmaX(GetSigmaX(energy));
-  mPencilBeam->SetSigmaY(GetSigmaY(energy));
+  mPencilBeam->SetSigmaX(optics.sigmaX);
+  mPencilBeam->SetSigmaY(optics.sigmaY);
   //Direction
-  mPencilBeam->SetSigmaTheta(GetSigmaTheta(energy));
-  mPencilBeam->SetEllipseXThetaArea(GetEllipseXThetaArea(energy));
-  mPencilBeam->SetSigmaPhi(GetSigmaPhi(energy));
-  mPencilBeam->SetEllipseYPhiArea(GetEllipseYPhiArea(energy));
+  mPencilBeam->SetSigmaTheta(optics.sigmaTheta);
+  mPencilBeam->SetEllipseXThetaArea(optics.ellipseXThetaArea);
+  mPencilBeam->SetSigmaPhi(optics.sigmaPhi);
+  mPencilBeam->SetEllipseYPhiArea(optics.ellipseYPhiArea);
   mPencilBeam->SetRotation(mSpotRotation[mCurrentSpot]);
   //Correlation Position/Direction
   //this parameter is not spot or energy dependent and is therefore once for all at the end of the initialization phase.
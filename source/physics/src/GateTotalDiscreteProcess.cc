@@ -17,6 +17,9 @@ See LICENSE.md for further details
 #include "GatePETVRTManager.hh"
 #include "GatePETVRTSettings.hh"
 #include "GateMessageManager.hh"
+#include "GatePhysicsTableCache.hh"
+#include <sstream>
+#include <iomanip>
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
@@ -108,13 +111,26 @@ void 	GateTotalDiscreteProcess::BuildPhysicsTable ( const G4ParticleDefinition &
 
 void GateTotalDiscreteProcess::BuildCrossSectionsTables()
 {
-	// build tables for single processes
+	// the single processes sample the interactions, their tables are always built
 	for ( G4int i=0;i<m_nNumProcesses;i++ )
 	{
 		m_oProcessVec[i]->PreparePhysicsTable ( *pParticleType );
 		m_oProcessVec[i]->BuildPhysicsTable ( *pParticleType );
 		m_oCrossSectionsTableVec[i]=new GateCrossSectionsTable ( m_nTotalMinEnergy,m_nTotalMaxEnergy,m_nTotalBinNumber,pParticleType,*m_oProcessVec[i] );
+	}
+	m_pTotalCrossSectionsTable=new GateCrossSectionsTable ( m_nTotalMinEnergy,m_nTotalMaxEnergy,m_nTotalBinNumber,pParticleType,m_oProcessVec);
 
+	GatePhysicsTableCache* cache=GatePhysicsTableCache::GetInstance();
+	unsigned long long hash=0;
+	if ( cache->IsEnabled() )
+	{
+		hash=GetCrossSectionsCacheHash();
+		if ( RetrieveCrossSectionsTables ( hash ) ) return;
+	}
+
+	// build fast linear tables for single processes
+	for ( G4int i=0;i<m_nNumProcesses;i++ )
+	{
 #ifdef G4VERBOSE
 		G4cout << "***************\n";
 		G4cout << "GATE SUBPROCESS " << *m_oProcessNameVec[i] <<" : Building fast linear tables for "<< pParticleType->GetParticleName() << " in the energy range [" << m_nTotalMinEnergy/keV << "," << m_nTotalMaxEnergy/keV << "] keV in " << m_nTotalBinNumber << " " << ( m_nTotalMaxEnergy-m_nTotalMinEnergy ) /m_nTotalBinNumber/keV << " keV bins\n";
@@ -125,13 +141,79 @@ void GateTotalDiscreteProcess::BuildCrossSectionsTables()
 	}
 
 	// build tables for total cross section
-	m_pTotalCrossSectionsTable=new GateCrossSectionsTable ( m_nTotalMinEnergy,m_nTotalMaxEnergy,m_nTotalBinNumber,pParticleType,m_oProcessVec);
 #ifdef G4VERBOSE
 	G4cout << "*****************\n";
 	G4cout << "GATE TOTALPROCESS " << GetProcessName() <<" : Building fast linear tables for "<< pParticleType->GetParticleName() << " in the energy range [" << m_nTotalMinEnergy/keV << "," << m_nTotalMaxEnergy/keV << "] keV in " << m_nTotalBinNumber << " " << ( m_nTotalMaxEnergy-m_nTotalMinEnergy ) /m_nTotalBinNumber/keV << " keV bins\n";
 	G4cout << "*****************\n";
 #endif
 	m_pTotalCrossSectionsTable->SetAndBuildProductionMaterialTable();
+
+	if ( cache->IsStoringEnabled() ) StoreCrossSectionsTables ( hash );
+}
+
+unsigned long long GateTotalDiscreteProcess::GetCrossSectionsCacheHash() const
+{
+	const GatePhysicsTableCache* cache=GatePhysicsTableCache::GetInstance();
+	std::ostringstream description;
+	description << std::setprecision ( 17 )
+	            << cache->GetPhysicsDescription() << cache->GetCouplesDescription()
+	            << GetProcessName() << " " << m_nTotalMinEnergy << " " << m_nTotalMaxEnergy << " " << m_nTotalBinNumber;
+	for ( G4int i=0;i<m_nNumProcesses;i++ )
+		description << " " << *m_oProcessNameVec[i];
+	description << "\n";
+	return GatePhysicsTableCache::Hash ( description.str() );
+}
+
+bool GateTotalDiscreteProcess::RetrieveCrossSectionsTables ( unsigned long long hash )
+{
+	const G4String fileName=GatePhysicsTableCache::GetInstance()->GetFileName ( "fictitious",hash,".bin" );
+	std::ifstream in ( fileName.c_str(),std::ios::in|std::ios::binary );
+	if ( !in ) return false;
+
+	unsigned long long fileHash=0;
+	in.read ( reinterpret_cast<char*> ( &fileHash ),sizeof ( fileHash ) );
+	bool ok= ( in && fileHash==hash );
+	for ( G4int i=0;i<m_nNumProcesses && ok;i++ )
+		ok=m_oCrossSectionsTableVec[i]->RetrieveProductionMaterialTable ( in );
+	if ( ok ) ok=m_pTotalCrossSectionsTable->RetrieveProductionMaterialTable ( in );
+	if ( !ok )
+	{
+		GateWarning ( "Cross-section table cache " << fileName << " does not match the materials. Ignored." );
+		// the tables are rebuilt from scratch
+		for ( G4int i=0;i<m_nNumProcesses;i++ )
+		{
+			delete m_oCrossSectionsTableVec[i];
+			m_oCrossSectionsTableVec[i]=new GateCrossSectionsTable ( m_nTotalMinEnergy,m_nTotalMaxEnergy,m_nTotalBinNumber,pParticleType,*m_oProcessVec[i] );
+		}
+		delete m_pTotalCrossSectionsTable;
+		m_pTotalCrossSectionsTable=new GateCrossSectionsTable ( m_nTotalMinEnergy,m_nTotalMaxEnergy,m_nTotalBinNumber,pParticleType,m_oProcessVec);
+		return false;
+	}
+	GateMessage ( "Physic",1,"Fictitious cross-section tables read from " << fileName << Gateendl );
+	return true;
+}
+
+void GateTotalDiscreteProcess::StoreCrossSectionsTables ( unsigned long long hash ) const
+{
+	const GatePhysicsTableCache* cache=GatePhysicsTableCache::GetInstance();
+	const G4String fileName=cache->GetFileName ( "fictitious",hash,".bin" );
+	const G4String tmpName=cache->GetTemporaryName ( fileName );
+	std::ofstream out ( tmpName.c_str(),std::ios::out|std::ios::binary );
+	if ( !out )
+	{
+		GateWarning ( "Cannot write the cross-section table cache in " << cache->GetDirectory() );
+		return;
+	}
+	out.write ( reinterpret_cast<const char*> ( &hash ),sizeof ( hash ) );
+	for ( G4int i=0;i<m_nNumProcesses;i++ )
+		m_oCrossSectionsTableVec[i]->StoreTable ( out,false );
+	m_pTotalCrossSectionsTable->StoreTable ( out,false );
+	out.close();
+
+	if ( !out || !cache->Commit ( tmpName,fileName ) )
+		GateWarning ( "Cannot write the cross-section table cache " << fileName );
+	else
+		GateMessage ( "Physic",1,"Fictitious cross-section tables stored in " << fileName << Gateendl );
 }
 
 
@@ -38,9 +38,17 @@ GatePulseList* GateVPulseProcessor::ProcessPulseList(const GatePulseList* inputP
     return 0;
 
   GatePulseList* outputPulseList = new GatePulseList(GetObjectName());
+  // Most processors output at most one pulse per input pulse
+  outputPulseList->reserve(n_pulses);
 
   GatePulseConstIterator iter;
-  for (iter = inputPulseList->begin() ; iter != inputPulseList->end() ; ++iter)
+  if (IsBatchProcessor() && nVerboseLevel<=1) {
+    m_batch.Fill(*inputPulseList);
+    ProcessPulseBatch(m_batch);
+    m_batch.AppendKeptPulses(*outputPulseList);
+  }
+  else
+    for (iter = inputPulseList->begin() ; iter != inputPulseList->end() ; ++iter)
       	ProcessOnePulse( *iter, *outputPulseList);
   
   if (nVerboseLevel==1) {
@@ -35,7 +35,7 @@ GateVSourceVoxelReader::~GateVSourceVoxelReader()
   if (m_voxelTranslator) {
     delete m_voxelTranslator;
   }
-  m_sourceVoxelIntegratedActivities.clear();
+  m_sourceVoxelAliasTable.Clear();
 }
 //-------------------------------------------------------------------------------------------------
 
@@ -84,9 +84,10 @@ G4int GateVSourceVoxelReader::GetNextSource()
     // if there is at least one voxel
 
     // now assign the event to one voxel, according to the relative activity
-    // integral method
-    // from STL doc: iterator upper_bound(const key_type& k)   Sorted Associative Container   Finds the first element whose key greater than k.
-    firstSource = (m_sourceVoxelIntegratedActivities.upper_bound(G4UniformRand() * m_activityTotal))->second;
+    // (alias method: constant time whatever the number of voxels)
+    if (m_sourceVoxelAliasTable.GetSize() == 0)
+      GateError("GateVSourceVoxelReader::GetNextSource : ERROR: all the voxels have a null activity");
+    firstSource = m_sourceActiveVoxels[m_sourceVoxelAliasTable.Sample(G4UniformRand())];
 
   }
 
@@ -147,27 +148,28 @@ void GateVSourceVoxelReader::RemoveTranslator()
 //-------------------------------------------------------------------------------------------------
 void GateVSourceVoxelReader::PrepareIntegratedActivityMap()
 {
-  // erase all the elements of the old integrated activity map
-  m_sourceVoxelIntegratedActivities.clear();
-
-  // create the new integrated activity map
-  m_activityTotal = 0.;
-  GateSourceActivityMap::iterator voxel;
+  // list the voxels with a non-null activity (the storage of the previous
+  // lists and of the alias table is reused when the activities are updated)
+  m_sourceActiveVoxels.clear();
+  m_sourceActiveVoxelActivities.clear();
   for (size_t iVoxel = 0; iVoxel < m_sourceVoxelActivities.size(); iVoxel++) {
 	  if (m_sourceVoxelActivities[iVoxel]>0.0) {
-		  m_activityTotal += m_sourceVoxelActivities[iVoxel];
-		  m_sourceVoxelIntegratedActivities[m_activityTotal] = iVoxel;
+		  m_sourceActiveVoxels.push_back(iVoxel);
+		  m_sourceActiveVoxelActivities.push_back(m_sourceVoxelActivities[iVoxel]);
 	  }
   }
 
+  // create the new alias table
+  m_sourceVoxelAliasTable.Build(m_sourceActiveVoxelActivities);
+  m_activityTotal = m_sourceVoxelAliasTable.GetTotalWeight();
+
   if (nVerboseLevel>1) {
-	  GateSourceIntegratedActivityMap::iterator intVoxel;
-	  for (intVoxel = m_sourceVoxelIntegratedActivities.begin(); intVoxel != m_sourceVoxelIntegratedActivities.end(); intVoxel++) {
-		  G4int iVoxel = intVoxel->second;
+	  for (size_t i = 0; i < m_sourceActiveVoxels.size(); i++) {
+		  G4int iVoxel = m_sourceActiveVoxels[i];
 		  G4cout << "[GateVSourceVoxelReader::PrepareIntegratedActivityMap] "
 				  << "   voxel: " << GetVoxelIndices(iVoxel)
 				  << "   activity : (Bq) " << m_sourceVoxelActivities[iVoxel] / becquerel
-				  << "   integrated: (Bq) " << ((*intVoxel).first)  / becquerel
+				  << "   probability: " << m_sourceVoxelActivities[iVoxel] / m_activityTotal
 				  << Gateendl;
     }
   }